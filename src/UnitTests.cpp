@@ -1,7 +1,39 @@
 #include <iostream>
 #include "neuron.hpp"
 #include "network.hpp"
+#include "spikeFile.hpp"
+#include "asyncRecorder.hpp"
+#include "outputSink.hpp"
+#include "neuronSet.hpp"
+#include "multimeter.hpp"
+#include "spikeArchive.hpp"
+#include "spikeAnalysis.hpp"
+#include "statisticsRecorder.hpp"
+#include "checkpoint.hpp"
+#include "ensemble.hpp"
+#include "batchNetwork.hpp"
+#include "sweep.hpp"
+#include "stopMonitor.hpp"
+#include "meanField.hpp"
+#include "populationDensity.hpp"
+#include "preciseNetwork.hpp"
+#include "eventNetwork.hpp"
+#include "options.hpp"
+#include "runSummary.hpp"
+#include "neuroproject.h"
+#include "simulationServer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <cstring>
 #include <random>
+#include <system_error>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include "gtest/gtest.h"
 
 
@@ -90,6 +122,29 @@ TEST (NeuronTest, Delay) {
 }
 
 
+TEST (NeuronTest, RefractorySkipped) {
+	
+	Neuron neuron(true);
+	neuron.setPotential(V_thr+1.0);
+	EXPECT_TRUE(neuron.update(0.0, 0));	//Spike at time 0 : refractory until time 20
+	
+	//The signals that arrive during the refractory period are lost, the others are kept
+	neuron.receiveSpike(10, JE);
+	neuron.receiveSpike(20, JE);
+	EXPECT_EQ(0, neuron.getIncomingSpikes()[10%(delay_steps+1)]);
+	EXPECT_EQ(1, neuron.getIncomingSpikes()[20%(delay_steps+1)]);
+	
+	//The neuron does not need to be updated until the end of its refractory period
+	for(unsigned int long time(1); time<20; ++time) {
+		EXPECT_TRUE(neuron.skipRefractory(time));
+	}
+	EXPECT_FALSE(neuron.skipRefractory(20));
+	EXPECT_FALSE(neuron.update(0.0, 0));
+	EXPECT_NEAR(J, neuron.getPotential(), 1e-12);
+	
+}
+
+
 TEST (NeuronTest, SpikeWithTwoNeurons) {
 	
 	Neuron neuron1(true);	//Supposing that neuron1 is excitatory
@@ -226,6 +281,1396 @@ TEST (NetworkTest, InhibitoryConnections) {
 }
 
 
+TEST (NetworkTest, RuntimeSize) {
+	
+	EXPECT_THROW(Network(NetworkSize {0, 20, 10, 5}, 2, 5, 42), std::invalid_argument);
+	EXPECT_THROW(Network(NetworkSize {0, 0, 0, 0}, 2, 5, 42), std::invalid_argument);
+	
+	//An empty population that gives no connections is allowed
+	EXPECT_EQ(0u, Network(NetworkSize {0, 20, 0, 5}, 2, 5, 42).getNbrExcitatory());
+	
+	//Each neuron receives the numbers of connections of the size, and the targets are allocated exactly
+	const NetworkSize size {300, 75, 30, 8};
+	Network network(size, 2, 5, 42);
+	EXPECT_EQ(375u, network.getNbrNeurons());
+	EXPECT_EQ(8u, network.getSize().connections_inhibitory);
+	size_t nbr_targets(0);
+	for(unsigned int long i(0); i<network.getNbrNeurons(); ++i) {
+		EXPECT_EQ(30u, network.ExcitatoryConnectionsTest(i));
+		EXPECT_EQ(8u, network.InhibitoryConnectionsTest(i));
+		EXPECT_EQ(network.getNeuron(i).getTargets().size(), network.getNeuron(i).getTargets().capacity());
+		nbr_targets+=network.getNeuron(i).getTargets().size();
+	}
+	EXPECT_EQ(375u*38, nbr_targets);
+	
+	//The default size gives the connections of the constructor with the numbers of neurons
+	EXPECT_EQ(Network(80, 20, 2, 5, 42).getConnectionsChecksum(),
+			  Network(NetworkSize {80, 20, defaultNetworkSize().connections_excitatory, defaultNetworkSize().connections_inhibitory}, 2, 5, 42).getConnectionsChecksum());
+	
+}
+
+
+TEST (NetworkTest, RefractorySkip) {
+	
+	//The refractory neurons updated like the others give the same spikes as the skipped ones
+	Network skipping(NetworkSize {400, 100, 40, 10}, 2, 5/JE, 42);
+	Network updating(NetworkSize {400, 100, 40, 10}, 2, 5/JE, 42);
+	updating.setRefractorySkip(false);
+	unsigned int long nbr_spikes(0);
+	for(unsigned int long step(0); step<2000; ++step) {
+		skipping.update(0.0);
+		updating.update(0.0);
+		ASSERT_EQ(skipping.getSpikes(), updating.getSpikes());
+		nbr_spikes+=skipping.getSpikes().size();
+	}
+	EXPECT_GT(nbr_spikes, 0u);
+	
+}
+
+
+//Files written by a test in the current directory, removed at the end of the test even if an assertion fails
+class TestFiles {
+	
+	public :
+	
+	TestFiles(std::initializer_list<std::string> names_) : names(names_) {
+		removeAll();
+	}
+	
+	~TestFiles() {
+		removeAll();
+	}
+	
+	private :
+	
+	void removeAll() const {
+		for(const auto& name : names) {
+			std::remove(name.c_str());
+		}
+	}
+	
+	std::vector<std::string> names;
+	
+};
+
+
+TEST (OptionsTest, FileAndCommandLine) {
+	
+	const TestFiles files({"options_test.cfg"});
+	
+	{
+		std::ofstream file("options_test.cfg");
+		file<<"# size of the network\n"<<"excitatory = 800\n\n"<<"inhibitory=200\n"<<"eta = 2.5\n";
+	}
+	const char* arguments[]={"program", "--config", "options_test.cfg", "--inhibitory", "250"};
+	Options options({"excitatory", "inhibitory", "eta", "g"});
+	options.parse(5, const_cast<char**>(arguments));
+	EXPECT_EQ(800u, options.getInteger("excitatory", 0));
+	EXPECT_EQ(250u, options.getInteger("inhibitory", 0));	//The command line replaces the file
+	EXPECT_EQ(2.5, options.getDouble("eta", 0.0));
+	EXPECT_EQ(5.0, options.getDouble("g", 5.0));
+	EXPECT_FALSE(options.has("g"));
+	
+	EXPECT_THROW(options.set("exitatory", "800"), std::invalid_argument);
+	options.set("excitatory", "-800");
+	EXPECT_THROW(options.getInteger("excitatory", 0), std::invalid_argument);
+	options.set("eta", "2.5ms");
+	EXPECT_THROW(options.getDouble("eta", 0.0), std::invalid_argument);
+	
+	//A seed larger than an unsigned int is refused instead of being cut
+	options.set("excitatory", "4294967295");
+	EXPECT_EQ(4294967295u, options.getSeed("excitatory", 0));
+	options.set("excitatory", "4294967296");
+	EXPECT_THROW(options.getSeed("excitatory", 0), std::invalid_argument);
+	const char* missing[]={"program", "--g"};
+	EXPECT_THROW(options.parse(2, const_cast<char**>(missing)), std::invalid_argument);
+	
+}
+
+
+TEST (RunSummaryTest, BatchRun) {
+	
+	const TestFiles files({"summary_test.json"});
+	
+	//The parameters of a batch run are verified before the network is created
+	EXPECT_THROW(Simulation(-1.0, 5.0, 2.0), std::invalid_argument);
+	EXPECT_THROW(Simulation(100.0, 5.0, 0.0), std::invalid_argument);
+	
+	//Without a terminal, an answer that is not a number is an error instead of an assert
+	std::istringstream answers("abc");
+	std::streambuf* input(std::cin.rdbuf(answers.rdbuf()));
+	EXPECT_THROW(Simulation(), std::invalid_argument);
+	std::cin.rdbuf(input);
+	
+	Simulation simulation(20.0, 5.0, 0.5);
+	simulation.setNetworkSize(NetworkSize {400, 100, 40, 10});
+	simulation.setSeed(3);
+	StatisticsRecorder statistics_recorder;
+	simulation.addRecorder(&statistics_recorder);
+	simulation.run();
+	const RunSummary summary {true, "", 20.0, 5.0, 0.5, simulation.getNetworkSeed(), NetworkSize {400, 100, 40, 10},
+							  simulation.getConstructionTime(), simulation.getRunTime(), 0.0, simulation.getClock(),
+							  stopReasonName(simulation.getStopReason()), statistics_recorder.getStatistics(), 0};
+	EXPECT_EQ(3u, summary.seed);
+	EXPECT_EQ(200u, summary.steps);
+	EXPECT_GE(summary.run_time, 0.0);
+	writeRunSummary("summary_test.json", summary);
+	
+	std::ifstream file("summary_test.json");
+	std::stringstream content;
+	content<<file.rdbuf();
+	EXPECT_NE(std::string::npos, content.str().find("\"status\": \"done\""));
+	EXPECT_NE(std::string::npos, content.str().find("\"seed\": 3,"));
+	EXPECT_NE(std::string::npos, content.str().find("\"steps\": 200,"));
+	
+	//A failed run has an error and no statistics, written as null
+	const RunSummary failed {false, "g must be a strictly positive number", 20.0, 0.0, 0.5, 0, defaultNetworkSize(), 0.0, 0.0, 0.0, 0,
+							 "none", NetworkStatistics {NAN, NAN, 0, NAN, NAN, 0, ""}, 0};
+	writeRunSummary("summary_test.json", failed);
+	std::ifstream failed_file("summary_test.json");
+	std::stringstream failed_content;
+	failed_content<<failed_file.rdbuf();
+	EXPECT_NE(std::string::npos, failed_content.str().find("\"status\": \"failed\""));
+	EXPECT_NE(std::string::npos, failed_content.str().find("\"error\": \"g must be a strictly positive number\""));
+	EXPECT_NE(std::string::npos, failed_content.str().find("\"cv\": null"));
+	
+}
+
+
+namespace {
+
+//Callback of the C interface that keeps the spikes of each step
+void keepSpikes(void* user_data, unsigned long, const unsigned long* neurons, size_t count) {
+	static_cast<std::vector<std::vector<unsigned long>>*>(user_data)->emplace_back(neurons, neurons+count);
+}
+
+}
+
+
+TEST (NeuroprojectTest, CInterface) {
+	
+	EXPECT_EQ(NP_API_VERSION, np_api_version());
+	np_network* handle(np_create());
+	ASSERT_NE(nullptr, handle);
+	EXPECT_EQ(NP_INVALID_ARGUMENT, np_set_size(handle, 0, 0, 0, 0));
+	EXPECT_NE(std::string(""), np_last_error(handle));
+	EXPECT_EQ(NP_INVALID_ARGUMENT, np_set_parameters(handle, 5.0, -2.0));
+	ASSERT_EQ(NP_OK, np_set_size(handle, 400, 100, 40, 10));
+	ASSERT_EQ(NP_OK, np_set_parameters(handle, 5.0, 2.0));
+	ASSERT_EQ(NP_OK, np_set_seed(handle, 7));
+	
+	//The library gives the spikes of the network created with the same seed, step by step
+	std::vector<std::vector<unsigned long>> spikes;
+	ASSERT_EQ(NP_OK, np_run(handle, 200, keepSpikes, &spikes));
+	EXPECT_EQ(200u, np_clock(handle));
+	Network network(NetworkSize {400, 100, 40, 10}, 2.0, 5.0/JE, 7);
+	unsigned long excitatory_spikes(0);
+	for(const auto& step : spikes) {
+		network.update(0.0);
+		EXPECT_EQ(network.getSpikes(), std::vector<unsigned int long>(step.begin(), step.end()));
+		excitatory_spikes+=std::count_if(step.begin(), step.end(), [](unsigned long neuron) { return neuron<400; });
+	}
+	
+	//The rates and the spikes of the last step are read without copy
+	const double* excitatory(nullptr);
+	const double* inhibitory(nullptr);
+	size_t nbr_steps(0);
+	ASSERT_EQ(NP_OK, np_rates(handle, &excitatory, &inhibitory, &nbr_steps));
+	ASSERT_EQ(200u, nbr_steps);
+	double sum(0.0);
+	for(size_t i(0); i<nbr_steps; ++i) {
+		sum+=excitatory[i];
+	}
+	EXPECT_NEAR(excitatory_spikes*1000.0/(400*h), sum, 1e-6);
+	const unsigned long* last(nullptr);
+	size_t count(0);
+	ASSERT_EQ(NP_OK, np_spikes(handle, &last, &count));
+	EXPECT_EQ(spikes.back(), std::vector<unsigned long>(last, last+count));
+	
+	//A restart runs the same trial again without creating the connections
+	ASSERT_EQ(NP_OK, np_restart(handle, 0));
+	EXPECT_EQ(0u, np_clock(handle));
+	std::vector<std::vector<unsigned long>> trial;
+	ASSERT_EQ(NP_OK, np_run(handle, 200, keepSpikes, &trial));
+	EXPECT_EQ(spikes, trial);
+	
+	//A new seed or a new size removes the rates of the old network with it
+	ASSERT_EQ(NP_OK, np_set_seed(handle, 8));
+	ASSERT_EQ(NP_OK, np_rates(handle, &excitatory, &inhibitory, &nbr_steps));
+	EXPECT_EQ(0u, nbr_steps);
+	ASSERT_EQ(NP_OK, np_step(handle));
+	ASSERT_EQ(NP_OK, np_set_size(handle, 200, 50, 20, 5));
+	ASSERT_EQ(NP_OK, np_rates(handle, &excitatory, &inhibitory, &nbr_steps));
+	EXPECT_EQ(0u, nbr_steps);
+	
+	np_destroy(handle);
+	
+}
+
+
+TEST (SimulationServerTest, CachedJobs) {
+	
+	EXPECT_THROW(parseJob("time=100 g=5"), std::invalid_argument);
+	EXPECT_THROW(parseJob("time=100 g=5 eta=2 seed"), std::invalid_argument);
+	EXPECT_THROW(parseJob("time=100 g=5 eta=2 sed=1"), std::invalid_argument);
+	EXPECT_THROW(parseJob("time=100 g=5 eta=2 seed=1 noise-seed=4294967297"), std::invalid_argument);
+	EXPECT_EQ(200u, parseJob("time=100 g=5 eta=2 excitatory=200").size.nbr_excitatory);
+	
+	std::atomic<bool> stop(false);
+	SimulationServer server("server_test.sock", 2, 1);
+	std::thread serving([&]() { server.serve(stop); });
+	
+	//Two jobs of the same network and a job without eta, sent on one connection
+	const int fd(socket(AF_UNIX, SOCK_STREAM, 0));
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family=AF_UNIX;
+	std::strcpy(address.sun_path, "server_test.sock");
+	ASSERT_EQ(0, connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+	const std::string job("time=50 g=5 eta=2 seed=9 excitatory=800 inhibitory=200 connections-excitatory=80 connections-inhibitory=20 rate-bin=5\n");
+	const std::string jobs(job+job+"time=50 g=5\n");
+	ASSERT_EQ(static_cast<ssize_t>(jobs.size()), send(fd, jobs.data(), jobs.size(), 0));
+	shutdown(fd, SHUT_WR);
+	
+	//The server closes the connection after the answers of all the jobs
+	std::string answers;
+	char buffer[4096];
+	ssize_t size;
+	while((size=read(fd, buffer, sizeof(buffer)))>0) {
+		answers.append(buffer, size);
+	}
+	close(fd);
+	stop=true;
+	serving.join();
+	
+	std::vector<std::vector<std::string>> results(1);
+	std::istringstream lines(answers);
+	std::string line;
+	while(std::getline(lines, line)) {
+		results.back().push_back(line);
+		if(line.compare(0, 4, "done")==0 or line.compare(0, 5, "error")==0) {
+			results.emplace_back();
+		}
+	}
+	ASSERT_EQ(4u, results.size());
+	ASSERT_EQ(12u, results[0].size());	//Header, 10 bins of 5 ms and summary
+	
+	//The second job uses the kept network, and has the same noise
+	EXPECT_EQ(std::string::npos, results[0].back().find("\"construction_s\": 0,"));
+	EXPECT_NE(std::string::npos, results[1].back().find("\"construction_s\": 0,"));
+	EXPECT_NE(std::string::npos, results[1].back().find("\"seed\": 9,"));
+	EXPECT_EQ(std::vector<std::string>(results[0].begin(), results[0].end()-1), std::vector<std::string>(results[1].begin(), results[1].end()-1));
+	EXPECT_EQ("error The parameter eta is missing", results[2].back());
+	EXPECT_EQ(1u, server.getCachedNetworks());
+	
+}
+
+
+TEST (SimulationServerTest, AnswersDuringCreation) {
+	
+	std::atomic<bool> stop(false);
+	SimulationServer server("server_build_test.sock", 2, 1);
+	std::thread serving([&]() { server.serve(stop); });
+	auto connectClient([]() {
+		const int fd(socket(AF_UNIX, SOCK_STREAM, 0));
+		sockaddr_un address;
+		std::memset(&address, 0, sizeof(address));
+		address.sun_family=AF_UNIX;
+		std::strcpy(address.sun_path, "server_build_test.sock");
+		EXPECT_EQ(0, connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+		return fd;
+	});
+	
+	//The network of the paper takes a long time to create, during which another client gets its answer
+	const int waiting(connectClient());
+	const std::string job("time=1 g=5 eta=2 seed=11 rate-bin=0\n");
+	ASSERT_EQ(static_cast<ssize_t>(job.size()), send(waiting, job.data(), job.size(), 0));
+	shutdown(waiting, SHUT_WR);
+	
+	const int answered(connectClient());
+	const std::string wrong_job("time=1 g=5\n");
+	ASSERT_EQ(static_cast<ssize_t>(wrong_job.size()), send(answered, wrong_job.data(), wrong_job.size(), 0));
+	shutdown(answered, SHUT_WR);
+	std::string error;
+	char buffer[4096];
+	ssize_t size;
+	while((size=read(answered, buffer, sizeof(buffer)))>0) {
+		error.append(buffer, size);
+	}
+	close(answered);
+	EXPECT_EQ("error The parameter eta is missing\n", error);
+	EXPECT_EQ(-1, recv(waiting, buffer, sizeof(buffer), MSG_DONTWAIT));	//The job still waits for its network
+	
+	std::string answer;
+	while((size=read(waiting, buffer, sizeof(buffer)))>0) {
+		answer.append(buffer, size);
+	}
+	close(waiting);
+	stop=true;
+	serving.join();
+	EXPECT_EQ(0u, answer.find("done {"));
+	EXPECT_EQ(std::string::npos, answer.find("\"construction_s\": 0,"));
+	EXPECT_EQ(1u, server.getCachedNetworks());
+	
+}
+
+
+TEST (SimulationServerTest, ClientDisconnects) {
+	
+	//The rates sent to a client that is gone give an error, without a second one from the destructor of the recorder
+	int fds[2];
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+	close(fds[1]);
+	EXPECT_THROW({
+		PopulationRateRecorder recorder(std::unique_ptr<OutputSink>(new SocketSink(fds[0])), h);
+		recorder.open(RunInfo {h, 5.0, 2.0, 100000, 100, 80, 0});
+		for(unsigned int long step(0); step<100000; ++step) {
+			recorder.record(step, {1});
+		}
+	}, std::system_error);
+	close(fds[0]);
+	
+	std::atomic<bool> stop(false);
+	SimulationServer server("server_disconnect_test.sock", 2, 1);
+	std::thread serving([&]() { server.serve(stop); });
+	auto connectClient([]() {
+		const int fd(socket(AF_UNIX, SOCK_STREAM, 0));
+		sockaddr_un address;
+		std::memset(&address, 0, sizeof(address));
+		address.sun_family=AF_UNIX;
+		std::strcpy(address.sun_path, "server_disconnect_test.sock");
+		EXPECT_EQ(0, connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+		return fd;
+	});
+	const std::string size(" excitatory=80 inhibitory=20 connections-excitatory=8 connections-inhibitory=2");
+	
+	//A client leaves in the middle of the rates of a long job
+	const int leaving(connectClient());
+	const std::string long_job("time=100000 g=5 eta=2 seed=3 rate-bin=0.1"+size+"\n");
+	ASSERT_EQ(static_cast<ssize_t>(long_job.size()), send(leaving, long_job.data(), long_job.size(), 0));
+	char buffer[4096];
+	EXPECT_GT(read(leaving, buffer, sizeof(buffer)), 0);
+	close(leaving);
+	
+	//A client sends wrong jobs without reading their errors, which fill its socket
+	const int flooding(connectClient());
+	std::string wrong_jobs;
+	for(unsigned int i(0); i<20000; ++i) {
+		wrong_jobs+="x\n";
+	}
+	ASSERT_EQ(static_cast<ssize_t>(wrong_jobs.size()), send(flooding, wrong_jobs.data(), wrong_jobs.size(), 0));
+	shutdown(flooding, SHUT_WR);
+	
+	//The server still answers the other clients
+	const int staying(connectClient());
+	const std::string job("time=10 g=5 eta=2 seed=3 rate-bin=0"+size+"\n");
+	ASSERT_EQ(static_cast<ssize_t>(job.size()), send(staying, job.data(), job.size(), 0));
+	shutdown(staying, SHUT_WR);
+	std::string answer;
+	ssize_t read_size;
+	while((read_size=read(staying, buffer, sizeof(buffer)))>0) {
+		answer.append(buffer, read_size);
+	}
+	close(staying);
+	EXPECT_EQ(0u, answer.find("done {"));
+	
+	//The errors are all sent once the client reads them
+	std::string errors;
+	while((read_size=read(flooding, buffer, sizeof(buffer)))>0) {
+		errors.append(buffer, read_size);
+	}
+	close(flooding);
+	stop=true;
+	serving.join();
+	EXPECT_EQ(20000, std::count(errors.begin(), errors.end(), '\n'));
+	EXPECT_EQ(0u, errors.find("error "));
+	
+}
+
+
+TEST (SpikeFileTest, WriteAndRead) {
+	
+	const TestFiles files({"spikes_test.bin"});
+	
+	const RunInfo info {h, 5.0, 2.0, 1000, 12500, 10000, 0};
+	
+	//Spikes of 4 steps, the last ones given in disorder
+	BinarySpikeRecorder recorder("spikes_test.bin");
+	recorder.open(info);
+	recorder.record(0, {});
+	recorder.record(3, {1, 5, 200});
+	recorder.record(4, {0});
+	recorder.record(300, {12499, 7, 2});
+	recorder.close();
+	
+	SpikeFileReader reader("spikes_test.bin");
+	
+	//The header should contain the parameters of the run
+	EXPECT_EQ(5.0, reader.getInfo().g);
+	EXPECT_EQ(2.0, reader.getInfo().eta);
+	EXPECT_EQ(1000, reader.getInfo().simtime);
+	EXPECT_EQ(12500, reader.getInfo().nbrNeurons);
+	EXPECT_EQ(10000, reader.getInfo().nbrExcitatory);
+	
+	//The steps without spikes are not stored and the neuron numbers are read in increasing order
+	unsigned int long step;
+	std::vector<unsigned int long> spikes;
+	ASSERT_TRUE(reader.nextStep(step, spikes));
+	EXPECT_EQ(3, step);
+	EXPECT_EQ(std::vector<unsigned int long>({1, 5, 200}), spikes);
+	ASSERT_TRUE(reader.nextStep(step, spikes));
+	EXPECT_EQ(4, step);
+	EXPECT_EQ(std::vector<unsigned int long>({0}), spikes);
+	ASSERT_TRUE(reader.nextStep(step, spikes));
+	EXPECT_EQ(300, step);
+	EXPECT_EQ(std::vector<unsigned int long>({2, 7, 12499}), spikes);
+	EXPECT_FALSE(reader.nextStep(step, spikes));
+	
+}
+
+
+TEST (SpikeFileTest, ConvertToText) {
+	
+	const TestFiles files({"spikes_test.bin", "spikes_test.txt"});
+	
+	const RunInfo info {h, 5.0, 2.0, 1000, 12500, 10000, 0};
+	
+	BinarySpikeRecorder recorder("spikes_test.bin");
+	recorder.open(info);
+	recorder.record(3, {1, 5, 200});
+	recorder.record(128, {0, 12499});
+	recorder.close();
+	
+	convertToText("spikes_test.bin", "spikes_test.txt");
+	
+	//The text file should have the format of spikes.txt, with neurons numbered from 1
+	std::ifstream text_file("spikes_test.txt");
+	std::stringstream content;
+	content<<text_file.rdbuf();
+	EXPECT_EQ("3\t2\n3\t6\n3\t201\n128\t1\n128\t12500\n", content.str());
+	
+}
+
+
+TEST (SpikeFileTest, StoppedEarly) {
+	
+	const TestFiles files({"stopped_test.bin", "stopped_test.spa"});
+	
+	const RunInfo info {h, 5.0, 2.0, 1000, 12500, 10000, 0};
+	
+	//A run stopped at the step 400 should give this number of steps to the readers instead of the simulation time
+	BinarySpikeRecorder recorder("stopped_test.bin");
+	SpikeArchiveRecorder archive_recorder("stopped_test.spa", 10.0, 1024);
+	for(Recorder* stopped : std::vector<Recorder*>({&recorder, &archive_recorder})) {
+		stopped->open(info);
+		stopped->record(3, {1, 5, 200});
+		stopped->record(399, {0});
+		stopped->stopEarly(400);
+		stopped->close();
+	}
+	
+	SpikeFileReader reader("stopped_test.bin");
+	EXPECT_EQ(400u, reader.getInfo().simtime);
+	unsigned int long step;
+	std::vector<unsigned int long> spikes;
+	ASSERT_TRUE(reader.nextStep(step, spikes));
+	EXPECT_EQ(3u, step);
+	ASSERT_TRUE(reader.nextStep(step, spikes));
+	EXPECT_EQ(399u, step);
+	EXPECT_FALSE(reader.nextStep(step, spikes));
+	
+	{
+		SpikeArchive archive("stopped_test.spa");
+		EXPECT_EQ(400u, archive.getInfo().simtime);
+		EXPECT_EQ(4u, archive.query(0, 1000, 0, 12499).size());
+	}
+	
+}
+
+
+//Recorder that keeps the steps it receives, to test the other recorders
+class MemoryRecorder : public Recorder {
+	
+	public :
+	
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override {
+		steps.push_back(step);
+		all_spikes.push_back(spikes);
+	}
+	
+	std::vector<unsigned int long> steps;
+	std::vector<std::vector<unsigned int long> > all_spikes;
+	
+};
+
+
+TEST (AsyncRecorderTest, WaitKeepsAllSteps) {
+	
+	const RunInfo info {h, 5.0, 2.0, 1000, 100, 80, 0};
+	MemoryRecorder memory;
+	
+	//With a ring buffer of 16 values, the steps of 30 spikes must be pushed in several parts
+	AsyncRecorder recorder(memory, 16, AsyncRecorder::Policy::Wait);
+	recorder.open(info);
+	
+	std::vector<unsigned int long> spikes;
+	for(unsigned int long step(0); step<1000; ++step) {
+		spikes.resize(step%31);
+		for(size_t i(0); i<spikes.size(); ++i) {
+			spikes[i]=i*3+step%3;
+		}
+		recorder.record(step, spikes);
+	}
+	recorder.close();
+	
+	//Every step with spikes should have been received, complete and in order
+	EXPECT_EQ(0, recorder.getDroppedSpikes());
+	ASSERT_EQ(1000-33, memory.steps.size());
+	for(size_t i(0); i<memory.steps.size(); ++i) {
+		const unsigned int long step(memory.steps[i]);
+		ASSERT_EQ(step%31, memory.all_spikes[i].size());
+		EXPECT_EQ(step%3, memory.all_spikes[i][0]);
+	}
+	
+}
+
+
+TEST (AsyncRecorderTest, DropWholeSteps) {
+	
+	const RunInfo info {h, 5.0, 2.0, 1000, 100, 80, 0};
+	MemoryRecorder memory;
+	
+	AsyncRecorder recorder(memory, 8, AsyncRecorder::Policy::Drop);
+	recorder.open(info);
+	recorder.record(0, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10});	//Bigger than the ring buffer : always dropped
+	recorder.close();
+	
+	EXPECT_EQ(10, recorder.getDroppedSpikes());
+	EXPECT_EQ(1, recorder.getFullSteps());
+	EXPECT_TRUE(memory.steps.empty());
+	
+}
+
+
+TEST (OutputSinkTest, SameFileWithEachBackend) {
+	
+	const TestFiles files({"sink_test.bin"});
+	
+	//More than 3 blocks of 1 MiB, written in pieces of different sizes
+	std::string data;
+	for(unsigned int long i(0); data.size()<3500000; ++i) {
+		data+=std::to_string(i*i)+'\t';
+	}
+	
+	for(auto backend : {SinkBackend::Stream, SinkBackend::Pwrite, SinkBackend::Uring}) {
+		
+		//makeSink falls back to pwrite without io_uring : the UringSink is created directly, and only tested where it works
+		std::unique_ptr<OutputSink> sink;
+		if(backend==SinkBackend::Uring) {
+			try {
+				sink.reset(new UringSink("sink_test.bin"));
+			} catch(const std::system_error& error) {
+				std::cout<<"io_uring not available ("<<error.what()<<"), UringSink not tested"<<std::endl;
+				continue;
+			}
+		} else {
+			sink=makeSink("sink_test.bin", backend);
+		}
+		for(size_t written(0), piece(1); written<data.size(); written+=piece, piece=piece*3%4099+1) {
+			sink->write(data.data()+written, std::min(piece, data.size()-written));
+		}
+		sink->close();
+		
+		//The file should contain exactly the data, without the padding of O_DIRECT
+		std::ifstream file("sink_test.bin", std::ios::binary);
+		std::stringstream content;
+		content<<file.rdbuf();
+		EXPECT_TRUE(data==content.str());
+		
+	}
+	
+}
+
+
+TEST (RecorderTest, NeuronSets) {
+	
+	EXPECT_EQ(std::vector<unsigned int long>({10, 11, 12}), NeuronSet::range(10, 13).getNeurons());
+	EXPECT_EQ(std::vector<unsigned int long>({0, 25, 50, 75}), NeuronSet::stride(0, 100, 25).getNeurons());
+	EXPECT_THROW(NeuronSet::stride(0, 100, 0), std::invalid_argument);
+	EXPECT_EQ(std::vector<unsigned int long>({3, 7, 42}), NeuronSet::list({42, 3, 7, 3}).getNeurons());
+	
+	//A random sample has the asked size, without repetition, and is the same for the same seed
+	const NeuronSet sample(NeuronSet::random(50, 12500, 7));
+	EXPECT_EQ(50, sample.size());
+	EXPECT_LT(sample.getNeurons().back(), 12500u);
+	EXPECT_EQ(sample.getNeurons(), NeuronSet::random(50, 12500, 7).getNeurons());
+	
+	//Bitmask : bit 2 of the word 1 for the neuron 66
+	const std::vector<std::uint64_t> mask(NeuronSet::list({0, 66}).mask(100));
+	ASSERT_EQ(2, mask.size());
+	EXPECT_EQ(1, mask[0]);
+	EXPECT_EQ(4, mask[1]);
+	EXPECT_THROW(NeuronSet::list({100}).mask(100), std::out_of_range);
+	
+}
+
+
+TEST (RecorderTest, SpikeDevice) {
+	
+	const RunInfo info {0.1, 5.0, 2.0, 1000, 100, 80, 0};
+	MemoryRecorder small_memory;
+	MemoryRecorder large_memory;
+	
+	//Both ways of selecting the spikes (set smaller or larger than the spikes of a step) are used
+	SpikeDevice small_device(small_memory, NeuronSet::list({10, 15, 19}), 0.1, 0.3);
+	SpikeDevice large_device(large_memory, NeuronSet::range(10, 20), 0.1, 0.3);
+	
+	for(auto device : {&small_device, &large_device}) {
+		device->open(info);
+		device->record(0, {10, 15});	//Before the time window
+		device->record(1, {1, 10, 15, 19, 20, 99});
+		device->record(2, {0, 5, 25});
+		device->record(2, {19});
+		device->record(3, {19});	//After the time window
+		device->close();
+	}
+	
+	//The steps without spikes in the set are not given
+	for(auto memory : {&small_memory, &large_memory}) {
+		EXPECT_EQ(std::vector<unsigned int long>({1, 2}), memory->steps);
+		EXPECT_EQ(std::vector<unsigned int long>({10, 15, 19}), memory->all_spikes[0]);
+		EXPECT_EQ(std::vector<unsigned int long>({19}), memory->all_spikes[1]);
+	}
+	
+}
+
+
+TEST (RecorderTest, PopulationRate) {
+	
+	const TestFiles files({"rates_test.txt", "rates_unopened_test.txt"});
+	
+	//Network of 80 excitatory neurons and 20 inhibitory neurons, 25 steps recorded in bins of 1 ms (10 steps)
+	const RunInfo info {0.1, 5.0, 2.0, 25, 100, 80, 0};
+	
+	PopulationRateRecorder recorder("rates_test.txt", 1.0);
+	recorder.open(info);
+	recorder.record(0, {1, 2, 85});
+	recorder.record(9, {79, 80});
+	recorder.record(21, {3});	//The bin from 1 ms to 2 ms has no spikes
+	recorder.close();
+	
+	std::ifstream file("rates_test.txt");
+	std::string line;
+	std::getline(file, line);	//Header line
+	
+	//3 excitatory spikes of 80 neurons in 1 ms -> 37.5 Hz, 2 inhibitory spikes of 20 neurons -> 100 Hz
+	std::getline(file, line);
+	EXPECT_EQ("0.000\t3\t2\t37.500\t100.000", line);
+	std::getline(file, line);
+	EXPECT_EQ("1.000\t0\t0\t0.000\t0.000", line);
+	std::getline(file, line);
+	EXPECT_EQ("2.000\t1\t0\t12.500\t0.000", line);
+	EXPECT_FALSE(std::getline(file, line));
+	
+	//A recorder of a run that failed before starting writes no bins
+	{
+		PopulationRateRecorder unopened("rates_unopened_test.txt", 1.0);
+	}
+	std::ifstream unopened_file("rates_unopened_test.txt");
+	EXPECT_FALSE(std::getline(unopened_file, line));
+	
+}
+
+
+TEST (MultimeterTest, SamplesOfNeurons) {
+	
+	const TestFiles files({"multimeter_test.bin", "multimeter_empty_test.bin"});
+	
+	//Network of 10 neurons, each receiving the CE and CI connections of constants.hpp drawn among them, and a drawn seed
+	Network network(8, 2, 2, 5);
+	const RunInfo info {h, 5.0, 2.0, 100, 10, 8, 0};
+	
+	//Samples every 0.5 ms (5 steps) in blocks of 3 samples
+	EXPECT_THROW(Multimeter("multimeter_empty_test.bin", NeuronSet::list({1, 9}), 0.5, 0), std::invalid_argument);
+	Multimeter multimeter("multimeter_test.bin", NeuronSet::list({1, 9}), 0.5, 3);
+	multimeter.open(info);
+	
+	std::vector<std::vector<double> > expected(2);
+	for(unsigned int long step(0); step<50; ++step) {
+		network.update(0.0);
+		multimeter.sample(step, network);
+		if(step%5==0) {
+			expected[0].push_back(network.getNeuron(1).getPotential());
+			expected[1].push_back(network.getNeuron(9).getPotential());
+		}
+	}
+	multimeter.close();
+	
+	const MultimeterTrace trace(readMultimeter("multimeter_test.bin"));
+	EXPECT_EQ(5, trace.interval_steps);
+	EXPECT_EQ(std::vector<unsigned int long>({1, 9}), trace.neurons);
+	ASSERT_EQ(10, trace.steps.size());
+	EXPECT_EQ(45, trace.steps.back());
+	EXPECT_EQ(expected, trace.potentials);
+	
+}
+
+
+TEST (SpikeArchiveTest, QueryWindow) {
+	
+	const TestFiles files({"archive_test.spa"});
+	
+	//1000 neurons, 2000 steps, chunks of 10 ms (100 steps) and 100 neurons
+	const RunInfo info {0.1, 5.0, 2.0, 2000, 1000, 800, 0};
+	SpikeArchiveRecorder recorder("archive_test.spa", 10.0, 100);
+	recorder.open(info);
+	
+	//Each neuron spikes every 37 steps
+	std::vector<unsigned int long> spikes;
+	for(unsigned int long step(0); step<2000; ++step) {
+		spikes.clear();
+		for(unsigned int long neuron(step%37); neuron<1000; neuron+=37) {
+			spikes.push_back(neuron);
+		}
+		recorder.record(step, spikes);
+	}
+	recorder.close();
+	
+	SpikeArchive archive("archive_test.spa");
+	EXPECT_EQ(1000, archive.getInfo().nbrNeurons);
+	EXPECT_EQ(20*10, archive.getIndex().size());
+	
+	//Neurons 0 to 50 between 40 ms and 60 ms : 2 windows of 1 block of neurons
+	const std::vector<Spike> window(archive.query(400, 600, 0, 50));
+	EXPECT_EQ(2, archive.getChunksRead());
+	
+	std::vector<Spike> expected;
+	for(unsigned int long step(400); step<600; ++step) {
+		for(unsigned int long neuron(step%37); neuron<=50; neuron+=37) {
+			expected.push_back(Spike {step, neuron});
+		}
+	}
+	ASSERT_EQ(expected.size(), window.size());
+	for(size_t i(0); i<expected.size(); ++i) {
+		EXPECT_EQ(expected[i].step, window[i].step);
+		EXPECT_EQ(expected[i].neuron, window[i].neuron);
+	}
+	
+}
+
+
+TEST (SpikeAnalysisTest, SameDataFromEachFormat) {
+	
+	const TestFiles files({"analysis_test.txt", "analysis_test.bin", "analysis_test.spa", "analysis_raster.csv", "analysis_rate.csv"});
+	
+	//The same spikes are written as text, in a binary spike file and in an archive
+	const RunInfo info {h, 5.0, 2.0, 2000, N, NE, 0};
+	TextSpikeRecorder text_recorder("analysis_test.txt");
+	BinarySpikeRecorder binary_recorder("analysis_test.bin");
+	SpikeArchiveRecorder archive_recorder("analysis_test.spa", 10.0, 1024);
+	std::vector<Recorder*> recorders {&text_recorder, &binary_recorder, &archive_recorder};
+	
+	//Each neuron spikes every 370 steps
+	unsigned int long expected_spikes(0), expected_raster(0);
+	std::vector<unsigned int long> spikes;
+	for(auto recorder : recorders) {
+		recorder->open(info);
+	}
+	for(unsigned int long step(0); step<2000; ++step) {
+		spikes.clear();
+		for(unsigned int long neuron(step%370); neuron<N; neuron+=370) {
+			spikes.push_back(neuron);
+			if(step>=200 and step<1500) {
+				++expected_spikes;
+				expected_raster+=(neuron>=10 and neuron<60);
+			}
+		}
+		for(auto recorder : recorders) {
+			recorder->record(step, spikes);
+		}
+	}
+	for(auto recorder : recorders) {
+		recorder->close();
+	}
+	
+	//Small parts of text, so that each thread reads several of them
+	AnalysisOptions options(defaultAnalysisOptions());
+	options.start=20.0;
+	options.stop=150.0;
+	options.first_neuron=10;
+	options.last_neuron=59;
+	options.bin_width=1.0;
+	options.threads=3;
+	options.chunk_size=4096;
+	
+	//Only the text file needs the numbers of neurons
+	EXPECT_THROW(analyzeSpikes("analysis_test.txt", "analysis_raster.csv", "analysis_rate.csv", options), std::invalid_argument);
+	options.nbr_excitatory=NE;
+	options.nbr_inhibitory=NI;
+	
+	std::vector<std::string> rasters, rates;
+	for(const std::string name : {"analysis_test.txt", "analysis_test.bin", "analysis_test.spa"}) {
+		const AnalysisSummary summary(analyzeSpikes(name, "analysis_raster.csv", "analysis_rate.csv", options));
+		EXPECT_EQ(expected_spikes, summary.spikes);
+		EXPECT_EQ(expected_raster, summary.raster_spikes);
+		EXPECT_EQ(130, summary.bins);
+		
+		std::ifstream raster_file("analysis_raster.csv"), rate_file("analysis_rate.csv");
+		std::stringstream raster, rate;
+		raster<<raster_file.rdbuf();
+		rate<<rate_file.rdbuf();
+		rasters.push_back(raster.str());
+		rates.push_back(rate.str());
+	}
+	EXPECT_GT(rasters[0].size(), 0u);
+	EXPECT_EQ(rasters[0], rasters[1]);
+	EXPECT_EQ(rasters[0], rasters[2]);
+	EXPECT_EQ(rates[0], rates[1]);
+	EXPECT_EQ(rates[0], rates[2]);
+	
+	//The first spike of the raster is the neuron 11 at the step 380
+	EXPECT_EQ(0, rasters[0].find("time (ms),neuron\n38.000,11\n"));
+	
+}
+
+
+TEST (StatisticsRecorderTest, Regimes) {
+	
+	const RunInfo info {0.1, 5.0, 2.0, 20000, 1000, 800, 0};
+	std::vector<unsigned int long> spikes;
+	
+	//All the neurons spike together every 10 ms : synchronous and regular
+	StatisticsRecorder synchronous(1.0, 0.0, false);
+	synchronous.open(info);
+	for(unsigned int long step(0); step<20000; step+=100) {
+		spikes.resize(1000);
+		for(unsigned int long neuron(0); neuron<1000; ++neuron) {
+			spikes[neuron]=neuron;
+		}
+		synchronous.record(step, spikes);
+	}
+	synchronous.close();
+	
+	NetworkStatistics statistics(synchronous.getStatistics());
+	EXPECT_EQ(2000, statistics.bins);
+	EXPECT_NEAR(100.0, statistics.rate, 1e-9);
+	EXPECT_EQ(1000, statistics.regular_neurons);
+	EXPECT_NEAR(0.0, statistics.cv, 1e-9);
+	EXPECT_NEAR(1.0, statistics.synchrony, 1e-9);
+	EXPECT_EQ("SR", statistics.regime);
+	
+	//Each neuron spikes with a probability of 0.002 per step (20 Hz) : asynchronous and irregular
+	std::mt19937 gen(3);
+	std::bernoulli_distribution spike(0.002);
+	StatisticsRecorder asynchronous(1.0, 0.0, false);
+	asynchronous.open(info);
+	for(unsigned int long step(0); step<20000; ++step) {
+		spikes.clear();
+		for(unsigned int long neuron(0); neuron<1000; ++neuron) {
+			if(spike(gen)) {
+				spikes.push_back(neuron);
+			}
+		}
+		asynchronous.record(step, spikes);
+	}
+	asynchronous.close();
+	
+	statistics=asynchronous.getStatistics();
+	EXPECT_NEAR(20.0, statistics.rate, 1.0);
+	EXPECT_NEAR(1.0, statistics.cv, 0.1);
+	EXPECT_NEAR(1.0, statistics.fano_factor, 0.2);
+	EXPECT_LT(statistics.synchrony, 0.1);
+	EXPECT_EQ("AI", statistics.regime);
+	
+}
+
+
+TEST (CheckpointTest, ExactContinuation) {
+	
+	const TestFiles files({"checkpoint_test.ckp"});
+	
+	//Reference run of 150 steps, with a checkpoint after 50 steps
+	Network network(80, 20, 2, 5, 42);
+	for(size_t i(0); i<50; ++i) {
+		network.update(0.0);
+	}
+	Checkpoint::write("checkpoint_test.ckp", 5.0, 2.0, 50, network);
+	EXPECT_FALSE(std::ifstream("checkpoint_test.ckp.tmp"));
+	EXPECT_THROW(Checkpoint::write("missing_directory/checkpoint_test.ckp", 5.0, 2.0, 50, network), std::system_error);
+	
+	std::vector<std::vector<unsigned int long> > spikes;
+	for(size_t i(0); i<100; ++i) {
+		network.update(0.0);
+		spikes.push_back(network.getSpikes());
+	}
+	
+	//The network created again from the seed of the checkpoint continues exactly like the reference
+	const Checkpoint checkpoint("checkpoint_test.ckp");
+	EXPECT_EQ(50, checkpoint.getClock());
+	EXPECT_EQ(42, checkpoint.getSeed());
+	EXPECT_EQ(5.0, checkpoint.getG());
+	
+	Network restored(80, 20, 2, 5, checkpoint.getSeed());
+	EXPECT_EQ(network.getConnectionsChecksum(), restored.getConnectionsChecksum());
+	checkpoint.restore(restored);
+	EXPECT_EQ(50, restored.getClock());
+	
+	size_t nbr_spikes(0);
+	for(size_t i(0); i<100; ++i) {
+		restored.update(0.0);
+		EXPECT_EQ(spikes[i], restored.getSpikes());
+		nbr_spikes+=spikes[i].size();
+	}
+	EXPECT_GT(nbr_spikes, 0u);
+	for(unsigned int long neuron(0); neuron<100; ++neuron) {
+		EXPECT_EQ(network.getNeuron(neuron).getPotential(), restored.getNeuron(neuron).getPotential());
+		EXPECT_EQ(network.getNeuron(neuron).getNbrSpikes(), restored.getNeuron(neuron).getNbrSpikes());
+	}
+	
+	//A network with other connections can not be restored
+	Network other(80, 20, 2, 5, 43);
+	EXPECT_THROW(checkpoint.restore(other), std::runtime_error);
+	
+}
+
+
+TEST (CheckpointTest, ContinuedRecorders) {
+	
+	const TestFiles files({"continued_test.ckp", "reference_rates_test.txt", "continued_rates_test.txt"});
+	
+	//Reference run of 20 ms, and a run of 10 ms continued until 20 ms from its checkpoint
+	const NetworkSize size {400, 100, 40, 10};
+	auto runRecorders([&](const std::string& name, bool continued, NetworkStatistics& statistics, std::vector<std::string>& rows) {
+		Simulation simulation(20.0, 5.0, 2.0);
+		simulation.setNetworkSize(size);
+		simulation.setSeed(42);
+		if(continued) {
+			Simulation first(10.0, 5.0, 2.0);
+			first.setNetworkSize(size);
+			first.setSeed(42);
+			first.setCheckpoints("continued_test.ckp", 10.0);
+			first.run();
+			simulation.restore("continued_test.ckp");
+		}
+		StatisticsRecorder statistics_recorder(1.0, 10.0, false);
+		{
+			PopulationRateRecorder rate_recorder(name, 1.0);
+			simulation.addRecorder(&statistics_recorder);
+			simulation.addRecorder(&rate_recorder);
+			simulation.run();
+		}
+		statistics=statistics_recorder.getStatistics();
+		std::ifstream file(name);
+		std::string row;
+		while(std::getline(file, row)) {
+			rows.push_back(row);
+		}
+	});
+	NetworkStatistics reference, continued;
+	std::vector<std::string> reference_rows, continued_rows;
+	runRecorders("reference_rates_test.txt", false, reference, reference_rows);
+	runRecorders("continued_rates_test.txt", true, continued, continued_rows);
+	
+	//The bins of the continued run start at the checkpoint : the same bins as the end of the reference, without empty ones before
+	EXPECT_EQ(10u, continued.bins);
+	EXPECT_EQ(reference.bins, continued.bins);
+	EXPECT_GT(continued.rate, 0.0);
+	EXPECT_DOUBLE_EQ(reference.rate, continued.rate);
+	ASSERT_EQ(21u, reference_rows.size());
+	ASSERT_EQ(11u, continued_rows.size());
+	EXPECT_EQ(0u, continued_rows[1].find("10.000\t"));
+	EXPECT_EQ(std::vector<std::string>(reference_rows.begin()+11, reference_rows.end()),
+			  std::vector<std::string>(continued_rows.begin()+1, continued_rows.end()));
+	
+}
+
+
+TEST (CheckpointTest, WarmStartTrials) {
+	
+	const TestFiles files({"warm_start_test.ckp"});
+	
+	//State after a transient of 50 steps
+	Network network(80, 20, 2, 5, 42);
+	for(size_t i(0); i<50; ++i) {
+		network.update(0.0);
+	}
+	Checkpoint::write("warm_start_test.ckp", 5.0, 2.0, 50, network);
+	const Checkpoint checkpoint("warm_start_test.ckp");
+	
+	//Trials from this state, with a seed of the background noise and a perturbed value of eta
+	std::vector<std::vector<unsigned int long> > trials[3];
+	const unsigned int noise_seeds[3]={7, 7, 8};
+	for(size_t trial(0); trial<3; ++trial) {
+		Network restored(80, 20, 2.2, 5, checkpoint.getSeed());
+		checkpoint.restore(restored);
+		restored.reseedNoise(noise_seeds[trial]);
+		for(size_t i(0); i<100; ++i) {
+			restored.update(0.0);
+			trials[trial].push_back(restored.getSpikes());
+		}
+	}
+	
+	//The same seed gives the same trial, another seed another trial
+	EXPECT_EQ(trials[0], trials[1]);
+	EXPECT_NE(trials[0], trials[2]);
+	
+}
+
+
+TEST (EnsembleTest, TrialsInProcesses) {
+	
+	const TestFiles files({"ensemble_a.txt", "ensemble_b.txt", "ensemble_c.txt"});
+	
+	//3 trials of 20 ms with the same connections, 2 processes at the same time
+	Ensemble ensemble(20.0, 42, 80, 20, 2);
+	ensemble.addTrial(Trial {5.0, 2.0, 1, "ensemble_a", 0.0});
+	ensemble.addTrial(Trial {5.0, 2.0, 1, "ensemble_b", 0.0});
+	ensemble.addTrial(Trial {5.0, 2.0, 2, "ensemble_c", 0.0});
+	
+	const std::vector<int> statuses(ensemble.run([](const Trial& trial, Simulation& simulation, Network& network) {
+		TextSpikeRecorder recorder(trial.name+".txt");
+		simulation.addRecorder(&recorder);
+		simulation.run(network);
+	}));
+	EXPECT_EQ(std::vector<int>(3, 0), statuses);
+	
+	std::string spikes[3];
+	const std::string names[3]={"ensemble_a.txt", "ensemble_b.txt", "ensemble_c.txt"};
+	for(size_t i(0); i<3; ++i) {
+		std::ifstream spike_file(names[i]);
+		std::stringstream content;
+		content<<spike_file.rdbuf();
+		spikes[i]=content.str();
+	}
+	
+	//The same seed gives the same trial, another seed another trial
+	EXPECT_GT(spikes[0].size(), 0u);
+	EXPECT_EQ(spikes[0], spikes[1]);
+	EXPECT_NE(spikes[0], spikes[2]);
+	
+}
+
+
+TEST (SweepTest, PointsInProcesses) {
+	
+	const TestFiles files({"sweep_test.csv"});
+	
+	//A grid of 2 values of g and 1 value of eta, and the first point again from a list
+	Sweep sweep(42, 80, 20, 2, 10.0);
+	sweep.addGrid(3.0, 6.0, 2, 2.0, 2.0, 1, 50.0, 1);
+	sweep.addPoint(SweepPoint {3.0, 2.0, 50.0, 1});
+	EXPECT_THROW(sweep.addPoint(SweepPoint {0.0, 2.0, 50.0, 1}), std::invalid_argument);
+	ASSERT_EQ(3u, sweep.getPoints().size());
+	EXPECT_DOUBLE_EQ(6.0, sweep.getPoints()[1].g);
+	
+	const std::vector<SweepResult> results(sweep.run());
+	ASSERT_EQ(3u, results.size());
+	for(const auto& result : results) {
+		EXPECT_EQ(0, result.status);
+		EXPECT_EQ(40u, result.statistics.bins);
+		EXPECT_GT(result.statistics.rate, 0.0);
+		EXPECT_EQ(2u, result.statistics.regime.size());
+	}
+	
+	//The same point with the same connections gives the same statistics, more inhibition a lower rate
+	EXPECT_DOUBLE_EQ(results[0].statistics.rate, results[2].statistics.rate);
+	EXPECT_DOUBLE_EQ(results[0].statistics.synchrony, results[2].statistics.synchrony);
+	EXPECT_GT(results[0].statistics.rate, results[1].statistics.rate);
+	
+	Sweep::writeTable("sweep_test.csv", results);
+	std::ifstream table("sweep_test.csv");
+	std::string line;
+	size_t nbr_lines(0);
+	while(std::getline(table, line)) {
+		++nbr_lines;
+	}
+	EXPECT_EQ(4u, nbr_lines);
+	
+}
+
+
+TEST (StopMonitorTest, Conditions) {
+	
+	const RunInfo info {h, 5.0, 2.0, 100000, 100, 80, 0};
+	const std::vector<unsigned int long> silence;
+	
+	//No spike : quiescent after 50 ms
+	StopMonitor quiescent;
+	quiescent.open(info);
+	for(unsigned int long step(0); step<1000 and quiescent.getReason()==StopReason::None; ++step) {
+		quiescent.record(step, silence);
+	}
+	EXPECT_EQ(StopReason::Quiescence, quiescent.getReason());
+	EXPECT_EQ(500u, quiescent.getStopStep());
+	
+	//Each neuron fires every 2 ms (1/Tref) : saturated after 50 ms
+	StopMonitor saturated;
+	saturated.open(info);
+	for(unsigned int long step(0); step<1000 and saturated.getReason()==StopReason::None; ++step) {
+		std::vector<unsigned int long> spikes;
+		for(unsigned int long neuron(step%20); neuron<100; neuron+=20) {
+			spikes.push_back(neuron);
+		}
+		saturated.record(step, spikes);
+	}
+	EXPECT_EQ(StopReason::Saturation, saturated.getReason());
+	EXPECT_EQ(500u, saturated.getStopStep());
+	EXPECT_NEAR(500.0, saturated.getWindowRate(), 1e-9);
+	
+	//Random activity at 100 Hz : the statistics converge
+	StopConditions conditions(defaultStopConditions());
+	conditions.quiescence_rate=0.0;
+	conditions.saturation_fraction=0.0;
+	StopMonitor converged(conditions);
+	converged.open(info);
+	std::mt19937 generator(1);
+	std::bernoulli_distribution fires(0.01);
+	unsigned int long step(0);
+	for(; step<100000 and converged.getReason()==StopReason::None; ++step) {
+		std::vector<unsigned int long> spikes;
+		for(unsigned int long neuron(0); neuron<100; ++neuron) {
+			if(fires(generator)) {
+				spikes.push_back(neuron);
+			}
+		}
+		converged.record(step, spikes);
+	}
+	EXPECT_EQ(StopReason::Convergence, converged.getReason());
+	EXPECT_EQ(step, converged.getStopStep());
+	EXPECT_GT(step, 1000u);
+	
+}
+
+
+TEST (StopMonitorTest, SimulationStopsEarly) {
+	
+	//The simulation stops at the end of the window in which a condition is met, and the statistics end there too
+	Network network(80, 20, 2.0, 5.0, 42);
+	Simulation simulation(2000.0, 5.0, 2.0);
+	StatisticsRecorder statistics_recorder(1.0, 0.0, false);
+	simulation.addRecorder(&statistics_recorder);
+	simulation.setStopConditions(defaultStopConditions());
+	simulation.run(network);
+	
+	EXPECT_NE(StopReason::None, simulation.getStopReason());
+	EXPECT_LT(simulation.getClock(), simulation.getSimtime());
+	EXPECT_EQ(0u, simulation.getClock()%100);
+	EXPECT_EQ(simulation.getClock()/10, statistics_recorder.getStatistics().bins);
+	
+	//A run continued from a checkpoint is not quiescent because of the steps before the checkpoint
+	StopMonitor continued;
+	continued.open(RunInfo {h, 5.0, 2.0, 100000, 100, 80, 1000});
+	for(unsigned int long step(1000); step<1100; ++step) {
+		continued.record(step, std::vector<unsigned int long> {step%100});
+	}
+	EXPECT_EQ(StopReason::None, continued.getReason());
+	
+}
+
+
+TEST (MeanFieldTest, StationaryRates) {
+	
+	//Inhibition-dominated network : one stable rate, with the inputs of the mean field
+	const MeanField inhibited(5.0, 2.0);
+	const std::vector<MeanFieldSolution> solutions(inhibited.solve());
+	ASSERT_EQ(1u, solutions.size());
+	EXPECT_NEAR(solutions[0].rate, inhibited.transfer(solutions[0].rate), 1e-4);
+	EXPECT_GT(solutions[0].rate, 20.0);
+	EXPECT_LT(solutions[0].rate, 50.0);
+	EXPECT_NEAR(CE*J*TAU*(2.0*Nu_thr+solutions[0].rate/1000.0*(1.0-5.0*CI/CE)), solutions[0].mu, 1e-9);
+	EXPECT_LT(solutions[0].slope, 0.0);
+	EXPECT_EQ(MeanFieldStability::Stable, solutions[0].stability);
+	
+	//More inhibition, lower rate
+	EXPECT_LT(MeanField(6.0, 2.0).solve().front().rate, solutions[0].rate);
+	
+	//Excitation-dominated network with a weak background : silent state, runaway state and saturated state
+	const std::vector<MeanFieldSolution> bistable(MeanField(2.0, 0.5).solve());
+	ASSERT_EQ(3u, bistable.size());
+	EXPECT_DOUBLE_EQ(0.0, bistable[0].rate);
+	EXPECT_EQ(MeanFieldStability::Stable, bistable[0].stability);
+	EXPECT_EQ(MeanFieldStability::Runaway, bistable[1].stability);
+	EXPECT_GT(bistable[2].rate, 0.5*1000.0/Tref);
+	
+	//The delayed inhibition oscillates at a few hundred Hz
+	EXPECT_GT(inhibited.getCriticalSlope(), 1.0);
+	EXPECT_GT(inhibited.getOscillationFrequency(), 100.0);
+	EXPECT_LT(inhibited.getOscillationFrequency(), 1000.0/(2.0*delay));
+	
+}
+
+
+TEST (PopulationDensityTest, StationaryRate) {
+	
+	const TestFiles files({"density_test.txt"});
+	
+	PopulationDensity density(NE, NI, 2.0, 5.0);
+	density.run(3000);
+	EXPECT_EQ(3000u, density.getClock());
+	ASSERT_EQ(3000u, density.getRates().size());
+	
+	//The neurons are either in the density or refractory
+	const std::vector<double> probabilities(density.getDensity());
+	double mass(density.getRefractory());
+	for(auto probability : probabilities) {
+		EXPECT_GE(probability, 0.0);
+		mass+=probability;
+	}
+	EXPECT_NEAR(1.0, mass, 1e-9);
+	
+	//After the transient, the rate is the stationary rate of the mean field
+	EXPECT_NEAR(MeanField(5.0, 2.0).solve().front().rate, density.getRate(), 0.01*density.getRate());
+	
+	//One line per bin of 1 ms after the header
+	density.writeRates("density_test.txt", 1.0);
+	std::ifstream rate_file("density_test.txt");
+	std::string line;
+	size_t nbr_lines(0);
+	while(std::getline(rate_file, line)) {
+		++nbr_lines;
+	}
+	EXPECT_EQ(301u, nbr_lines);
+	
+}
+
+
+TEST (PreciseNetworkTest, StepIndependentRate) {
+	
+	EXPECT_THROW(PreciseNetwork(Network(80, 20, 2, 5, 42), 2, 5, 2.0), std::invalid_argument);
+	
+	//With exact spike times, a step of 0.5 ms gives the rate of a step of 0.1 ms
+	Network network(NE, NI, 2, 5, 42);
+	std::vector<double> rates;
+	for(auto step : {0.1, 0.5}) {
+		PreciseNetwork precise(network, 2, 5, step, 7);
+		std::vector<double> last_spikes(NE+NI, -Tref);
+		size_t nbr_spikes(0);
+		while(precise.getClock()*step<200.0) {
+			const double start(precise.getClock()*step);
+			precise.update();
+			const std::vector<unsigned int long>& spikes(precise.getSpikes());
+			ASSERT_EQ(spikes.size(), precise.getSpikeTimes().size());
+			EXPECT_TRUE(std::is_sorted(spikes.begin(), spikes.end()));
+			for(size_t i(0); i<spikes.size(); ++i) {
+				const double time(precise.getSpikeTimes()[i]);
+				EXPECT_GE(time, start);
+				EXPECT_LT(time, start+step);
+				EXPECT_GE(time-last_spikes[spikes[i]], Tref-1e-9);
+				last_spikes[spikes[i]]=time;
+			}
+			if(start>=100.0) {
+				nbr_spikes+=spikes.size();
+			}
+		}
+		rates.push_back(nbr_spikes/((NE+NI)*0.1));
+	}
+	EXPECT_NEAR(rates[0], rates[1], 0.02*rates[0]);
+	EXPECT_NEAR(MeanField(5.0, 2.0).solve().front().rate, rates[1], 0.05*rates[1]);
+	
+}
+
+
+TEST (EventNetworkTest, WorkFollowsEvents) {
+	
+	EXPECT_THROW(EventNetwork(Network(80, 20, 2, 5, 42), 0, 5), std::invalid_argument);
+	
+	Network network(NE, NI, 2, 5, 42);
+	
+	//Below the threshold drive, the neurons stay silent and the work is only the background spikes
+	EventNetwork silent(network, 0.5, 5, 7);
+	for(unsigned int long i(0); i<1000; ++i) {
+		silent.update();
+		EXPECT_TRUE(silent.getSpikes().empty());
+	}
+	const double background((NE+NI)*0.5*V_thr/(J*TAU)*100.0);
+	EXPECT_NEAR(background, silent.getNbrEvents(), 5*std::sqrt(background));
+	
+	//In the asynchronous regime, the exact spike times give the rate of the mean field
+	EventNetwork events(network, 2, 5, 7);
+	std::vector<double> last_spikes(NE+NI, -Tref);
+	size_t nbr_spikes(0);
+	while(events.getClock()*h<200.0) {
+		const double start(events.getClock()*h);
+		events.update();
+		const std::vector<unsigned int long>& spikes(events.getSpikes());
+		ASSERT_EQ(spikes.size(), events.getSpikeTimes().size());
+		EXPECT_TRUE(std::is_sorted(spikes.begin(), spikes.end()));
+		for(size_t i(0); i<spikes.size(); ++i) {
+			const double time(events.getSpikeTimes()[i]);
+			EXPECT_GE(time, start);
+			EXPECT_LT(time, start+h);
+			EXPECT_GE(time-last_spikes[spikes[i]], Tref-1e-9);
+			last_spikes[spikes[i]]=time;
+		}
+		if(start>=100.0) {
+			nbr_spikes+=spikes.size();
+		}
+	}
+	const double rate(nbr_spikes/((NE+NI)*0.1));
+	EXPECT_NEAR(MeanField(5.0, 2.0).solve().front().rate, rate, 0.05*rate);
+	
+}
+
+
+TEST (BatchNetworkTest, TrialsInLanes) {
+	
+	Network network(80, 20, 2, 5, 42);
+	
+	//A batch of one trial with the noise seed of the network gives the same spikes as the network
+	BatchNetwork<1> single(network, 2, 5, std::vector<unsigned int> {42});
+	size_t nbr_spikes(0);
+	for(size_t i(0); i<200; ++i) {
+		network.update(0.0);
+		single.update();
+		EXPECT_EQ(network.getSpikes(), single.getSpikes(0));
+		nbr_spikes+=network.getSpikes().size();
+	}
+	EXPECT_GT(nbr_spikes, 0u);
+	
+	//The trials of a batch do not depend on the other trials
+	BatchNetwork<8> batch8(network, 2, 5, std::vector<unsigned int> {1, 1, 2, 3, 4, 5, 6, 7});
+	BatchNetwork<16> batch16(network, 2, 5, std::vector<unsigned int> {2, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 1});
+	bool different(false);
+	for(size_t i(0); i<200; ++i) {
+		batch8.update();
+		batch16.update();
+		EXPECT_EQ(batch8.getSpikes(0), batch8.getSpikes(1));
+		EXPECT_EQ(batch8.getSpikes(0), batch16.getSpikes(15));
+		EXPECT_EQ(batch8.getSpikes(2), batch16.getSpikes(0));
+		different=different or (batch8.getSpikes(0)!=batch8.getSpikes(2));
+	}
+	EXPECT_TRUE(different);
+	EXPECT_EQ(200, batch16.getClock());
+	
+}
+
+
+TEST (BatchNetworkTest, ConstantsKernel) {
+	
+	EXPECT_THROW((BatchNetwork<1, ConstantsConfig>(Network(80, 20, 2, 5, 42), 2, 5, std::vector<unsigned int> {42})), std::invalid_argument);
+	
+	//The sizes known by the compiler are those read from a network of constants.hpp, and give the same spikes
+	Network network(NE, NI, 2, 5, 42);
+	const RuntimeConfig config(network);
+	EXPECT_EQ(config.nbrNeurons(), ConstantsConfig::nbrNeurons());
+	EXPECT_EQ(config.ringSize(), ConstantsConfig::ringSize());
+	EXPECT_EQ(config.refractorySteps(), ConstantsConfig::refractorySteps());
+	
+	BatchNetwork<2> generic(network, 2, 5, std::vector<unsigned int> {42, 7});
+	BatchNetwork<2, ConstantsConfig> constants(network, 2, 5, std::vector<unsigned int> {42, 7});
+	size_t nbr_spikes(0);
+	for(size_t i(0); i<300; ++i) {
+		generic.update();
+		constants.update();
+		EXPECT_EQ(generic.getSpikes(0), constants.getSpikes(0));
+		EXPECT_EQ(generic.getSpikes(1), constants.getSpikes(1));
+		nbr_spikes+=constants.getSpikes(1).size();
+	}
+	EXPECT_GT(nbr_spikes, 0u);
+	
+}
+
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
@@ -0,0 +1,151 @@
+#include "asyncRecorder.hpp"
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+//!Constructor
+AsyncRecorder::AsyncRecorder(Recorder& target_, size_t capacity, Policy policy_)
+: target(target_), policy(policy_), queue(capacity), done(false), stopped(false), stop_steps(0), dropped_spikes(0), full_steps(0), waits(0)
+{}
+
+
+//!Destructor
+AsyncRecorder::~AsyncRecorder() {
+	if(writer.joinable()) {
+		close();
+	}
+}
+
+
+//!Method that opens the target recorder and starts the background thread
+void AsyncRecorder::open(const RunInfo& info) {
+
+	target.open(info);
+
+	done=false;
+	stopped=false;
+	writer=std::thread(&AsyncRecorder::write, this);
+}
+
+
+//!Method that pushes the step and its spikes in the ring buffer
+void AsyncRecorder::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+
+	if(spikes.empty()) {	//The steps without spikes are not sent to the background thread
+		return;
+	}
+
+	const unsigned int long header[2]={step, spikes.size()};
+	const size_t needed(2+spikes.size());
+
+	if(queue.freeSpace()<needed) {
+		++full_steps;
+
+		//The step is dropped entirely, so that the background thread never receives a part of a step
+		if(policy==Policy::Drop) {
+			dropped_spikes+=spikes.size();
+			return;
+		}
+	}
+
+	//With Policy::Wait, a step bigger than the ring buffer is pushed in several parts
+	size_t pushed(0);
+	while(pushed<2) {
+		pushed+=queue.push(header+pushed, 2-pushed);
+		if(pushed<2) {
+			++waits;
+			std::this_thread::yield();
+		}
+	}
+
+	pushed=0;
+	while(pushed<spikes.size()) {
+		pushed+=queue.push(spikes.data()+pushed, spikes.size()-pushed);
+		if(pushed<spikes.size()) {
+			++waits;
+			std::this_thread::yield();
+		}
+	}
+}
+
+
+//!Method that keeps the number of steps done, given to the target once the background thread has written everything
+void AsyncRecorder::stopEarly(unsigned int long steps) {
+	stopped=true;
+	stop_steps=steps;
+}
+
+
+//!Method that waits for the background thread to write everything, closes the target and displays the counters
+void AsyncRecorder::close() {
+
+	if(!writer.joinable()) {
+		return;
+	}
+
+	done=true;
+	writer.join();
+
+	if(stopped) {
+		target.stopEarly(stop_steps);
+	}
+	target.close();
+
+	std::cout<<"Recorder : "<<full_steps<<" steps with a full buffer, "<<waits<<" waits, "
+			 <<dropped_spikes<<" spikes dropped"<<std::endl;
+}
+
+
+//!Getter for the number of spikes dropped because the ring buffer was full
+unsigned int long AsyncRecorder::getDroppedSpikes() const {
+	return dropped_spikes;
+}
+
+
+//!Getter for the number of steps during which the ring buffer was full
+unsigned int long AsyncRecorder::getFullSteps() const {
+	return full_steps;
+}
+
+
+//!Method executed by the background thread
+void AsyncRecorder::write() {
+
+	std::vector<unsigned int long> values(queue.getCapacity()/4+2);	//Values popped from the ring buffer
+	std::vector<unsigned int long> spikes;	//Spikes of the current step
+	unsigned int long header[2];	//Step and number of spikes of the current step
+	size_t header_size(0);	//Number of values of header already popped
+
+	while(true) {
+
+		//done is read before popping, so that the steps pushed before the end are all written
+		const bool last(done);
+		const size_t number(queue.pop(values.data(), values.size()));
+
+		if(number==0) {
+			if(last) {
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(100));	//The simulation is left alone while the ring buffer is empty
+			continue;
+		}
+
+		//A step may be split between several pops
+		for(size_t i(0); i<number; ++i) {
+			if(header_size<2) {
+				header[header_size++]=values[i];
+			} else {
+				spikes.push_back(values[i]);
+			}
+
+			if(header_size==2 and spikes.size()==header[1]) {
+				target.record(header[0], spikes);
+				spikes.clear();
+				header_size=0;
+			}
+		}
+	}
+}
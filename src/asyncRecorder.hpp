@@ -0,0 +1,101 @@
+//! AsyncRecorder class
+/*!To write the spikes in a background thread, so that the simulation never waits for the disk
+ */
+#ifndef ASYNCRECORDER_H
+#define ASYNCRECORDER_H
+#include "recorder.hpp"
+#include "spscQueue.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+
+class AsyncRecorder : public Recorder {
+
+	public :
+
+	//!What to do with the spikes of a step when the ring buffer is full
+	enum class Policy {
+		Wait,	//!The simulation waits until the background thread frees enough space
+		Drop	//!The spikes of the step are dropped
+	};
+
+
+	//!Constructor
+	/*!
+	 *\param target_ the recorder called by the background thread (for example a BinarySpikeRecorder)
+	 *\param capacity the number of values of the ring buffer (power of 2), a step takes 2 values plus 1 per spike
+	 *\param policy_ what to do when the ring buffer is full
+	*/
+	AsyncRecorder(Recorder& target_, size_t capacity=(1<<20), Policy policy_=Policy::Wait);
+
+
+	//!Destructor
+	virtual ~AsyncRecorder();
+
+
+	//!Method that opens the target recorder and starts the background thread
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info) override;
+
+
+	//!Method that pushes the step and its spikes in the ring buffer
+	/*!
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Method that keeps the number of steps done, given to the target once the background thread has written everything
+	/*!
+	 *\param steps the number of steps done
+	*/
+	virtual void stopEarly(unsigned int long steps) override;
+
+
+	//!Method that waits for the background thread to write everything, closes the target and displays the counters
+	virtual void close() override;
+
+
+	//!Getter for the number of spikes dropped because the ring buffer was full
+	/*!
+	 *\return the number of dropped spikes
+	*/
+	unsigned int long getDroppedSpikes() const;
+
+
+	//!Getter for the number of steps during which the ring buffer was full
+	/*!
+	 *\return the number of steps that waited (Policy::Wait) or were dropped (Policy::Drop)
+	*/
+	unsigned int long getFullSteps() const;
+
+
+
+	private :
+
+	//!Method executed by the background thread
+	/*!
+	 * pops the values of the ring buffer and gives the steps to the target recorder
+	*/
+	void write();
+
+
+	Recorder& target;	//!Recorder called by the background thread
+	Policy policy;	//!What to do when the ring buffer is full
+	SpscQueue<unsigned int long> queue;	//!Ring buffer : for each step, the step, the number of spikes and the neuron numbers
+	std::thread writer;	//!Background thread
+	std::atomic<bool> done;	//!True when the simulation has pushed its last step
+	bool stopped;	//!True if the simulation stopped before its simulation time
+	unsigned int long stop_steps;	//!Number of steps done when the simulation stopped
+	unsigned int long dropped_spikes;	//!Number of spikes dropped because the ring buffer was full
+	unsigned int long full_steps;	//!Number of steps during which the ring buffer was full
+	unsigned int long waits;	//!Number of times the simulation waited for the background thread
+
+};
+
+#endif
@@ -0,0 +1,221 @@
+//! BatchNetwork class
+/*!To simulate K trials of the same network at the same time, with different background noises
+ *
+ * The state of each neuron is a vector over the K trials (potentials, last spikes, buffers), so that the update
+ * of the potentials is the same operation on K contiguous values, vectorized by the compiler, and the targets of
+ * a neuron are read once for all the trials in which it spiked.
+ * The neurons follow the model of Neuron, with the potentials in double instead of long double.
+ *
+ * The sizes of the network, of the buffers and of the refractory period come from a configuration (see
+ * kernelConfig.hpp) : RuntimeConfig reads them from the network, ConstantsConfig gives those of constants.hpp to the
+ * compiler, for a network of N neurons only.
+ */
+#ifndef BATCHNETWORK_H
+#define BATCHNETWORK_H
+#include "network.hpp"
+#include "kernelConfig.hpp"
+#include "recorder.hpp"
+#include "poissonSampler.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+
+template<size_t K, class Config=RuntimeConfig>
+class BatchNetwork {
+
+	static_assert(K>0 and K<=64, "A batch contains between 1 and 64 trials");
+
+
+	public :
+
+	//!Constructor
+	/*!
+	 * copies the connections of a network, and starts all the trials with the potentials at 0
+	 * throws std::invalid_argument if there is not one seed per trial, or if the network does not match the configuration
+	 *\param network the network whose connections are used by the trials
+	 *\param eta_ the value of eta=Nu_ext/Nu_thr
+	 *\param g_ the value of g=JI/JE
+	 *\param noise_seeds the seeds of the background noise of the K trials
+	*/
+	BatchNetwork(const Network& network, double eta_, double g_, const std::vector<unsigned int>& noise_seeds)
+	: clock(0), eta(eta_), g(g_), config(network), offsets(1, 0), potentials(config.nbrNeurons()*K, 0.0),
+	  last_spikes(config.nbrNeurons()*K, -config.refractorySteps()), incoming_spikes(config.ringSize()*config.nbrNeurons()*K, 0),
+	  spikes(K), noise(eta_*V_thr*h/(J*TAU))
+	{
+		if(noise_seeds.size()!=K) {
+			throw std::invalid_argument("A batch needs one seed per trial");
+		}
+
+		//The targets of all the neurons are stored contiguously
+		for(unsigned int long i(0); i<config.nbrNeurons(); ++i) {
+			const std::vector<unsigned int long>& neuron_targets(network.getNeuron(i).getTargets());
+			targets.insert(targets.end(), neuron_targets.begin(), neuron_targets.end());
+			offsets.push_back(targets.size());
+		}
+
+		for(size_t k(0); k<K; ++k) {
+			std::seed_seq sequence {noise_seeds[k], 1u};
+			generators[k].seed(sequence);
+		}
+	}
+
+
+	//!Getter for the clock of the trials
+	/*!
+	 *\return the number of steps done
+	*/
+	unsigned int long getClock() const {
+		return clock;
+	}
+
+
+	//!Getter for the number of neurons of the network
+	/*!
+	 *\return the number of neurons of each trial
+	*/
+	unsigned int long getNbrNeurons() const {
+		return config.nbrNeurons();
+	}
+
+
+	//!Getter for the potential of a neuron in a trial
+	/*!
+	 *\param neuron the number of the neuron
+	 *\param trial the number of the trial (smaller than K)
+	 *\return the membrane potential of the neuron in this trial
+	*/
+	double getPotential(unsigned int long neuron, size_t trial) const {
+		return potentials[neuron*K+trial];
+	}
+
+
+	//!Getter for the neurons that spiked in a trial during the last update
+	/*!
+	 *\param trial the number of the trial (smaller than K)
+	 *\return the numbers of the neurons that spiked, in increasing order
+	*/
+	const std::vector<unsigned int long>& getSpikes(size_t trial) const {
+		return spikes[trial];
+	}
+
+
+	//!Method that updates the K trials by one step
+	void update() {
+
+		for(auto& trial_spikes : spikes) {
+			trial_spikes.clear();
+		}
+
+		const unsigned int long nbrNeurons(config.nbrNeurons());
+		const std::int64_t refractory_steps(config.refractorySteps());
+		const double decay(config.decay());
+		const std::int64_t now(clock);
+		int* current(&incoming_spikes[(clock%config.ringSize())*nbrNeurons*K]);	//Signals received at this step
+		int* delayed(&incoming_spikes[((clock+config.delaySteps())%config.ringSize())*nbrNeurons*K]);	//Signals received after the delay
+
+		double background[K];
+		bool spiked[K];
+		int weights[K];
+		for(unsigned int long i(0); i<nbrNeurons; ++i) {
+
+			//The background noise of each trial comes from its own generator
+			for(size_t k(0); k<K; ++k) {
+				background[k]=noise(generators[k]);
+			}
+
+			//Same update as Neuron::update, without branches, for the K trials
+			double* potential(&potentials[i*K]);
+			std::int64_t* last_spike(&last_spikes[i*K]);
+			int* input(&current[i*K]);
+			for(size_t k(0); k<K; ++k) {
+				spiked[k]=potential[k]>V_thr;
+				last_spike[k]=spiked[k] ? now : last_spike[k];
+				const bool refractory(now-last_spike[k]<refractory_steps);
+				const double updated(potential[k]*decay+J*input[k]+J*background[k]);
+				potential[k]=refractory ? 0.0 : updated;
+				input[k]=0;
+			}
+
+			//The targets are read once for all the trials in which the neuron spiked
+			const int weight(i<config.nbrExcitatory() ? JE : static_cast<int>(-g/JE));
+			bool any(false);
+			for(size_t k(0); k<K; ++k) {
+				weights[k]=spiked[k] ? weight : 0;
+				if(spiked[k]) {
+					spikes[k].push_back(i);
+					any=true;
+				}
+			}
+			if(any) {
+				for(size_t j(offsets[i]); j<offsets[i+1]; ++j) {
+					int* target(&delayed[targets[j]*K]);
+					for(size_t k(0); k<K; ++k) {
+						target[k]+=weights[k];
+					}
+				}
+			}
+		}
+
+		++clock;
+	}
+
+
+	//!Method that runs the K trials and gives the spikes of each trial to its recorder
+	/*!
+	 *\param steps the number of steps to run
+	 *\param recorders the recorder of each trial (nullptr for a trial that is not recorded)
+	*/
+	void run(unsigned int long steps, const std::vector<Recorder*>& recorders) {
+
+		if(recorders.size()!=K) {
+			throw std::invalid_argument("A batch needs one recorder per trial");
+		}
+
+		const RunInfo info {h, g, eta, steps, config.nbrNeurons(), config.nbrExcitatory(), 0};
+		for(auto recorder : recorders) {
+			if(recorder!=nullptr) {
+				recorder->open(info);
+			}
+		}
+
+		for(unsigned int long i(0); i<steps; ++i) {
+			const unsigned int long step(clock);
+			update();
+			for(size_t k(0); k<K; ++k) {
+				if(recorders[k]!=nullptr) {
+					recorders[k]->record(step, spikes[k]);
+				}
+			}
+		}
+
+		for(auto recorder : recorders) {
+			if(recorder!=nullptr) {
+				recorder->close();
+			}
+		}
+	}
+
+
+
+	private :
+
+	unsigned int long clock;	//!Clock of the trials
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	double g;	//!Value of g=JI/JE
+	Config config;	//!Sizes of the network, of the buffers and of the refractory period
+	std::vector<unsigned int long> offsets;	//!Position of the targets of each neuron in targets
+	std::vector<unsigned int long> targets;	//!Targets of all the neurons
+	std::vector<double> potentials;	//!Potential of each neuron in each trial (neuron*K+trial)
+	std::vector<std::int64_t> last_spikes;	//!Step of the last spike of each neuron in each trial
+	std::vector<int> incoming_spikes;	//!Buffers of the neurons : signals received by each neuron in each trial at each step
+	std::vector<std::vector<unsigned int long> > spikes;	//!Neurons that spiked in each trial during the last update
+	std::mt19937 generators[K];	//!Random generator of the background noise of each trial
+	PoissonSampler noise;	//!Poisson distribution of the background noise
+
+};
+
+#endif
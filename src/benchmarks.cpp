@@ -0,0 +1,115 @@
+#include "network.hpp"
+#include "batchNetwork.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+//Regime of the Fig.8 of the paper (see the README)
+struct Regime {
+	std::string name;
+	double g;
+	double eta;
+};
+
+
+//Function that gives the time in s of a simulated second of Network from a state, with or without the skip of the refractory neurons
+double updateTime(Network& network, const std::vector<unsigned char>& state, bool refractory_skip, unsigned int long steps) {
+	const unsigned char* position(state.data());
+	network.loadState(position, position+state.size());
+	network.setRefractorySkip(refractory_skip);
+	const auto start(std::chrono::steady_clock::now());
+	for(unsigned int long i(0); i<steps; ++i) {
+		network.update(0.0);
+	}
+	const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+	network.setRefractorySkip(true);
+	return duration.count()*1000.0/(steps*h);
+}
+
+
+//Function that gives the time in s of a simulated second of a single trial of BatchNetwork with a configuration
+template<class Config>
+double kernelTime(const Network& network, const Regime& regime, unsigned int long steps) {
+	BatchNetwork<1, Config> batch(network, regime.eta, regime.g, std::vector<unsigned int> {network.getSeed()});
+	const auto start(std::chrono::steady_clock::now());
+	for(unsigned int long i(0); i<steps; ++i) {
+		batch.update();
+	}
+	const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+	return duration.count()*1000.0/(steps*h);
+}
+
+}
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc>3) {
+		std::cerr<<"Usage : "<<argv[0]<<" [time_ms] [seed]"<<std::endl;
+		std::cerr<<"Simulates the network in the regimes A to D of the Fig.8 during time_ms (default : 200 ms) with the seed"<<std::endl;
+		std::cerr<<"(default : 1), and writes the time of a simulated second and the share of the updates that are skipped"<<std::endl;
+		std::cerr<<"because the neurons are refractory, the time of a simulated second without the skip and the speed-up of the"<<std::endl;
+		std::cerr<<"skip, then the time of a simulated second of the kernel of BatchNetwork with the sizes read at run time"<<std::endl;
+		std::cerr<<"(generic) and with the sizes of constants.hpp known by the compiler (constants)"<<std::endl;
+		return 1;
+	}
+
+	try {
+		const double time(argc>1 ? std::stod(argv[1]) : 200.0);
+		const unsigned int seed(argc>2 ? std::stoul(argv[2]) : 1);
+		if(!(time>0.0)) {
+			throw std::invalid_argument("The simulation time must be strictly positive");
+		}
+
+		//Same test as Neuron::isRefractory : a spike makes the neuron refractory during the next refractory_steps-1 steps
+		unsigned int long refractory_steps(0);
+		while(refractory_steps*h<Tref) {
+			++refractory_steps;
+		}
+
+		const std::vector<Regime> regimes {{"A", 3.0, 2.0}, {"B", 6.0, 4.0}, {"C", 5.0, 2.0}, {"D", 4.5, 0.9}};
+		const unsigned int long steps(time/h);
+		std::printf("regime\tg\teta\trate (Hz)\tskipped updates (%%)\ts per simulated s\twithout skip\tspeed-up\t"
+					"generic kernel\tconstants kernel\n");
+		for(const auto& regime : regimes) {
+
+			Network network(NE, NI, regime.eta, regime.g/JE, seed);
+			std::vector<unsigned char> initial_state;	//To run again from the same state (a copy of the network is slower)
+			network.saveState(initial_state);
+			unsigned int long nbr_spikes(0), skipped(0);
+
+			//The first run counts the spikes and warms the memory of the network
+			for(unsigned int long i(0); i<steps; ++i) {
+				network.update(0.0);
+				nbr_spikes+=network.getSpikes().size();
+				skipped+=network.getSpikes().size()*std::min(refractory_steps-1, steps-1-i);
+			}
+
+			//The same run, once the memory of the network is warm, with and without the skip of the refractory neurons
+			//(updated like the others, they give the same spikes : only the time differs)
+			const double skip_time(updateTime(network, initial_state, true, steps));
+			const double baseline_time(updateTime(network, initial_state, false, steps));
+
+			const double generic(kernelTime<RuntimeConfig>(network, regime, steps));
+			const double constants(kernelTime<ConstantsConfig>(network, regime, steps));
+
+			std::printf("%s\t%.1f\t%.1f\t%.1f\t%.1f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\n", regime.name.c_str(), regime.g, regime.eta,
+						nbr_spikes/((NE+NI)*steps*h/1000.0), 100.0*skipped/((NE+NI)*steps), skip_time,
+						baseline_time, baseline_time/skip_time, generic, constants);
+		}
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+//! Binary input/output functions
+/*!To write and read the numbers of the binary files in little-endian, whatever the machine
+ */
+#ifndef BINARYIO_H
+#define BINARYIO_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+
+//!Function that writes an integer of 'bytes' bytes in little-endian
+/*!
+ *\param destination where to write the integer
+ *\param value the integer to write
+ *\param bytes the number of bytes of the integer (8 at most)
+*/
+inline void putInteger(unsigned char* destination, std::uint64_t value, size_t bytes) {
+	for(size_t i(0); i<bytes; ++i) {
+		destination[i]=static_cast<unsigned char>(value>>(8*i));
+	}
+}
+
+
+//!Function that reads an integer of 'bytes' bytes in little-endian
+/*!
+ *\param source where to read the integer
+ *\param bytes the number of bytes of the integer (8 at most)
+ *\return the integer read
+*/
+inline std::uint64_t getInteger(const unsigned char* source, size_t bytes) {
+	std::uint64_t value(0);
+	for(size_t i(0); i<bytes; ++i) {
+		value|=static_cast<std::uint64_t>(source[i])<<(8*i);
+	}
+	return value;
+}
+
+
+//!Function that writes a double as its 64 bits pattern in little-endian
+/*!
+ *\param destination where to write the double
+ *\param value the double to write
+*/
+inline void putDouble(unsigned char* destination, double value) {
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	putInteger(destination, bits, 8);
+}
+
+
+//!Function that reads a double from its 64 bits pattern in little-endian
+/*!
+ *\param source where to read the double
+ *\return the double read
+*/
+inline double getDouble(const unsigned char* source) {
+	std::uint64_t bits(getInteger(source, 8));
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+
+//!Function that appends an integer of 'bytes' bytes in little-endian at the end of a buffer
+/*!
+ *\param buffer the buffer where to write the integer
+ *\param value the integer to write
+ *\param bytes the number of bytes of the integer (8 at most)
+*/
+inline void appendInteger(std::vector<unsigned char>& buffer, std::uint64_t value, size_t bytes) {
+	buffer.resize(buffer.size()+bytes);
+	putInteger(buffer.data()+buffer.size()-bytes, value, bytes);
+}
+
+
+//!Function that appends a double in little-endian at the end of a buffer
+/*!
+ *\param buffer the buffer where to write the double
+ *\param value the double to write
+*/
+inline void appendDouble(std::vector<unsigned char>& buffer, double value) {
+	buffer.resize(buffer.size()+8);
+	putDouble(buffer.data()+buffer.size()-8, value);
+}
+
+
+//!Function that takes the next bytes of a buffer being read
+/*!
+ * throws std::runtime_error if the buffer ends before
+ *\param position the current position in the buffer, moved after the bytes
+ *\param end the end of the buffer
+ *\param bytes the number of bytes to take
+ *\return the position of the bytes taken
+*/
+inline const unsigned char* takeBytes(const unsigned char*& position, const unsigned char* end, size_t bytes) {
+	if(static_cast<size_t>(end-position)<bytes) {
+		throw std::runtime_error("Truncated binary data");
+	}
+	const unsigned char* taken(position);
+	position+=bytes;
+	return taken;
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include "checkpoint.hpp"
+#include "binaryIo.hpp"
+#include <iostream>
+#include <fstream>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace {
+
+const char magic[8]={'B','R','U','N','C','K','P','1'};	//Magic string at the start of the checkpoints
+const unsigned int version(2);	//Version of the checkpoint format
+const size_t header_size(60);	//Size of the header in bytes
+
+
+//Writing on the disk of the directory of a file, so that a new name of the file survives a crash
+void syncDirectory(const std::string& filename) {
+
+	const size_t separator(filename.find_last_of('/'));
+	const std::string directory(separator==std::string::npos ? "." : (separator==0 ? "/" : filename.substr(0, separator)));
+	const int fd(::open(directory.c_str(), O_RDONLY|O_DIRECTORY));
+	if(fd<0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot open the directory of "+filename);
+	}
+
+	//Some file systems cannot synchronize a directory, their names are then already on the disk
+	const int error((fsync(fd)!=0 and errno!=EINVAL) ? errno : 0);
+	::close(fd);
+	if(error!=0) {
+		throw std::system_error(error, std::generic_category(), "Cannot write the directory of "+filename);
+	}
+}
+
+}
+
+
+//!Method that writes the state of a simulation in a checkpoint file
+void Checkpoint::write(const std::string& filename, double g, double eta, unsigned int long clock, const Network& network) {
+
+	std::vector<unsigned char> buffer(magic, magic+sizeof(magic));
+	appendInteger(buffer, version, 4);
+	appendInteger(buffer, sizeof(long double), 4);
+	appendDouble(buffer, h);
+	appendDouble(buffer, g);
+	appendDouble(buffer, eta);
+	appendInteger(buffer, clock, 8);
+	appendInteger(buffer, network.getSeed(), 4);
+	appendInteger(buffer, 0, 8);	//Size of the state of the network, written below
+	network.saveState(buffer);
+	putInteger(buffer.data()+header_size-8, buffer.size()-header_size, 8);
+
+	//The previous checkpoint is only replaced once the new one is completely on the disk
+	const std::string temporary_filename(filename+".tmp");
+	const int fd(::open(temporary_filename.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644));
+	if(fd<0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot create "+temporary_filename);
+	}
+	int error(0);
+	for(size_t written(0); error==0 and written<buffer.size();) {
+		const ssize_t result(::write(fd, buffer.data()+written, buffer.size()-written));
+		if(result<0 and errno!=EINTR) {
+			error=errno;
+		}
+		written+=(result>0) ? result : 0;
+	}
+	if(error==0 and fsync(fd)!=0) {
+		error=errno;
+	}
+	if(::close(fd)!=0 and error==0) {	//The file is closed even if it could not be written
+		error=errno;
+	}
+	if(error!=0) {
+		std::remove(temporary_filename.c_str());
+		throw std::system_error(error, std::generic_category(), "Cannot write "+temporary_filename);
+	}
+
+	if(std::rename(temporary_filename.c_str(), filename.c_str())!=0) {
+		error=errno;
+		std::remove(temporary_filename.c_str());
+		throw std::system_error(error, std::generic_category(), "Cannot rename "+temporary_filename);
+	}
+	syncDirectory(filename);
+}
+
+
+//!Constructor
+Checkpoint::Checkpoint(const std::string& filename) {
+
+	std::ifstream input_file(filename, std::ios::binary);
+	if(!input_file) {
+		throw std::runtime_error("Cannot open "+filename);
+	}
+	const std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(input_file)), std::istreambuf_iterator<char>());
+
+	if(buffer.size()<header_size or std::memcmp(buffer.data(), magic, sizeof(magic))!=0) {
+		throw std::runtime_error(filename+" is not a checkpoint");
+	}
+	if(getInteger(buffer.data()+8, 4)!=version or getInteger(buffer.data()+12, 4)!=sizeof(long double) or getDouble(buffer.data()+16)!=h) {
+		throw std::runtime_error(filename+" was written by another version of the program");
+	}
+
+	g=getDouble(buffer.data()+24);
+	eta=getDouble(buffer.data()+32);
+	clock=getInteger(buffer.data()+40, 8);
+	seed=getInteger(buffer.data()+48, 4);
+	if(getInteger(buffer.data()+52, 8)!=buffer.size()-header_size) {
+		throw std::runtime_error(filename+" is truncated");
+	}
+	state.assign(buffer.begin()+header_size, buffer.end());
+}
+
+
+//!Getter for the ratio JI/JE of the saved simulation
+double Checkpoint::getG() const {
+	return g;
+}
+
+
+//!Getter for the ratio Nu_ext/Nu_thr of the saved simulation
+double Checkpoint::getEta() const {
+	return eta;
+}
+
+
+//!Getter for the clock of the saved simulation
+unsigned int long Checkpoint::getClock() const {
+	return clock;
+}
+
+
+//!Getter for the seed of the saved network
+unsigned int Checkpoint::getSeed() const {
+	return seed;
+}
+
+
+//!Method that gives the saved state to a network
+void Checkpoint::restore(Network& network) const {
+
+	const unsigned char* position(state.data());
+	network.loadState(position, state.data()+state.size());
+	if(position!=state.data()+state.size()) {
+		throw std::runtime_error("The checkpoint contains more than the state of the network");
+	}
+}
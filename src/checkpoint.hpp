@@ -0,0 +1,91 @@
+//! Checkpoint class
+/*!To save the complete state of a simulation in a file, so that it can be continued later exactly as if it had not stopped
+ *
+ * The file contains (little-endian) :
+ * - the magic string "BRUNCKP1", the format version and the size of a long double (uint32)
+ * - h, g and eta (double)
+ * - the clock of the simulation (uint64), the seed of the network (uint32) and the size of the state of the network (uint64)
+ * - the state of the network (see Network::saveState)
+ *
+ * The connections are not stored : they are created again from the seed, and verified with their checksum.
+ */
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#include "network.hpp"
+#include <string>
+#include <vector>
+
+
+
+class Checkpoint {
+
+	public :
+
+	//!Method that writes the state of a simulation in a checkpoint file
+	/*!
+	 * the file is written under a temporary name, synchronized with the disk, then renamed and its directory synchronized,
+	 * so that an interrupted writing never replaces the previous checkpoint (the temporary file is removed on an error)
+	 *\param filename the name of the checkpoint file
+	 *\param g the value of the ratio JI/JE
+	 *\param eta the value of the ratio Nu_ext/Nu_thr
+	 *\param clock the clock of the simulation
+	 *\param network the network of the simulation
+	*/
+	static void write(const std::string& filename, double g, double eta, unsigned int long clock, const Network& network);
+
+
+	//!Constructor
+	/*!
+	 * reads a checkpoint file (std::runtime_error is thrown if it is not a valid checkpoint of this program)
+	 *\param filename the name of the checkpoint file
+	*/
+	Checkpoint(const std::string& filename);
+
+
+	//!Getter for the ratio JI/JE of the saved simulation
+	/*!
+	 *\return the value of g
+	*/
+	double getG() const;
+
+
+	//!Getter for the ratio Nu_ext/Nu_thr of the saved simulation
+	/*!
+	 *\return the value of eta
+	*/
+	double getEta() const;
+
+
+	//!Getter for the clock of the saved simulation
+	/*!
+	 *\return the number of steps done before the checkpoint
+	*/
+	unsigned int long getClock() const;
+
+
+	//!Getter for the seed of the saved network
+	/*!
+	 *\return the seed with which the network must be created before being restored
+	*/
+	unsigned int getSeed() const;
+
+
+	//!Method that gives the saved state to a network
+	/*!
+	 *\param network a network created with the same parameters and the seed of the checkpoint
+	*/
+	void restore(Network& network) const;
+
+
+
+	private :
+
+	double g;	//!Value of the ratio JI/JE
+	double eta;	//!Value of the ratio Nu_ext/Nu_thr
+	unsigned int long clock;	//!Clock of the simulation
+	unsigned int seed;	//!Seed of the network
+	std::vector<unsigned char> state;	//!State of the network
+
+};
+
+#endif
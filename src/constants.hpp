@@ -4,7 +4,7 @@
 
 constexpr double h = 0.1;	//!Time step for the simulation 
 constexpr double delay = 1.5;	//!Synaptic delay in ms
-static int delay_steps(static_cast<unsigned long> (delay/h)); //!Synaptic delay in steps
+constexpr int delay_steps = static_cast<int> (delay/h); //!Synaptic delay in steps
 constexpr double TAU = 20.0;		//!Membrane time constant
 constexpr double RESISTANCE = 20;	//!Membrane resistance
 constexpr double Tref= 2.0; 	//!Refractory time in ms
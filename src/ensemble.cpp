@@ -0,0 +1,123 @@
+#include "ensemble.hpp"
+#include "spikeFile.hpp"
+#include "statisticsRecorder.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+//!Constructor
+Ensemble::Ensemble(double time_, unsigned int seed_, unsigned int long nbr_excitatory_, unsigned int long nbr_inhibitory_,
+				   unsigned int processes_)
+: time(time_), seed(seed_),
+  size(NetworkSize {nbr_excitatory_, nbr_inhibitory_, static_cast<unsigned int long>(CE), static_cast<unsigned int long>(CI)}),
+  processes(processes_>0 ? processes_ : std::max(1u, std::thread::hardware_concurrency()))
+{}
+
+
+//!Method that adds a trial to the ensemble
+void Ensemble::addTrial(const Trial& trial) {
+	trials.push_back(trial);
+}
+
+
+//!Setter for the size of the network
+void Ensemble::setNetworkSize(const NetworkSize& size_) {
+	checkNetworkSize(size_);
+	size=size_;
+}
+
+
+//!Method that runs all the trials, each one in its own process
+std::vector<int> Ensemble::run(const Worker& worker) {
+
+	std::vector<int> statuses(trials.size(), -1);
+	if(trials.empty()) {
+		return statuses;
+	}
+
+	//The connections are created once, before the processes are created
+	Network network(size, trials.front().eta, trials.front().g/JE, seed);
+	std::cout<<"Connections : done"<<std::endl;
+
+	std::map<pid_t, size_t> running;	//Trial run by each process
+	size_t next(0);
+	while(next<trials.size() or !running.empty()) {
+
+		if(next<trials.size() and running.size()<processes) {
+
+			//The buffers are emptied, so that the processes do not write them again
+			std::cout.flush();
+			std::cerr.flush();
+
+			const pid_t pid(fork());
+			if(pid<0) {
+				throw std::system_error(errno, std::generic_category(), "Cannot create the process of a trial");
+			}
+
+			if(pid==0) {
+				//Process of the trial : only the pages of the network that it writes are copied
+				const Trial& trial(trials[next]);
+				int status(0);
+				try {
+					network.setParameters(trial.eta, trial.g/JE);
+					network.reseedNoise(trial.noise_seed);
+					Simulation simulation(trial.time>0.0 ? trial.time : time, trial.g, trial.eta);
+					worker(trial, simulation, network);
+				} catch(const std::exception& error) {
+					std::cerr<<trial.name<<" : "<<error.what()<<std::endl;
+					status=1;
+				}
+				std::cout.flush();
+				std::cerr.flush();
+				_exit(status);
+			}
+
+			running[pid]=next;
+			++next;
+			continue;
+		}
+
+		int status;
+		const pid_t pid(waitpid(-1, &status, 0));
+		if(pid<0) {
+			if(errno==EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), "Cannot wait for the processes of the trials");
+		}
+
+		const auto process(running.find(pid));
+		if(process==running.end()) {
+			continue;
+		}
+		statuses[process->second]=WIFEXITED(status) ? WEXITSTATUS(status) : 128+WTERMSIG(status);
+		std::cout<<"Ensemble : "<<trials[process->second].name<<(statuses[process->second]==0 ? " done" : " failed")<<std::endl;
+		running.erase(process);
+	}
+
+	return statuses;
+}
+
+
+//!Default worker : records the spikes of the trial in name.bin and displays its statistics
+void Ensemble::recordTrial(const Trial& trial, Simulation& simulation, Network& network) {
+
+	BinarySpikeRecorder recorder(trial.name+".bin");
+	StatisticsRecorder statistics_recorder(1.0, 0.0, false);
+	simulation.addRecorder(&recorder);
+	simulation.addRecorder(&statistics_recorder);
+	simulation.run(network);
+
+	const NetworkStatistics statistics(statistics_recorder.getStatistics());
+	std::cout<<trial.name<<" : rate "<<statistics.rate<<" Hz, CV "<<statistics.cv<<", Fano factor "<<statistics.fano_factor
+			 <<", synchrony "<<statistics.synchrony<<", regime "<<statistics.regime<<std::endl;
+}
@@ -0,0 +1,99 @@
+//! Ensemble class
+/*!To run several simulations with the same connections, in parallel processes
+ *
+ * The network is created once, then each trial runs in a process created with fork() :
+ * the pages of the connections are shared by all the processes (copy-on-write, they are never written),
+ * so that the trials need the memory of about one network and do not create the connections again.
+ */
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+#include "network.hpp"
+#include "simulation.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+
+
+//!Parameters of a trial of an ensemble
+struct Trial {
+
+	double g;	//!Value of g=JI/JE
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	unsigned int noise_seed;	//!Seed of the background noise
+	std::string name;	//!Name of the trial, used as prefix of its files
+	double time;	//!Simulation time of the trial in ms (0 for the time of the ensemble)
+
+};
+
+
+
+class Ensemble {
+
+	public :
+
+	//!Function run by the process of a trial
+	/*!
+	 * it adds the recorders of the trial to the simulation and calls simulation.run(network)
+	*/
+	typedef std::function<void(const Trial& trial, Simulation& simulation, Network& network)> Worker;
+
+
+	//!Constructor
+	/*!
+	 *\param time_ the simulation time in ms of the trials that do not have their own
+	 *\param seed_ the seed of the connections of the network (0 to draw one)
+	 *\param nbr_excitatory_ the number of excitatory neurons of the network
+	 *\param nbr_inhibitory_ the number of inhibitory neurons of the network
+	 *\param processes_ the number of trials run at the same time (0 for the number of cores)
+	*/
+	Ensemble(double time_, unsigned int seed_=0, unsigned int long nbr_excitatory_=NE, unsigned int long nbr_inhibitory_=NI,
+			 unsigned int processes_=0);
+
+
+	//!Method that adds a trial to the ensemble
+	/*!
+	 *\param trial the parameters of the trial
+	*/
+	void addTrial(const Trial& trial);
+
+
+	//!Setter for the size of the network
+	/*!
+	 * replaces the numbers of neurons given to the constructor, and the numbers of connections CE and CI
+	 * throws std::invalid_argument if the size is not valid (see checkNetworkSize)
+	 *\param size_ the numbers of neurons and of connections of the network
+	*/
+	void setNetworkSize(const NetworkSize& size_);
+
+
+	//!Method that runs all the trials, each one in its own process
+	/*!
+	 *\param worker the function that records and runs a trial (by default, the spikes are written in name.bin
+	 * and the statistics of the network are displayed)
+	 *\return the exit status of each trial (0 if it succeeded)
+	*/
+	std::vector<int> run(const Worker& worker=recordTrial);
+
+
+	//!Default worker : records the spikes of the trial in name.bin and displays its statistics
+	/*!
+	 *\param trial the parameters of the trial
+	 *\param simulation the simulation of the trial
+	 *\param network the network of the trial
+	*/
+	static void recordTrial(const Trial& trial, Simulation& simulation, Network& network);
+
+
+
+	private :
+
+	double time;	//!Simulation time in ms of the trials that do not have their own
+	unsigned int seed;	//!Seed of the connections
+	NetworkSize size;	//!Numbers of neurons and of connections of the network
+	unsigned int processes;	//!Number of trials run at the same time
+	std::vector<Trial> trials;	//!Trials of the ensemble
+
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "eventNetwork.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+const double rescaling_time(100.0);	//Largest time from the reference to the end of a step in ms (scale below exp(5))
+
+}
+
+
+//!Constructor
+EventNetwork::EventNetwork(const Network& network, double eta_, double g_, unsigned int noise_seed)
+: eta(eta_), g(g_), clock(0), nbrNeurons(network.getNbrNeurons()), nbrExcitatory(network.getNbrExcitatory()), nbrEvents(0),
+  background_rate(nbrNeurons*eta_*V_thr/(J*TAU)), next_background(0.0), reference(0.0),
+  offsets(1, 0), states(nbrNeurons, State {0.0, -Tref})
+{
+	if(!(eta>0.0)) {
+		throw std::invalid_argument("The event-driven network needs a strictly positive eta");
+	}
+
+	//The targets of all the neurons are stored contiguously
+	for(unsigned int long i(0); i<nbrNeurons; ++i) {
+		for(auto target : network.getNeuron(i).getTargets()) {
+			targets.push_back(target);
+		}
+		offsets.push_back(targets.size());
+	}
+
+	std::seed_seq sequence {noise_seed, 1u};
+	noise_gen.seed(sequence);
+	next_background=drawInterval();
+}
+
+
+//!Getter for the clock of the network
+unsigned int long EventNetwork::getClock() const {
+	return clock;
+}
+
+
+//!Getter for the number of neurons of the network
+unsigned int long EventNetwork::getNbrNeurons() const {
+	return nbrNeurons;
+}
+
+
+//!Getter for the number of events processed
+unsigned int long EventNetwork::getNbrEvents() const {
+	return nbrEvents;
+}
+
+
+//!Getter for the neurons that spiked during the last step
+const std::vector<unsigned int long>& EventNetwork::getSpikes() const {
+	return spikes;
+}
+
+
+//!Getter for the times of the spikes of the last step
+const std::vector<double>& EventNetwork::getSpikeTimes() const {
+	return spike_times;
+}
+
+
+//!Method that processes the events of the next step of h
+void EventNetwork::update() {
+
+	const double end((clock+1)*h);
+	step_spikes.clear();
+
+	//The scale of the potentials grows as exp(t/TAU) : the reference moves forward before it becomes large
+	if(end-reference>rescaling_time) {
+		const double factor(std::exp(-(clock*h-reference)/TAU));
+		for(auto& state : states) {
+			state.scaled_potential*=factor;
+		}
+		reference=clock*h;
+	}
+
+	//The earliest of the next spike of the network and the next background spike, until the end of the step
+	while(true) {
+		if(!deliveries.empty() and deliveries.front().time<=next_background) {
+			const Delivery delivery(deliveries.front());
+			if(delivery.time>=end) {
+				break;
+			}
+			deliveries.pop_front();
+			const double weight(J*(delivery.source<nbrExcitatory ? JE : static_cast<int>(-g/JE)));
+			const double growth(std::exp((delivery.time-reference)/TAU));
+			for(unsigned int long j(offsets[delivery.source]); j<offsets[delivery.source+1]; ++j) {
+				receive(targets[j], delivery.time, growth, weight);
+			}
+		} else {
+			const double time(next_background);
+			if(time>=end) {
+				break;
+			}
+			//Neuron drawn uniformly from a 32 bits number
+			const unsigned int long neuron((static_cast<std::uint64_t>(noise_gen())*nbrNeurons)>>32);
+			next_background=time+drawInterval();
+			receive(neuron, time, std::exp((time-reference)/TAU), J*JE);
+		}
+	}
+
+	//The spikes are given in the order of the neurons, like Network
+	std::sort(step_spikes.begin(), step_spikes.end());
+	spikes.clear();
+	spike_times.clear();
+	for(const auto& spike : step_spikes) {
+		spikes.push_back(spike.first);
+		spike_times.push_back(spike.second);
+	}
+
+	++clock;
+}
+
+
+//!Method that runs the network and gives its spikes to recorders
+void EventNetwork::run(unsigned int long steps, const std::vector<Recorder*>& recorders) {
+
+	const RunInfo info {h, g, eta, steps, nbrNeurons, nbrExcitatory, 0};
+	for(auto recorder : recorders) {
+		recorder->open(info);
+	}
+
+	for(unsigned int long i(0); i<steps; ++i) {
+		const unsigned int long current(clock);
+		update();
+		for(auto recorder : recorders) {
+			recorder->record(current, spikes);
+		}
+	}
+
+	for(auto recorder : recorders) {
+		recorder->close();
+	}
+}
+
+
+//!Method that gives an input to a neuron
+void EventNetwork::receive(unsigned int long neuron, double time, double growth, double weight) {
+
+	++nbrEvents;
+
+	//The inputs of the refractory period are lost (the potential stays at 0 until its end)
+	State& state(states[neuron]);
+	if(time<state.refractory_end) {
+		return;
+	}
+
+	state.scaled_potential+=weight*growth;
+	if(state.scaled_potential>V_thr*growth) {
+		step_spikes.push_back(std::make_pair(neuron, time));
+		state.scaled_potential=0.0;
+		state.refractory_end=time+Tref;
+		deliveries.push_back(Delivery {time+delay, static_cast<std::uint32_t>(neuron)});
+	}
+}
+
+
+//!Method that draws the time until the next background spike of the network
+double EventNetwork::drawInterval() {
+	const double uniform((noise_gen()+0.5)/4294967296.0);	//In ]0, 1[
+	return -std::log(uniform)/background_rate;
+}
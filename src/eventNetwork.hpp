@@ -0,0 +1,155 @@
+//! EventNetwork class
+/*!To simulate the network event by event, with a work proportional to the number of inputs instead of the number of steps
+ *
+ * Between two inputs, the potential of a neuron only decays, so that a neuron is only updated when it receives an input :
+ * its potential is decayed exactly since its last input, the input is added, and it spikes if it crosses the threshold.
+ * The potential V(t) is stored as V(t)*exp((t-reference)/TAU), which does not change while it decays : an input at the
+ * time t adds its weight times exp((t-reference)/TAU), computed once for all the targets of a spike, and the threshold
+ * is V_thr*exp((t-reference)/TAU).
+ * The inputs are the spikes of the network, which reach all the targets of a neuron one delay after its spike, and the
+ * background spikes, which form a Poisson process for each neuron.
+ *
+ * The events are processed in the order of their times. The delay being the same for all the connections, the spikes of
+ * the network reach their targets in the order in which they happened : they wait in a queue (first in, first out). The
+ * background spikes of all the neurons together form one Poisson process of rate nbrNeurons times the rate of a neuron,
+ * each of its spikes going to a neuron drawn uniformly : its next spike is drawn as an exponential inter-arrival time.
+ * The next event is then the earliest of the two, without a priority queue ordering one event per neuron.
+ *
+ * The work does not depend on the time step : it suits the regimes of low drive (small eta) and low rates, where the
+ * neurons receive few inputs, while Network updates all the neurons at each step.
+ * The connections and the weights are those of the Network given to the constructor.
+ */
+#ifndef EVENTNETWORK_H
+#define EVENTNETWORK_H
+#include "network.hpp"
+#include "recorder.hpp"
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+
+
+class EventNetwork {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * copies the connections of a network, and starts with all the potentials at 0
+	 * throws std::invalid_argument if eta is not strictly positive
+	 *\param network the network whose connections are used
+	 *\param eta_ the value of eta=Nu_ext/Nu_thr
+	 *\param g_ the value of g=JI/JE
+	 *\param noise_seed the seed of the background noise
+	*/
+	EventNetwork(const Network& network, double eta_, double g_, unsigned int noise_seed=1);
+
+
+	//!Getter for the clock of the network
+	/*!
+	 *\return the number of steps of h done
+	*/
+	unsigned int long getClock() const;
+
+
+	//!Getter for the number of neurons of the network
+	/*!
+	 *\return the number of neurons
+	*/
+	unsigned int long getNbrNeurons() const;
+
+
+	//!Getter for the number of events processed
+	/*!
+	 *\return the number of inputs received by the neurons since the start (background spikes and spikes of the network)
+	*/
+	unsigned int long getNbrEvents() const;
+
+
+	//!Getter for the neurons that spiked during the last step
+	/*!
+	 *\return the numbers of the neurons that spiked, in increasing order
+	*/
+	const std::vector<unsigned int long>& getSpikes() const;
+
+
+	//!Getter for the times of the spikes of the last step
+	/*!
+	 *\return the time in ms of each spike of getSpikes()
+	*/
+	const std::vector<double>& getSpikeTimes() const;
+
+
+	//!Method that processes the events of the next step of h
+	void update();
+
+
+	//!Method that runs the network and gives its spikes to recorders
+	/*!
+	 * the recorders receive the spikes of each step of h
+	 *\param steps the number of steps to run
+	 *\param recorders the recorders of the spikes
+	*/
+	void run(unsigned int long steps, const std::vector<Recorder*>& recorders);
+
+
+
+	private :
+
+	//!Spike of the network waiting to reach its targets
+	struct Delivery {
+
+		double time;	//!Time of the arrival in ms
+		std::uint32_t source;	//!Number of the neuron that spiked
+
+	};
+
+
+	//!State of a neuron
+	struct State {
+
+		double scaled_potential;	//!Potential at the time t times exp((t-reference)/TAU), which does not change between inputs
+		double refractory_end;	//!Time at which the neuron leaves its refractory period in ms
+
+	};
+
+
+	//!Method that gives an input to a neuron
+	/*!
+	 *\param neuron the number of the neuron
+	 *\param time the time of the input in ms
+	 *\param growth exp((time-reference)/TAU), the same for all the targets of a spike
+	 *\param weight the jump of the potential in mV
+	*/
+	void receive(unsigned int long neuron, double time, double growth, double weight);
+
+
+	//!Method that draws the time until the next background spike of the network
+	/*!
+	 *\return an exponential inter-arrival time in ms
+	*/
+	double drawInterval();
+
+
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	double g;	//!Value of g=JI/JE
+	unsigned int long clock;	//!Number of steps of h done
+	unsigned int long nbrNeurons;	//!Number of neurons
+	unsigned int long nbrExcitatory;	//!Number of excitatory neurons
+	unsigned int long nbrEvents;	//!Number of inputs received by the neurons
+	double background_rate;	//!Rate of the background spikes of the whole network in spikes per ms
+	double next_background;	//!Time of the next background spike in ms
+	double reference;	//!Time from which the potentials are scaled in ms (moved forward so that the scale stays small)
+	std::vector<unsigned int long> offsets;	//!Position of the targets of each neuron in targets
+	std::vector<std::uint32_t> targets;	//!Targets of all the neurons
+	std::vector<State> states;	//!State of each neuron
+	std::deque<Delivery> deliveries;	//!Spikes of the network that did not reach their targets yet, in the order of their times
+	std::vector<std::pair<unsigned int long, double> > step_spikes;	//!Neuron and time of the spikes of the current step
+	std::vector<unsigned int long> spikes;	//!Neurons that spiked during the last step
+	std::vector<double> spike_times;	//!Times of the spikes of the last step
+	std::mt19937 noise_gen;	//!Random generator of the background noise
+
+};
+
+#endif
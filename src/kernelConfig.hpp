@@ -0,0 +1,192 @@
+//! ConstantsConfig and RuntimeConfig classes
+/*!To give the sizes of the network and the parameters of the update of the neurons to the batch kernel (BatchNetwork,
+ * the only engine templated on a configuration : Network, Neuron and the other engines read the sizes at run time)
+ *
+ * ConstantsConfig gives the values of constants.hpp as constant expressions : the compiler folds the size of the
+ * buffers, the number of neurons and the refractory period into the code of the kernel, which then only accepts
+ * networks of the sizes of constants.hpp. RuntimeConfig gives the same values read from any network at run time.
+ * Both have the same interface, so that the kernel calls config.nbrNeurons() without knowing which one it has.
+ */
+#ifndef KERNELCONFIG_H
+#define KERNELCONFIG_H
+#include "constants.hpp"
+#include "network.hpp"
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+
+
+class ConstantsConfig {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * throws std::invalid_argument if the network does not have the numbers of neurons of constants.hpp
+	 *\param network the network simulated by the engine
+	*/
+	explicit ConstantsConfig(const Network& network) {
+		if(network.getNbrNeurons()!=nbrNeurons() or network.getNbrExcitatory()!=nbrExcitatory()) {
+			throw std::invalid_argument("The network does not have the numbers of neurons of constants.hpp");
+		}
+	}
+
+
+	//!Getter for the number of neurons
+	/*!
+	 *\return N
+	*/
+	static constexpr unsigned int long nbrNeurons() {
+		return NE+NI;
+	}
+
+
+	//!Getter for the number of excitatory neurons
+	/*!
+	 *\return NE, the excitatory neurons being the first ones
+	*/
+	static constexpr unsigned int long nbrExcitatory() {
+		return NE;
+	}
+
+
+	//!Getter for the delay in steps
+	/*!
+	 *\return delay_steps
+	*/
+	static constexpr unsigned int long delaySteps() {
+		return delay_steps;
+	}
+
+
+	//!Getter for the number of steps stored in the buffers
+	/*!
+	 *\return delay_steps+1
+	*/
+	static constexpr unsigned int long ringSize() {
+		return delay_steps+1;
+	}
+
+
+	//!Getter for the duration of the refractory period in steps
+	/*!
+	 *\return the number of steps of h shorter than Tref, with the test of Neuron::isRefractory
+	*/
+	static constexpr std::int64_t refractorySteps() {
+		return stepsFrom(0);
+	}
+
+
+	//!Getter for the decay of the potential during a step
+	/*!
+	 * computed at run time by std::exp, which is not a constant expression, like RuntimeConfig so that both give the same
+	   potentials (BatchNetwork calls it once per step)
+	 *\return exp(-h/TAU)
+	*/
+	static double decay() {
+		return std::exp(-h/TAU);
+	}
+
+
+
+	private :
+
+	//!Method that counts the steps of the refractory period from a number of steps
+	/*!
+	 *\param steps the number of steps already counted
+	 *\return the first number of steps, from steps, that is not shorter than Tref
+	*/
+	static constexpr std::int64_t stepsFrom(std::int64_t steps) {
+		return (steps*h<Tref) ? stepsFrom(steps+1) : steps;
+	}
+
+};
+
+
+
+class RuntimeConfig {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param network the network simulated by the engine
+	*/
+	explicit RuntimeConfig(const Network& network)
+	: nbr_neurons(network.getNbrNeurons()), nbr_excitatory(network.getNbrExcitatory()), nbr_delay_steps(delay_steps),
+	  refractory_steps(0), step_decay(std::exp(-h/TAU))
+	{
+		//Same test as Neuron::isRefractory : the neuron is refractory while (clock-last spike)*h<Tref
+		while(refractory_steps*h<Tref) {
+			++refractory_steps;
+		}
+	}
+
+
+	//!Getter for the number of neurons
+	/*!
+	 *\return the number of neurons of the network
+	*/
+	unsigned int long nbrNeurons() const {
+		return nbr_neurons;
+	}
+
+
+	//!Getter for the number of excitatory neurons
+	/*!
+	 *\return the number of excitatory neurons, which are the first ones
+	*/
+	unsigned int long nbrExcitatory() const {
+		return nbr_excitatory;
+	}
+
+
+	//!Getter for the delay in steps
+	/*!
+	 *\return the delay in steps
+	*/
+	unsigned int long delaySteps() const {
+		return nbr_delay_steps;
+	}
+
+
+	//!Getter for the number of steps stored in the buffers
+	/*!
+	 *\return the delay in steps plus one
+	*/
+	unsigned int long ringSize() const {
+		return nbr_delay_steps+1;
+	}
+
+
+	//!Getter for the duration of the refractory period in steps
+	/*!
+	 *\return the number of steps of h shorter than Tref
+	*/
+	std::int64_t refractorySteps() const {
+		return refractory_steps;
+	}
+
+
+	//!Getter for the decay of the potential during a step
+	/*!
+	 *\return exp(-h/TAU)
+	*/
+	double decay() const {
+		return step_decay;
+	}
+
+
+
+	private :
+
+	unsigned int long nbr_neurons;	//!Number of neurons
+	unsigned int long nbr_excitatory;	//!Number of excitatory neurons
+	unsigned int long nbr_delay_steps;	//!Delay in steps
+	std::int64_t refractory_steps;	//!Duration of the refractory period in steps
+	double step_decay;	//!Decay of the potential during a step
+
+};
+
+#endif
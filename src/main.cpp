@@ -1,27 +1,216 @@
 #include "neuron.hpp"
 #include "network.hpp"
 #include "simulation.hpp"
+#include "spikeFile.hpp"
+#include "asyncRecorder.hpp"
+#include "statisticsRecorder.hpp"
+#include "options.hpp"
+#include "runSummary.hpp"
 #include <iostream>
 #include <vector>
+#include <chrono>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
 
 
 
-int main () {
-	
-	//Creation of the oftream output_file and opening
-	std::ofstream output_file;
-	output_file.open("spikes.txt");
-	
-	//Instanciation and running of the simulation
-	Simulation simulation;
-	simulation.run(output_file); 
-	
+int main (int argc, char** argv) {
+
+	if(argc>1 and (std::string(argv[1])=="--help" or std::string(argv[1])=="-h")) {
+		std::cerr<<"Usage : "<<argv[0]<<" [options]"<<std::endl;
+		std::cerr<<"Simulates the network. Without --time, --g and --eta, they are asked on the terminal (only when the standard"<<std::endl;
+		std::cerr<<"input is a terminal, so that a job never waits for an answer)"<<std::endl;
+		std::cerr<<"  --config file                    reads the options of a file, one line \"name = value\" per option"<<std::endl;
+		std::cerr<<"  --time time_ms                   simulation time"<<std::endl;
+		std::cerr<<"  --g g                            value of g=JI/JE"<<std::endl;
+		std::cerr<<"  --eta eta                        value of eta=Nu_ext/Nu_thr"<<std::endl;
+		std::cerr<<"  --seed seed                      seed of the connections and of the background noise (default : drawn)"<<std::endl;
+		std::cerr<<"  --excitatory count               number of excitatory neurons (default : 10000)"<<std::endl;
+		std::cerr<<"  --inhibitory count               number of inhibitory neurons (default : 2500)"<<std::endl;
+		std::cerr<<"  --connections-excitatory count   excitatory connections received by each neuron (default : 1000)"<<std::endl;
+		std::cerr<<"  --connections-inhibitory count   inhibitory connections received by each neuron (default : 250)"<<std::endl;
+		std::cerr<<"  --spikes file                    binary spike file of the raster (default : spikes.bin)"<<std::endl;
+		std::cerr<<"  --raster-neurons count           number of neurons of the raster, from the first one (default : 50)"<<std::endl;
+		std::cerr<<"  --rates file                     numbers of spikes of each population per bin (default : rates.txt)"<<std::endl;
+		std::cerr<<"  --rate-bin width_ms              width of the bins of the rates (default : 1)"<<std::endl;
+		std::cerr<<"  --summary file                   JSON summary of the parameters, timings and statistics of the run"<<std::endl;
+		std::cerr<<"  --checkpoint file                checkpoint written during the run and at its end (see checkpoint.hpp)"<<std::endl;
+		std::cerr<<"  --checkpoint-interval time_ms    time between two checkpoints (default : only at the end of the run)"<<std::endl;
+		std::cerr<<"  --restore file                   continues the run of a checkpoint, with the same g and eta and a longer time"<<std::endl;
+		std::cerr<<"  --warm-start file                starts from the state of a checkpoint, the clock starting at 0"<<std::endl;
+		std::cerr<<"  --noise-seed seed                seed of the background noise of a warm start (default : the one of the checkpoint)"<<std::endl;
+		std::cerr<<"Any of the following options stops the run early when a condition is met (see stopMonitor.hpp), 0 disabling a condition :"<<std::endl;
+		std::cerr<<"  --stop-window width_ms           width of the windows over which the rate is measured (default : 10)"<<std::endl;
+		std::cerr<<"  --stop-min-time time_ms          time before which the conditions are not evaluated (default : 0)"<<std::endl;
+		std::cerr<<"  --quiescence-rate rate_Hz        rate below which the network is quiescent (default : 0.1)"<<std::endl;
+		std::cerr<<"  --quiescence-time time_ms        time during which the network must stay quiescent (default : 50)"<<std::endl;
+		std::cerr<<"  --saturation-fraction fraction   fraction of 1/Tref above which the network is saturated (default : 0.5)"<<std::endl;
+		std::cerr<<"  --saturation-time time_ms        time during which the network must stay saturated (default : 50)"<<std::endl;
+		std::cerr<<"  --convergence-tolerance change   relative change of the statistics below which they converged (default : 0.01)"<<std::endl;
+		std::cerr<<"  --convergence-windows count      consecutive windows in which the statistics must converge (default : 10)"<<std::endl;
+		return 1;
+	}
+
+	const auto start(std::chrono::steady_clock::now());
+	RunSummary summary {false, "", 0.0, 0.0, 0.0, 0, defaultNetworkSize(), 0.0, 0.0, 0.0, 0, "none",
+						NetworkStatistics {NAN, NAN, 0, NAN, NAN, 0, ""}, 0};
+	std::string summary_filename;
+
+	try {
+
+		//All the options are read and verified before anything is created
+		const std::vector<std::string> stop_names({"stop-window", "stop-min-time", "quiescence-rate", "quiescence-time",
+												   "saturation-fraction", "saturation-time", "convergence-tolerance", "convergence-windows"});
+		std::vector<std::string> names({"time", "g", "eta", "seed", "excitatory", "inhibitory", "connections-excitatory", "connections-inhibitory",
+										"spikes", "raster-neurons", "rates", "rate-bin", "summary", "checkpoint", "checkpoint-interval",
+										"restore", "warm-start", "noise-seed"});
+		names.insert(names.end(), stop_names.begin(), stop_names.end());
+		Options options(names);
+		options.parse(argc, argv);
+		summary_filename=options.getString("summary", "");
+
+		//The size of the network is given without compiling again
+		NetworkSize& size(summary.size);
+		size=NetworkSize {options.getInteger("excitatory", size.nbr_excitatory), options.getInteger("inhibitory", size.nbr_inhibitory),
+						  options.getInteger("connections-excitatory", size.connections_excitatory),
+						  options.getInteger("connections-inhibitory", size.connections_inhibitory)};
+		checkNetworkSize(size);
+
+		const unsigned int long raster_neurons(options.getInteger("raster-neurons", 50));
+		if(raster_neurons>size.nbr_excitatory+size.nbr_inhibitory) {
+			throw std::invalid_argument("The raster has "+std::to_string(raster_neurons)+" neurons, more than the "
+										+std::to_string(size.nbr_excitatory+size.nbr_inhibitory)+" neurons of the network (see --raster-neurons)");
+		}
+		const double rate_bin(options.getDouble("rate-bin", 1.0));
+		if(!(rate_bin>0.0)) {
+			throw std::invalid_argument("The width of the bins of the rates must be strictly positive");
+		}
+
+		if(options.has("checkpoint-interval") and !options.has("checkpoint")) {
+			throw std::invalid_argument("The option --checkpoint-interval needs --checkpoint");
+		}
+		if(options.has("restore") and options.has("warm-start")) {
+			throw std::invalid_argument("The options --restore and --warm-start can not be given together");
+		}
+		if(options.has("noise-seed") and !options.has("warm-start")) {
+			throw std::invalid_argument("The option --noise-seed needs --warm-start");
+		}
+		const unsigned int noise_seed(options.getSeed("noise-seed", 0));
+
+		//The stop conditions that are not given keep their default values
+		bool early_stop(false);
+		for(const auto& name : stop_names) {
+			early_stop=early_stop or options.has(name);
+		}
+		const StopConditions defaults(defaultStopConditions());
+		const unsigned int long convergence_windows(options.getInteger("convergence-windows", defaults.convergence_windows));
+		if(convergence_windows>std::numeric_limits<unsigned int>::max()) {
+			throw std::invalid_argument("The number of windows of the convergence is too large");
+		}
+		const StopConditions conditions {options.getDouble("stop-window", defaults.window), options.getDouble("stop-min-time", defaults.min_time),
+										 options.getDouble("quiescence-rate", defaults.quiescence_rate),
+										 options.getDouble("quiescence-time", defaults.quiescence_time),
+										 options.getDouble("saturation-fraction", defaults.saturation_fraction),
+										 options.getDouble("saturation-time", defaults.saturation_time),
+										 options.getDouble("convergence-tolerance", defaults.tolerance),
+										 static_cast<unsigned int>(convergence_windows)};
+
+		//A batch run gives the three parameters : the terminal is only used when none is given and a user can answer
+		std::unique_ptr<Simulation> simulation;
+		if(options.has("time") or options.has("g") or options.has("eta")) {
+			for(const std::string name : {"time", "g", "eta"}) {
+				if(!options.has(name)) {
+					throw std::invalid_argument("The option --"+name+" is missing (--time, --g and --eta go together)");
+				}
+			}
+			summary.time=options.getDouble("time", 0.0);
+			summary.g=options.getDouble("g", 0.0);
+			summary.eta=options.getDouble("eta", 0.0);
+			simulation.reset(new Simulation(summary.time, summary.g, summary.eta));
+		} else if(isatty(STDIN_FILENO)) {
+			simulation.reset(new Simulation());
+			summary.time=simulation->getSimtime()*h;
+		} else {
+			throw std::invalid_argument("The standard input is not a terminal : give --time, --g and --eta (or a configuration file)");
+		}
+		simulation->setNetworkSize(size);
+		simulation->setSeed(options.getSeed("seed", 0));
+
+		//Without an interval, the checkpoint is only written at the end of the run
+		if(options.has("checkpoint")) {
+			const double interval(options.getDouble("checkpoint-interval", std::max(summary.time, h)));
+			if(!(interval>0.0)) {
+				throw std::invalid_argument("The interval between two checkpoints must be strictly positive");
+			}
+			simulation->setCheckpoints(options.getString("checkpoint", ""), interval);
+		}
+		if(options.has("restore")) {
+			simulation->restore(options.getString("restore", ""));
+		} else if(options.has("warm-start")) {
+			simulation->warmStart(options.getString("warm-start", ""), noise_seed);
+		}
+		if(early_stop) {
+			simulation->setStopConditions(conditions);
+		}
+
+		//Creation of the recorder of the spikes in a binary file (see SpikesToText for the text format)
+		//The file is written with io_uring and O_DIRECT when possible, else with pwrite
+		BinarySpikeRecorder recorder(options.getString("spikes", "spikes.bin"), SinkBackend::Uring);
+
+		//The spikes are written by a background thread, so that the simulation never waits for the disk
+		AsyncRecorder async_recorder(recorder);
+
+		//Only the spikes of the first neurons are written (1 to 50 by default), for the raster plots of Fig.8
+		SpikeDevice raster_recorder(async_recorder, NeuronSet::range(0, raster_neurons));
+
+		//The activity of the whole network is recorded as the number of spikes per bin of each population
+		PopulationRateRecorder rate_recorder(options.getString("rates", "rates.txt"), rate_bin);
+
+		//The irregularity and the synchrony of the network are computed without writing anything, and displayed at the end
+		StatisticsRecorder statistics_recorder;
+
+		//Running of the simulation
+		simulation->addRecorder(&raster_recorder);
+		simulation->addRecorder(&rate_recorder);
+		simulation->addRecorder(&statistics_recorder);
+		simulation->run();
+
+		summary.seed=simulation->getNetworkSeed();
+		summary.construction_time=simulation->getConstructionTime();
+		summary.run_time=simulation->getRunTime();
+		summary.steps=simulation->getClock();
+		summary.stop_reason=stopReasonName(simulation->getStopReason());
+		summary.statistics=statistics_recorder.getStatistics();
+		summary.dropped_spikes=async_recorder.getDroppedSpikes();
+		summary.success=true;
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		summary.error=error.what();
+	}
+
+	//The summary is also written for a failed run, so that a script knows why it failed
+	if(!summary_filename.empty()) {
+		const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+		summary.total_time=duration.count();
+		try {
+			writeRunSummary(summary_filename, summary);
+		} catch(const std::exception& error) {
+			std::cerr<<error.what()<<std::endl;
+			return 1;
+		}
+	}
+	if(!summary.success) {
+		return 1;
+	}
+
 	std::cout<<"Simulation : done"<<std::endl;
-	
-	//Closing of the file
-	output_file.close();
-	
+
 	return 0;
 }
@@ -0,0 +1,187 @@
+#include "meanField.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+const double pi(3.14159265358979323846);
+const double V_reset(0.0);	//Potential of a neuron after a spike (see Neuron::update)
+const double subinterval(0.5);	//Largest width of the parts of the Siegert integral
+const unsigned int scan_points(48);	//Number of rates at which Phi(nu)-nu is evaluated to find its roots
+const double lowest_rate(0.01);	//Smallest rate of the scan in Hz, above 0
+
+//Nodes and weights of the Gauss-Legendre quadrature with 8 points on [-1, 1]
+const double nodes[4]={0.1834346424956498, 0.5255324099163290, 0.7966664774136267, 0.9602898564975363};
+const double weights[4]={0.3626837833783620, 0.3137066458778873, 0.2223810344533745, 0.1012285362903763};
+
+
+//Function that computes exp(x^2)*erfc(x) without overflow for large x
+double erfcx(double x) {
+	if(x<25.0) {
+		return std::exp(x*x)*std::erfc(x);
+	}
+	//Asymptotic expansion, exact to 1e-11 from x=25
+	const double inverse(1.0/(2.0*x*x));
+	return (1.0-inverse*(1.0-3.0*inverse*(1.0-5.0*inverse)))/(x*std::sqrt(pi));
+}
+
+
+//Function that computes the integral of exp(u^2)*(1+erf(u)) = erfcx(-u) from lower to upper
+double siegertIntegral(double lower, double upper) {
+
+	const unsigned int parts(std::max(1.0, std::ceil((upper-lower)/subinterval)));
+	const double half((upper-lower)/(2.0*parts));
+	double sum(0.0);
+	for(unsigned int i(0); i<parts; ++i) {
+		const double center(lower+(2*i+1)*half);
+		for(size_t j(0); j<4; ++j) {
+			sum+=weights[j]*(erfcx(-(center-half*nodes[j]))+erfcx(-(center+half*nodes[j])));
+		}
+	}
+	return sum*half;
+}
+
+}
+
+
+//!Function that gives the name of a stability
+std::string stabilityName(MeanFieldStability stability) {
+	switch(stability) {
+		case MeanFieldStability::Runaway :
+			return "runaway";
+		case MeanFieldStability::Oscillatory :
+			return "oscillatory";
+		default :
+			return "stable";
+	}
+}
+
+
+//!Constructor
+MeanField::MeanField(double g_, double eta_, double ce_, double ci_)
+: g(g_), eta(eta_), ce(ce_), ci(ci_), critical_slope(0.0), frequency(0.0)
+{
+	if(!(g>=0.0) or !(eta>=0.0) or !(ce>0.0) or !(ci>=0.0)) {
+		throw std::invalid_argument("The mean field needs g, eta and the numbers of connections positive, CE strictly positive");
+	}
+
+	//The background input of a neuron is eta times the input that reaches the threshold without feedback (see Network)
+	nu_ext=eta*V_thr/(ce*J*TAU)*1000.0;
+
+	//Oscillation of the linearized rate equation : 1+i*w*TAU = s_c*exp(i*(pi-w*delay)), solved for w in ]0, pi/delay[
+	double low(0.0);
+	double high(pi/delay);
+	for(unsigned int i(0); i<100; ++i) {
+		const double omega(0.5*(low+high));
+		if(pi-omega*delay-std::atan(omega*TAU)>0.0) {
+			low=omega;
+		} else {
+			high=omega;
+		}
+	}
+	const double omega(0.5*(low+high));
+	critical_slope=std::sqrt(1.0+omega*omega*TAU*TAU);
+	frequency=omega*1000.0/(2.0*pi);
+}
+
+
+//!Method that computes the mean input of a neuron
+double MeanField::getMu(double rate) const {
+	return ce*J*TAU*(nu_ext+rate*(1.0-g*ci/ce))/1000.0;
+}
+
+
+//!Method that computes the standard deviation of the input of a neuron
+double MeanField::getSigma(double rate) const {
+	return J*std::sqrt(ce*TAU*(nu_ext+rate*(1.0+g*g*ci/ce))/1000.0);
+}
+
+
+//!Method that computes the rate of a neuron whose input comes from a network firing at a given rate
+double MeanField::transfer(double rate) const {
+
+	const double mu(getMu(rate));
+	const double sigma(getSigma(rate));
+
+	//Without fluctuations, the neuron fires only if its mean input is above the threshold
+	if(!(sigma>0.0)) {
+		return (mu>V_thr) ? 1000.0/(Tref+TAU*std::log((mu-V_reset)/(mu-V_thr))) : 0.0;
+	}
+
+	const double integral(siegertIntegral((V_reset-mu)/sigma, (V_thr-mu)/sigma));
+	return 1000.0/(Tref+TAU*std::sqrt(pi)*integral);
+}
+
+
+//!Method that computes the stationary rates of the network
+std::vector<MeanFieldSolution> MeanField::solve() const {
+
+	std::vector<double> rates;
+
+	//A network that does not fire without feedback can stay silent
+	double previous_rate(0.0);
+	double previous(transfer(0.0));
+	if(previous<1e-12) {
+		rates.push_back(0.0);
+		previous=0.0;
+	}
+
+	//The roots of Phi(nu)-nu are bracketed on a logarithmic scale, then refined by bisection
+	//(Phi is smaller than 1/Tref, so that Phi(nu)-nu is negative at the largest rate)
+	const double highest_rate(1000.0/Tref);
+	for(unsigned int i(0); i<=scan_points; ++i) {
+		const double rate(lowest_rate*std::pow(highest_rate/lowest_rate, double(i)/scan_points));
+		const double current(transfer(rate)-rate);
+		if((previous>0.0)!=(current>0.0)) {
+			double low(previous_rate);
+			double high(rate);
+			const bool rising(current>0.0);
+			for(unsigned int j(0); j<60 and high-low>1e-7*high; ++j) {
+				const double middle(0.5*(low+high));
+				if((transfer(middle)-middle>0.0)==rising) {
+					high=middle;
+				} else {
+					low=middle;
+				}
+			}
+			rates.push_back(0.5*(low+high));
+		}
+		previous_rate=rate;
+		previous=current;
+	}
+
+	std::vector<MeanFieldSolution> solutions;
+	for(auto rate : rates) {
+		const double s(slope(rate));
+		const MeanFieldStability stability(s>1.0 ? MeanFieldStability::Runaway :
+										   (s< -critical_slope ? MeanFieldStability::Oscillatory : MeanFieldStability::Stable));
+		solutions.push_back(MeanFieldSolution {rate, getMu(rate), getSigma(rate), s, stability});
+	}
+	return solutions;
+}
+
+
+//!Method that gives the slope below which the solutions oscillate
+double MeanField::getCriticalSlope() const {
+	return critical_slope;
+}
+
+
+//!Method that gives the frequency of the oscillation at the boundary of stability
+double MeanField::getOscillationFrequency() const {
+	return frequency;
+}
+
+
+//!Method that computes the slope of the transfer function
+double MeanField::slope(double rate) const {
+	const double step(std::max(1e-6*rate, 1e-6));
+	if(rate<step) {
+		return (transfer(rate+step)-transfer(rate))/step;
+	}
+	return (transfer(rate+step)-transfer(rate-step))/(2.0*step);
+}
@@ -0,0 +1,137 @@
+//! MeanField class
+/*!To predict the stationary rate of the network without simulating it (Brunel 2000, section 3)
+ *
+ * In the diffusion approximation, the input of a neuron firing at the rate nu of the network has the mean
+ * mu = CE*J*TAU*(nu_ext+nu*(1-g*CI/CE)) and the standard deviation sigma = J*sqrt(CE*TAU*(nu_ext+nu*(1+g*g*CI/CE))),
+ * and a neuron receiving this input fires at the rate given by the Siegert formula
+ * 1/Phi(nu) = Tref + TAU*sqrt(pi)*integral from (V_reset-mu)/sigma to (V_thr-mu)/sigma of exp(u^2)*(1+erf(u)) du,
+ * with V_reset = 0 as in Neuron. The stationary rates are the solutions of Phi(nu) = nu.
+ * The network rounds the inhibitory weight down to an integer number of JE : compare it with the mean field of this g.
+ *
+ * The stability of a solution is that of the rate equation TAU*dnu/dt = -nu+Phi(nu(t-delay)) linearized around it :
+ * with the slope s = dPhi/dnu, the solution is unstable if s > 1 (the rate runs away), or if s < -s_c (the delay makes
+ * the inhibitory feedback oscillate), s_c and the frequency of the oscillation depending only on TAU and delay.
+ * This is a simplification of the analysis of the paper, meant to preview the regimes and to prune sweeps : it finds the
+ * silent and runaway states of the excitation-dominated networks, but with the membrane time constant as time constant
+ * of the rate it underestimates the domain of the fast oscillations (SI fast) of Fig.2.
+ */
+#ifndef MEANFIELD_H
+#define MEANFIELD_H
+#include "constants.hpp"
+#include <string>
+#include <vector>
+
+
+
+//!Stability of a stationary rate
+enum class MeanFieldStability {
+	Stable,	//!Small perturbations vanish
+	Runaway,	//!The rate moves away to another solution (dPhi/dnu > 1)
+	Oscillatory	//!The rate oscillates around the solution (dPhi/dnu < -s_c)
+};
+
+
+//!Function that gives the name of a stability
+/*!
+ *\param stability the stability
+ *\return "stable", "runaway" or "oscillatory"
+*/
+std::string stabilityName(MeanFieldStability stability);
+
+
+//!Stationary solution of the mean field
+struct MeanFieldSolution {
+
+	double rate;	//!Rate of a neuron in Hz
+	double mu;	//!Mean input in mV
+	double sigma;	//!Standard deviation of the input in mV
+	double slope;	//!dPhi/dnu at the solution
+	MeanFieldStability stability;	//!Stability of the solution
+
+};
+
+
+
+class MeanField {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * throws std::invalid_argument if a value is not valid
+	 *\param g_ the value of g=JI/JE (positive)
+	 *\param eta_ the value of eta=Nu_ext/Nu_thr (positive)
+	 *\param ce_ the number of excitatory connections per neuron
+	 *\param ci_ the number of inhibitory connections per neuron
+	*/
+	MeanField(double g_, double eta_, double ce_=CE, double ci_=CI);
+
+
+	//!Method that computes the mean input of a neuron
+	/*!
+	 *\param rate the rate of the network in Hz
+	 *\return mu in mV
+	*/
+	double getMu(double rate) const;
+
+
+	//!Method that computes the standard deviation of the input of a neuron
+	/*!
+	 *\param rate the rate of the network in Hz
+	 *\return sigma in mV
+	*/
+	double getSigma(double rate) const;
+
+
+	//!Method that computes the rate of a neuron whose input comes from a network firing at a given rate
+	/*!
+	 *\param rate the rate of the network in Hz
+	 *\return Phi(rate) in Hz, smaller than 1/Tref
+	*/
+	double transfer(double rate) const;
+
+
+	//!Method that computes the stationary rates of the network
+	/*!
+	 * an excitation-dominated network (g*CI < CE) can have several solutions, an inhibition-dominated one has one
+	 *\return the solutions in increasing order of rate (at least one)
+	*/
+	std::vector<MeanFieldSolution> solve() const;
+
+
+	//!Method that gives the slope below which the solutions oscillate
+	/*!
+	 *\return s_c, the solutions being oscillatory if dPhi/dnu < -s_c
+	*/
+	double getCriticalSlope() const;
+
+
+	//!Method that gives the frequency of the oscillation at the boundary of stability
+	/*!
+	 *\return the frequency in Hz of the oscillation that appears when dPhi/dnu crosses -s_c
+	*/
+	double getOscillationFrequency() const;
+
+
+
+	private :
+
+	//!Method that computes the slope of the transfer function
+	/*!
+	 *\param rate the rate of the network in Hz
+	 *\return dPhi/dnu, by a centered difference (forward at 0)
+	*/
+	double slope(double rate) const;
+
+
+	double g;	//!Value of g=JI/JE
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	double ce;	//!Number of excitatory connections per neuron
+	double ci;	//!Number of inhibitory connections per neuron
+	double nu_ext;	//!Rate of the background neurons in Hz
+	double critical_slope;	//!Slope below which the solutions oscillate
+	double frequency;	//!Frequency of the oscillation at the boundary of stability in Hz
+
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "multimeter.hpp"
+#include "binaryIo.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+const char magic[8]={'B','R','U','N','V','M','0','1'};	//Magic string at the start of the multimeter files
+const unsigned int version(1);	//Version of the multimeter format
+const unsigned int potential_quantity(1);	//Code of the membrane potential in the header
+
+}
+
+
+//!Constructor
+Multimeter::Multimeter(const std::string& filename, const NeuronSet& neurons_, double interval_,
+					   size_t block_samples_, SinkBackend backend)
+: sink(makeSink(filename, backend)), neurons(neurons_), interval(interval_), block_samples(block_samples_), interval_steps(1)
+{
+	if(block_samples==0) {
+		throw std::invalid_argument("A block of the multimeter must hold at least one sample");
+	}
+	values.resize(neurons.size()*block_samples);
+	steps.reserve(block_samples);
+}
+
+
+//!Destructor
+Multimeter::~Multimeter() {
+	if(sink) {
+		try {
+			close();
+		} catch(const std::exception&) {}	//A destructor called during the unwinding of an error must not throw
+	}
+}
+
+
+//!Method called once before the first step of the simulation
+void Multimeter::open(const RunInfo& info) {
+
+	neurons.mask(info.nbrNeurons);	//Verifies that the recorded neurons are in the network
+	interval_steps=std::max(1l, std::lround(interval/info.h));
+	steps.clear();
+
+	buffer.assign(magic, magic+sizeof(magic));
+	appendInteger(buffer, version, 4);
+	appendInteger(buffer, potential_quantity, 4);
+	appendDouble(buffer, info.h);
+	appendInteger(buffer, interval_steps, 8);
+	appendInteger(buffer, neurons.size(), 8);
+	for(auto neuron : neurons.getNeurons()) {
+		appendInteger(buffer, neuron, 8);
+	}
+	sink->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+
+
+//!Method called after each step of the simulation
+void Multimeter::sample(unsigned int long step, const Network& network) {
+
+	if(step%interval_steps!=0) {
+		return;
+	}
+
+	//The value of the neuron i of the set is stored in its column
+	const size_t row(steps.size());
+	const std::vector<unsigned int long>& recorded(neurons.getNeurons());
+	for(size_t i(0); i<recorded.size(); ++i) {
+		values[i*block_samples+row]=network.getNeuron(recorded[i]).getPotential();
+	}
+	steps.push_back(step);
+
+	if(steps.size()==block_samples) {
+		flush();
+	}
+}
+
+
+//!Method that writes the last block and closes the file
+void Multimeter::close() {
+	if(!sink) {
+		return;
+	}
+	if(!steps.empty()) {
+		flush();
+	}
+
+	//The sink is released first, so that a sink that fails is not closed again by the destructor
+	std::unique_ptr<OutputSink> closed_sink(std::move(sink));
+	closed_sink->close();
+}
+
+
+//!Method that writes the block in the file
+void Multimeter::flush() {
+
+	buffer.clear();
+	appendInteger(buffer, steps.size(), 8);
+	for(auto step : steps) {
+		appendInteger(buffer, step, 8);
+	}
+
+	//Only the filled part of each column is written
+	for(size_t i(0); i<neurons.size(); ++i) {
+		for(size_t j(0); j<steps.size(); ++j) {
+			appendDouble(buffer, values[i*block_samples+j]);
+		}
+	}
+
+	sink->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	steps.clear();
+}
+
+
+
+//!Function that reads a whole multimeter file
+MultimeterTrace readMultimeter(const std::string& filename) {
+
+	std::ifstream file(filename, std::ios::binary);
+	if(!file) {
+		throw std::runtime_error("Cannot open "+filename);
+	}
+	const std::vector<unsigned char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if(content.size()<40 or std::memcmp(content.data(), magic, sizeof(magic))!=0 or getInteger(content.data()+8, 4)!=version) {
+		throw std::runtime_error(filename+" is not a multimeter file");
+	}
+
+	MultimeterTrace trace;
+	trace.h=getDouble(content.data()+16);
+	trace.interval_steps=getInteger(content.data()+24, 8);
+	const size_t nbr_neurons(getInteger(content.data()+32, 8));
+	trace.potentials.resize(nbr_neurons);
+
+	size_t position(40);
+	if(content.size()<position+8*nbr_neurons) {
+		throw std::runtime_error("Truncated multimeter file");
+	}
+	for(size_t i(0); i<nbr_neurons; ++i, position+=8) {
+		trace.neurons.push_back(getInteger(content.data()+position, 8));
+	}
+
+	while(position<content.size()) {
+		if(content.size()<position+8) {
+			throw std::runtime_error("Truncated multimeter file");
+		}
+		const size_t samples(getInteger(content.data()+position, 8));
+		position+=8;
+		if(content.size()<position+8*samples*(1+nbr_neurons)) {
+			throw std::runtime_error("Truncated multimeter file");
+		}
+
+		for(size_t j(0); j<samples; ++j, position+=8) {
+			trace.steps.push_back(getInteger(content.data()+position, 8));
+		}
+		for(size_t i(0); i<nbr_neurons; ++i) {
+			for(size_t j(0); j<samples; ++j, position+=8) {
+				trace.potentials[i].push_back(getDouble(content.data()+position));
+			}
+		}
+	}
+
+	return trace;
+}
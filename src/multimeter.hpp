@@ -0,0 +1,106 @@
+//! Multimeter class
+/*!To record the membrane potential of a set of neurons at regular intervals
+ *
+ * The file starts with a header (little-endian) :
+ * - the magic string "BRUNVM01", the format version (uint32) and the recorded quantity (uint32, 1 for the membrane potential in mV)
+ * - h (double), the number of steps between two samples and the number of recorded neurons (uint64)
+ * - the numbers of the recorded neurons (uint64)
+ *
+ * Then the samples are stored by blocks, each block being :
+ * - the number of samples n of the block (uint64) and the steps of the samples (n uint64)
+ * - for each recorded neuron, its n values (double), so that the trace of a neuron is contiguous
+ */
+#ifndef MULTIMETER_H
+#define MULTIMETER_H
+#include "network.hpp"
+#include "neuronSet.hpp"
+#include "outputSink.hpp"
+#include "recorder.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+class Multimeter {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * throws std::invalid_argument if block_samples_ is 0
+	 *\param filename the name of the file where to write the samples
+	 *\param neurons_ the recorded neurons
+	 *\param interval_ the time between two samples in ms (rounded to a number of steps, at least one)
+	 *\param block_samples_ the number of samples kept in memory before writing them
+	 *\param backend the system interface used to write the file
+	*/
+	Multimeter(const std::string& filename, const NeuronSet& neurons_, double interval_=1.0,
+			   size_t block_samples_=1024, SinkBackend backend=SinkBackend::Stream);
+
+
+	//!Destructor
+	~Multimeter();
+
+
+	//!Method called once before the first step of the simulation
+	/*!
+	 * computes the number of steps between two samples and writes the header of the file
+	 *\param info the parameters of the run
+	*/
+	void open(const RunInfo& info);
+
+
+	//!Method called after each step of the simulation
+	/*!
+	 * stores the potentials of the recorded neurons if a sample is due at this step
+	 *\param step the step of the simulation which has just been computed
+	 *\param network the simulated network
+	*/
+	void sample(unsigned int long step, const Network& network);
+
+
+	//!Method that writes the last block and closes the file
+	void close();
+
+
+
+	private :
+
+	//!Method that writes the block in the file
+	void flush();
+
+
+	std::unique_ptr<OutputSink> sink;	//!File where to write the samples
+	NeuronSet neurons;	//!Recorded neurons
+	double interval;	//!Asked time between two samples in ms
+	size_t block_samples;	//!Number of samples of a full block
+	unsigned int long interval_steps;	//!Number of steps between two samples
+	std::vector<unsigned int long> steps;	//!Steps of the samples of the block
+	std::vector<double> values;	//!Values of the block, column i holding the neuron i of the set (block_samples values per column)
+	std::vector<unsigned char> buffer;	//!Encoded block
+
+};
+
+
+
+//!Samples of a multimeter file
+struct MultimeterTrace {
+
+	double h;	//!Time step of the simulation in ms
+	unsigned int long interval_steps;	//!Number of steps between two samples
+	std::vector<unsigned int long> neurons;	//!Numbers of the recorded neurons
+	std::vector<unsigned int long> steps;	//!Steps of the samples
+	std::vector<std::vector<double> > potentials;	//!Membrane potentials, potentials[i][j] for the neuron neurons[i] at the step steps[j]
+
+};
+
+
+//!Function that reads a whole multimeter file
+/*!
+ *\param filename the name of the multimeter file
+ *\return the samples of the file
+*/
+MultimeterTrace readMultimeter(const std::string& filename);
+
+#endif
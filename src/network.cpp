@@ -1,78 +1,141 @@
 #include "network.hpp"
-#include <iostream>
+#include "binaryIo.hpp"
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <cmath>
 #include <cassert>
 #include <random>
+#include <memory>
 
 
-//!Constructor
-Network::Network(unsigned int long nbr_excitatory, unsigned int long nbr_inhibitory, double eta_, double JI_)
-: clock(0), JI(JI_), nbrExcitatory(nbr_excitatory), nbrInhibitory(nbr_inhibitory)
-{
-	
-	Nu_ext=eta_*V_thr*h/(J*TAU);
+namespace {
 
-	unsigned int nbr_tot (nbr_excitatory);
-	nbr_tot += nbr_inhibitory;
-	setNbrNeurons(nbr_tot);
+//Function that draws the connections of a network and gives each of them to connect(source, target)
+/*
+ * each neuron receives connections_excitatory connections from excitatory neurons drawn uniformly, then
+   connections_inhibitory from inhibitory ones, always in the same order for the same seed
+*/
+template<typename Connect>
+void drawConnections(const NetworkSize& size, unsigned int seed, Connect connect) {
 	
+	/* 
+	 * d1 : uniform int distribution in the interval [0, nbr_excitatory-1]
+	 * d2 : uniform int distribution in the interval [nbr_excitatory, nbr_tot-1]
+	 * they are only created for the populations that give connections, an empty population having no interval
+	*/
+	const unsigned int long nbr_tot(size.nbr_excitatory+size.nbr_inhibitory);
+	std::seed_seq connections_seed {seed, 0u};
+	std::mt19937 gen(connections_seed);
+	std::unique_ptr<std::uniform_int_distribution<> > d1, d2;
+	if(size.connections_excitatory>0) {
+		d1.reset(new std::uniform_int_distribution<>(0, static_cast<int>(size.nbr_excitatory)-1));
+	}
+	if(size.connections_inhibitory>0) {
+		d2.reset(new std::uniform_int_distribution<>(static_cast<int>(size.nbr_excitatory), static_cast<int>(nbr_tot)-1));
+	}
 	
-	//Constuction of nbr_excitatory excitatory neurons in the network
-	if((nbr_excitatory!=0)) {
-		for(size_t i(0); i<nbr_excitatory; ++i) { 
-			neurons.push_back(Neuron (true));
+	for(unsigned int long i(0); i<nbr_tot; ++i) {
+		for(unsigned int long j(0); j<size.connections_excitatory; ++j) {
+			connect((*d1)(gen), i);
+		}
+		for(unsigned int long j(0); j<size.connections_inhibitory; ++j) {
+			connect((*d2)(gen), i);
 		}
 	}
+}
+
+}
+
+
+//!Function that gives the size of the network of the paper
+NetworkSize defaultNetworkSize() {
+	return NetworkSize {NE, NI, static_cast<unsigned int long>(CE), static_cast<unsigned int long>(CI)};
+}
+
+
+//!Function that verifies a size of network
+void checkNetworkSize(const NetworkSize& size) {
+	if(size.nbr_excitatory+size.nbr_inhibitory==0) {
+		throw std::invalid_argument("The network needs at least one neuron");
+	}
+	if((size.nbr_excitatory==0 and size.connections_excitatory>0) or (size.nbr_inhibitory==0 and size.connections_inhibitory>0)) {
+		throw std::invalid_argument("The neurons can not receive connections from an empty population");
+	}
+	if(size.nbr_excitatory+size.nbr_inhibitory>2147483647ul) {
+		throw std::invalid_argument("The network can not have more than 2^31-1 neurons");
+	}
+}
+
+
+//!Constructor
+Network::Network(unsigned int long nbr_excitatory, unsigned int long nbr_inhibitory, double eta_, double JI_, unsigned int seed_)
+: Network(NetworkSize {nbr_excitatory, nbr_inhibitory, static_cast<unsigned int long>(CE), static_cast<unsigned int long>(CI)},
+		  eta_, JI_, seed_)
+{}
+
+
+//!Constructor
+Network::Network(const NetworkSize& size, double eta_, double JI_, unsigned int seed_)
+: clock(0), JI(JI_), nbrExcitatory(size.nbr_excitatory), nbrInhibitory(size.nbr_inhibitory),
+  connectionsExcitatory(size.connections_excitatory), connectionsInhibitory(size.connections_inhibitory), seed(seed_),
+  connections_checksum(0), refractory_skip(true)
+{
 	
-	//Construction of nbr_inhibitory inhibitory neurons in the network
-	if((nbr_inhibitory!=0)) {
-		for(size_t i(0); i<nbr_inhibitory; ++i) {
-			neurons.push_back(Neuron (false));
-		}	
+	checkNetworkSize(size);
+	
+	Nu_ext=eta_*V_thr*h/(J*TAU);
+	noise=PoissonSampler(Nu_ext);
+	
+	//Without a given seed, a seed is drawn and kept, so that the network can be created again
+	if(seed==0) {
+		std::random_device rd;
+		while(seed==0) {
+			seed=rd();
+		}
 	}
+	std::seed_seq noise_seed {seed, 1u};
+	noise_gen.seed(noise_seed);
+
+	const unsigned int long nbr_tot(nbrExcitatory+nbrInhibitory);
+	setNbrNeurons(nbr_tot);
 	
 	
-	//Creation of 2 random uniform int distributions
-	/* 
-	 * d1 : uniform int distribution in the interval [0, nbr_excitatory-1]
-	 * d2 : uniform int distribution in the interval [nbr_excitatory-1, nbr_tot-1]
-	*/
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
-	std::uniform_int_distribution<>d1(0, nbr_excitatory-1);
-	std::uniform_int_distribution<>d2(nbr_excitatory, nbr_tot-1);
+	//Construction of the excitatory neurons, then of the inhibitory neurons
+	neurons.reserve(nbr_tot);
+	for(unsigned int long i(0); i<nbr_tot; ++i) { 
+		neurons.push_back(Neuron (i<nbrExcitatory));
+	}
 	
 
 	//Creation of neuron connections
 	/*
-	 * for each neuron of the total number of neurons of the network (nbr_tot) :
-	 * -> creation of CE excitatory connections
-	 * -> creation of CI inhibitory connections
+	 * the connections are drawn twice with the same generator : the first time to count the targets of each neuron,
+	   so that each neuron allocates exactly its targets, the second time to add them
+	 * for each neuron i, the index of i is added to the targets of connections_excitatory random excitatory neurons
+	   and of connections_inhibitory random inhibitory neurons
 	*/
+	std::vector<unsigned int long> nbr_targets(nbr_tot, 0);
+	drawConnections(size, seed, [&nbr_targets](unsigned int long source, unsigned int long) {
+		++nbr_targets[source];
+	});
 	for(unsigned int long i(0); i<nbr_tot; ++i) {
-		
-		for(unsigned int long j(0); j<CE; ++j) {
-			
-			/*
-			 * Addition of the index of the neuron i in the attribute neurons of the network 
-			   to the attribute targets of a random excitatory neuron of the network
-			*/
-			neurons[d1(gen)].addTarget(i);  
-		}
-		
-		for(unsigned int long j(0); j<CI; ++j) {
-			/*
-			 * Addition of the index of the neuron i in the attribute neurons of the network 
-			   to the attribute targets of a random inhibitory neuron of the network
-			*/
-			neurons[d2(gen)].addTarget(i);
-		}
-			
+		neurons[i].reserveTargets(nbr_targets[i]);
 	}
+	drawConnections(size, seed, [this](unsigned int long source, unsigned int long target) {
+		neurons[source].addTarget(target);
+	});
 	
-	std::cout<<"Connections : done"<<std::endl;
+	//FNV-1a hash of the targets, stored in the checkpoints
+	connections_checksum=14695981039346656037ull;
+	for(const auto& neuron : neurons) {
+		for(auto target : neuron.getTargets()) {
+			connections_checksum=(connections_checksum^target)*1099511628211ull;
+		}
+		connections_checksum=(connections_checksum^0xff)*1099511628211ull;	//End of the targets of a neuron
+	}
 	
 }
 		
@@ -98,10 +161,28 @@ unsigned int long Network::getNbrNeurons() const {
 }
 
 
+//!Getter for the number of excitatory neurons in the network
+unsigned int long Network::getNbrExcitatory() const {
+	return nbrExcitatory;
+}
+
+
+//!Getter for the size of the network
+NetworkSize Network::getSize() const {
+	return NetworkSize {nbrExcitatory, nbrInhibitory, connectionsExcitatory, connectionsInhibitory};
+}
+
+
 //!Getter for the neurons of the network
 std::vector<Neuron> Network::getNeurons() const {
 	return neurons;
 }
+
+
+//!Getter for one neuron of the network
+const Neuron& Network::getNeuron(unsigned int long neuronNumber) const {
+	return neurons[neuronNumber];
+}
 	
 
 //!Test method used in the unitTests to know the number of excitatory connections that receives the neuron 'neuronNumber'
@@ -141,31 +222,121 @@ void Network::setNbrNeurons(unsigned int long nbr) {
 }
 
 
+//!Getter for the neurons that spiked during the last update
+const std::vector<unsigned int long>& Network::getSpikes() const {
+	return spikes;
+}
+
+
+//!Getter for the seed of the network
+unsigned int Network::getSeed() const {
+	return seed;
+}
+
+
+//!Getter for the checksum of the connections
+std::uint64_t Network::getConnectionsChecksum() const {
+	return connections_checksum;
+}
+
+
+//!Method that appends the state of the network to a buffer, for the checkpoints
+void Network::saveState(std::vector<unsigned char>& buffer) const {
+	
+	appendInteger(buffer, seed, 4);
+	appendInteger(buffer, connections_checksum, 8);
+	appendInteger(buffer, nbrNeurons, 8);
+	appendInteger(buffer, clock, 8);
+	
+	for(const auto& neuron : neurons) {
+		neuron.saveState(buffer);
+	}
+	
+	//The random generator writes its exact state as text
+	std::ostringstream generator;
+	generator<<noise_gen;
+	const std::string state(generator.str());
+	appendInteger(buffer, state.size(), 8);
+	buffer.insert(buffer.end(), state.begin(), state.end());
+}
+
+
+//!Method that restores the state of the network written by saveState
+void Network::loadState(const unsigned char*& position, const unsigned char* end) {
+	
+	const unsigned int saved_seed(getInteger(takeBytes(position, end, 4), 4));
+	const std::uint64_t saved_checksum(getInteger(takeBytes(position, end, 8), 8));
+	const unsigned int long saved_neurons(getInteger(takeBytes(position, end, 8), 8));
+	if(saved_seed!=seed or saved_checksum!=connections_checksum or saved_neurons!=nbrNeurons) {
+		throw std::runtime_error("The saved state is not the one of a network with the same connections");
+	}
+	clock=getInteger(takeBytes(position, end, 8), 8);
+	
+	for(auto& neuron : neurons) {
+		neuron.loadState(position, end);
+	}
+	
+	const size_t size(getInteger(takeBytes(position, end, 8), 8));
+	const unsigned char* state(takeBytes(position, end, size));
+	std::istringstream generator(std::string(state, state+size));
+	generator>>noise_gen;
+	if(!generator) {
+		throw std::runtime_error("The saved state of the random generator is not valid");
+	}
+	
+	spikes.clear();
+}
+
+
+//!Setter for the parameters of the network that do not change its connections
+void Network::setParameters(double eta_, double JI_) {
+	JI=JI_;
+	Nu_ext=eta_*V_thr*h/(J*TAU);
+	noise=PoissonSampler(Nu_ext);
+}
+
+
+//!Method that restarts the random generator of the background noise
+void Network::reseedNoise(unsigned int noise_seed) {
+	std::seed_seq sequence {noise_seed, 1u};
+	noise_gen.seed(sequence);
+}
+
+
+//!Setter for the skip of the refractory neurons
+void Network::setRefractorySkip(bool skip) {
+	refractory_skip=skip;
+}
+
+
 //!Method that updates the network at each time step of the simulation
-void Network::update(double external_current, std::ofstream& output_file) {
+void Network::update(double external_current) {
 	
 	bool spike;
-	
-	//Creation of a random poisson distribution of parameter Vext
-	static std::random_device rd;	
-	static std::mt19937 gen(rd());
-	std::poisson_distribution<> d(Nu_ext); 
+	spikes.clear();
 	
 	//For each neuron of the network 
 	for(size_t i(0); i<neurons.size(); ++i) { 
 		
-		spike=neurons[i].update(external_current, d(gen));	//Update of each neuron 
+		/*
+		 * A refractory neuron is skipped until the end of its refractory period (see Neuron::skipRefractory).
+		   Its number of the background noise is still drawn, so that the other neurons receive the same noise
+		*/
+		if(refractory_skip and neurons[i].skipRefractory(clock)) {
+			noise_gen.discard(1);
+			continue;
+		}
+		
+		spike=neurons[i].update(external_current, noise(noise_gen));	//Update of each neuron 
 		
-		/*These 2 lines can be uncommented to have a display on the terminal */
-		//std::cout<<"Neuron "<<i+1<<" : ";
-		//neurons[i].display();	//Display of the potential value of each neuron on the terminal
+		/*The potentials of chosen neurons can be recorded with a Multimeter added to the simulation */
 		
 		
 		//If a spike for the neuron i of neurons occured
 		if(spike) {
 			
-			//Writing of the time when the spike occured and the neuron number in output_file 
-			output_file<<getClock()<<'\t'<<i+1<<'\n'; 
+			//The neuron number is kept for the recorders
+			spikes.push_back(i); 
 			
 			
 			//For each 'target' of the neuron i 
@@ -4,11 +4,39 @@
 #ifndef NETWORK_H 
 #define NETWORK_H
 #include "neuron.hpp"
+#include "poissonSampler.hpp"
 #include <iostream>
+#include <cstdint>
+#include <random>
 #include <vector>
 #include <cmath>
 
 
+//!Numbers of neurons and of connections of a network
+struct NetworkSize {
+	unsigned int long nbr_excitatory;	//!Number of excitatory neurons (the first neurons of the network)
+	unsigned int long nbr_inhibitory;	//!Number of inhibitory neurons
+	unsigned int long connections_excitatory;	//!Number of excitatory connections received by each neuron (CE)
+	unsigned int long connections_inhibitory;	//!Number of inhibitory connections received by each neuron (CI)
+};
+
+
+//!Function that gives the size of the network of the paper
+/*!
+ *\return NE, NI, CE and CI of constants.hpp
+*/
+NetworkSize defaultNetworkSize();
+
+
+//!Function that verifies a size of network
+/*!
+ * throws std::invalid_argument if the network has no neuron, if a population that sends connections is empty,
+ * or if the network has more neurons than the numbers of neurons of the connections can hold (2^31-1)
+ *\param size the size of the network
+*/
+void checkNetworkSize(const NetworkSize& size);
+
+
 class Network {
 	
 	public :
@@ -19,8 +47,22 @@ class Network {
 	 *\param nbr_inhibitory the number of inhibitory neurons in the network
 	 *\param eta_ the value of the ratio Nu_ext/Nu_thr
 	 *\param JI_ the weight of inhibitory connections
+	 *\param seed_ the seed of the random generators of the connections and of the background noise (0 to draw one)
 	*/
-	Network(unsigned int long nbr_excitatory, unsigned int long nbr_inhibitory, double Nu_ext_, double JI_);
+	Network(unsigned int long nbr_excitatory, unsigned int long nbr_inhibitory, double Nu_ext_, double JI_, unsigned int seed_=0);
+	
+	
+	//!Constructor
+	/*!
+	 * each neuron receives size.connections_excitatory connections from excitatory neurons drawn uniformly, and
+	   size.connections_inhibitory from inhibitory ones, and each neuron allocates exactly its targets
+	 * throws std::invalid_argument if the size is not valid (see checkNetworkSize)
+	 *\param size the numbers of neurons and of connections
+	 *\param eta_ the value of the ratio Nu_ext/Nu_thr
+	 *\param JI_ the weight of inhibitory connections
+	 *\param seed_ the seed of the random generators of the connections and of the background noise (0 to draw one)
+	*/
+	Network(const NetworkSize& size, double eta_, double JI_, unsigned int seed_=0);
 	
 	
 	//!Destructor
@@ -41,6 +83,20 @@ class Network {
 	unsigned int long getNbrNeurons() const;
 	
 	
+	//!Getter for the number of excitatory neurons in the network
+	/*!
+	 *\return the number of excitatory neurons, which are the first neurons of the network
+	*/
+	unsigned int long getNbrExcitatory() const;
+	
+	
+	//!Getter for the size of the network
+	/*!
+	 *\return the numbers of neurons and of connections of the network
+	*/
+	NetworkSize getSize() const;
+	
+	
 	//!Getter for the neurons of the network
 	/*!
 	 *\return a vector of neurons that contains the neurons of the network
@@ -48,6 +104,14 @@ class Network {
 	std::vector<Neuron> getNeurons() const;
 	
 	
+	//!Getter for one neuron of the network
+	/*!
+	 *\param neuronNumber the number of the neuron in neurons
+	 *\return the neuron 'neuronNumber' (without copying the other neurons)
+	*/
+	const Neuron& getNeuron(unsigned int long neuronNumber) const;
+	
+	
 	//!Test method used in the unitTests to know the number of excitatory connections that receives the neuron 'neuronNumber'
 	/*!
 	 *\param neuronNumber the number of the corresponding neuron in neurons
@@ -70,15 +134,80 @@ class Network {
 	 void setNbrNeurons(unsigned int long nbr);
 	
 	
+	//!Getter for the neurons that spiked during the last update
+	/*!
+	 *\return the numbers of the neurons that spiked during the last update, in increasing order
+	*/
+	const std::vector<unsigned int long>& getSpikes() const;
+	
+	
+	//!Getter for the seed of the network
+	/*!
+	 *\return the seed of the random generators, with which the same connections can be created again
+	*/
+	unsigned int getSeed() const;
+	
+	
+	//!Getter for the checksum of the connections
+	/*!
+	 *\return a hash of the targets of all the neurons, to verify that two networks have the same connections
+	*/
+	std::uint64_t getConnectionsChecksum() const;
+	
+	
+	//!Method that appends the state of the network to a buffer, for the checkpoints
+	/*!
+	 * the state is the clock, the state of each neuron and the state of the random generator of the background noise,
+	 * with the seed and the checksum of the connections (the connections themselves are created again from the seed)
+	 *\param buffer the buffer where to write the state
+	*/
+	void saveState(std::vector<unsigned char>& buffer) const;
+	
+	
+	//!Method that restores the state of the network written by saveState
+	/*!
+	 * the network can have other values of eta and JI than the saved one : the background noise then takes the rate of this network
+	 * throws std::runtime_error if the state is truncated or if the network does not have the same connections
+	 *\param position the position of the state in a buffer, moved after the state
+	 *\param end the end of the buffer
+	*/
+	void loadState(const unsigned char*& position, const unsigned char* end);
+	
+	
+	//!Setter for the parameters of the network that do not change its connections
+	/*!
+	 *\param eta_ the value of the ratio Nu_ext/Nu_thr
+	 *\param JI_ the weight of inhibitory connections
+	*/
+	void setParameters(double eta_, double JI_);
+	
+	
+	//!Method that restarts the random generator of the background noise
+	/*!
+	 * used to run different trials from the same state
+	 *\param noise_seed the new seed of the background noise
+	*/
+	void reseedNoise(unsigned int noise_seed);
+	
+	
+	//!Setter for the skip of the refractory neurons
+	/*!
+	 * the refractory neurons are skipped by default ; without the skip, they are updated like the other neurons, which
+	   keep them at 0.0 and gives the same spikes (used by Benchmarks to measure the time saved by the skip)
+	 *\param skip true to skip the refractory neurons, false to update them
+	*/
+	void setRefractorySkip(bool skip);
+	
+	
 	//!Method that updates the network at each time step of the simulation
 	/*!
-	 * updates each neuron of the network
+	 * updates each neuron of the network that is not refractory (the refractory neurons are skipped)
 	 * updates the neuron connections of the network
+	 * stores the neurons that spiked (see getSpikes())
 	 * updates the local clock
 	 *\param external_current the external current (0.0 mV in our simulation)
-	 *\param output_file the file where to write times of the neuron spikes
 	*/
-	void update(double external_current, std::ofstream& output_file);
+	void update(double external_current);
 	
 	
 	//!Method that updates the local clock of the network
@@ -97,7 +226,15 @@ class Network {
 	unsigned int long nbrNeurons;	//!Total number of neurons in the network
 	unsigned int long nbrExcitatory;	//!Number of excitatory neurons of the network
 	unsigned int long nbrInhibitory;	//!Number of inhibitory neurons of the network
+	unsigned int long connectionsExcitatory;	//!Number of excitatory connections received by each neuron
+	unsigned int long connectionsInhibitory;	//!Number of inhibitory connections received by each neuron
 	std::vector<Neuron> neurons;	//!Vector of the neurons of the network
+	std::vector<unsigned int long> spikes;	//!Numbers of the neurons that spiked during the last update
+	unsigned int seed;	//!Seed of the random generators
+	std::uint64_t connections_checksum;	//!Hash of the targets of all the neurons
+	bool refractory_skip;	//!True if the refractory neurons are skipped by update
+	std::mt19937 noise_gen;	//!Random generator of the background noise
+	PoissonSampler noise;	//!Poisson distribution of the background noise
 	
 	
 };
@@ -0,0 +1,83 @@
+#include "spikeAnalysis.hpp"
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc<2) {
+		std::cerr<<"Usage : "<<argv[0]<<" spike_file [options]"<<std::endl;
+		std::cerr<<"Reads spikes.txt, spikes.bin or a spike archive once and writes the data of the raster plot and of the rates"<<std::endl;
+		std::cerr<<"  --window start_ms stop_ms        analysed time window (default : the whole run)"<<std::endl;
+		std::cerr<<"  --neurons first last             neurons of the raster, numbered from 1 (default : 1 50)"<<std::endl;
+		std::cerr<<"  --bin width_ms                   width of the bins of the rates (default : h)"<<std::endl;
+		std::cerr<<"  --format csv|binary              format of the written files (default : csv)"<<std::endl;
+		std::cerr<<"  --excitatory count               number of excitatory neurons of a text file (needed for spikes.txt)"<<std::endl;
+		std::cerr<<"  --inhibitory count               number of inhibitory neurons of a text file (needed for spikes.txt)"<<std::endl;
+		std::cerr<<"  --threads count                  number of threads (default : one per core)"<<std::endl;
+		std::cerr<<"  --output prefix                  the files prefix_raster and prefix_rate are written (default : analysis)"<<std::endl;
+		return 1;
+	}
+
+	try {
+		AnalysisOptions options(defaultAnalysisOptions());
+		std::string prefix("analysis");
+
+		for(int i(2); i<argc; ++i) {
+			const std::string option(argv[i]);
+			const int nbr_values((option=="--window" or option=="--neurons") ? 2 : 1);
+			if(i+nbr_values>=argc) {
+				throw std::invalid_argument("Missing value after "+option);
+			}
+
+			if(option=="--window") {
+				options.start=std::stod(argv[i+1]);
+				options.stop=std::stod(argv[i+2]);
+			} else if(option=="--neurons") {
+				const unsigned int long first(std::stoul(argv[i+1]));
+				const unsigned int long last(std::stoul(argv[i+2]));
+				if(first==0 or last<first) {
+					throw std::invalid_argument("The neurons are numbered from 1 and first must not be larger than last");
+				}
+				options.first_neuron=first-1;
+				options.last_neuron=last-1;
+			} else if(option=="--bin") {
+				options.bin_width=std::stod(argv[i+1]);
+			} else if(option=="--format") {
+				const std::string format(argv[i+1]);
+				if(format!="csv" and format!="binary") {
+					throw std::invalid_argument("Unknown format "+format);
+				}
+				options.format=(format=="csv") ? AnalysisFormat::Csv : AnalysisFormat::Binary;
+			} else if(option=="--excitatory") {
+				options.nbr_excitatory=std::stoul(argv[i+1]);
+			} else if(option=="--inhibitory") {
+				options.nbr_inhibitory=std::stoul(argv[i+1]);
+			} else if(option=="--threads") {
+				options.threads=std::stoul(argv[i+1]);
+			} else if(option=="--output") {
+				prefix=argv[i+1];
+			} else {
+				throw std::invalid_argument("Unknown option "+option);
+			}
+			i+=nbr_values;
+		}
+
+		const std::string extension((options.format==AnalysisFormat::Csv) ? ".csv" : ".bin");
+		const auto start(std::chrono::steady_clock::now());
+		const AnalysisSummary summary(analyzeSpikes(argv[1], prefix+"_raster"+extension, prefix+"_rate"+extension, options));
+		const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+
+		std::cout<<"Analysis : "<<summary.spikes<<" spikes, "<<summary.raster_spikes<<" in the raster, "<<summary.bins<<" bins, "
+				 <<summary.chunks<<" chunks read by "<<summary.threads<<" threads in "<<duration.count()<<" s"<<std::endl;
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	return 0;
+}
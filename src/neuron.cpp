@@ -1,10 +1,29 @@
 #include "neuron.hpp"
+#include "binaryIo.hpp"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <cmath>
 #include <cassert>
+#include <cstring>
 #include <random>
+#include <stdexcept>
+
+
+namespace {
+
+//Function that gives the duration of the refractory period in steps, with the test of Neuron::isRefractory
+unsigned int long refractorySteps() {
+	unsigned int long steps(0);
+	while(steps*h<Tref) {
+		++steps;
+	}
+	return steps;
+}
+
+const unsigned int long refractory_steps(refractorySteps());	//Duration of the refractory period in steps
+
+}
 
 
 //!Constructor
@@ -12,6 +31,7 @@ Neuron::Neuron(bool excitat) : incoming_spikes(delay_steps+1) {
 	setPotential(0.0);
 	nbr_spikes=0;
 	clock=0;
+	active_time=0;
 	excitatory=excitat;
 	
 	for(auto& value : incoming_spikes) {	//At the construction of the neuron, its buffer doesn't contain signals. 
@@ -76,7 +96,7 @@ bool Neuron::isRefractory() const {
 
 
 //!Getter for the targets of the neuron
-std::vector<unsigned int long> Neuron::getTargets() const {
+const std::vector<unsigned int long>& Neuron::getTargets() const {
 	return targets;
 }	
 
@@ -93,6 +113,12 @@ void Neuron::addTarget(unsigned int long target) {
 }
 
 
+//!Method that allocates the targets of the neuron
+void Neuron::reserveTargets(unsigned int long nbr_targets) {
+	targets.reserve(nbr_targets);
+}
+
+
 //!Method used in unitTests to know the number of times the neuron 'neuronNumber' is present in targets
 unsigned int Neuron::isTarget(unsigned int neuronNumber) const {
 	
@@ -151,6 +177,10 @@ bool Neuron::update(double Iext, unsigned int random) {
 		incrementNbrSpikes();	//Increment the total number of spikes of the neuron since the beginning of the simulation by +1
 		setPotential(0.0);  //Set the membrane potential of the neuron to 0.0 afer a spike
 		spike=true;		//For the return of the method
+		
+		//The signals that arrive during the refractory period are lost
+		active_time=clock+refractory_steps;
+		discardIncomingSpikes(clock+1, active_time);
 	}
 		
 	//If the neuron is refractory, keep its potential at 0.0, else udpate its membrane potential
@@ -189,6 +219,10 @@ bool Neuron::updateTest(unsigned int long time, double Iext) {
 			incrementNbrSpikes();	//Increment the total number of spikes of the neuron since the beginning of the simulation by +1
 			setPotential(0.0);	//Set the membrane potential of the neuron to 0.0 afer a spike
 			spike=true;		//For the return of the method
+			
+			//The signals that arrive during the refractory period are lost
+			active_time=clock+refractory_steps;
+			discardIncomingSpikes(clock+1, active_time);
 		}
 		
 		
@@ -218,6 +252,10 @@ bool Neuron::updateTest(unsigned int long time, double Iext) {
 //!Method that 'manages' when the neuron receives a spike
 void Neuron::receiveSpike(unsigned long t, int weight) {   
 	
+	if(t<active_time) {
+		return;		//The neuron is refractory at time t : the signal is lost
+	}
+	
 	const auto t_buff=t%(delay_steps+1);	// t_buff gives the index corresponding to time t in the neuron buffer
 	assert(t_buff<incoming_spikes.size());	//Verifies that t_buff really indexes an existing box of the neuron buffer
 	incoming_spikes[t_buff]+=weight;	//Addition of the signal of weight 'weight' in the neuron buffer
@@ -230,7 +268,73 @@ void Neuron::resetIncomingSpikes() {
 }
 
 
+//!Method that removes the signals that arrive between two times
+void Neuron::discardIncomingSpikes(unsigned int long from, unsigned int long to) {
+	for(unsigned int long t(from); t<to and t<from+incoming_spikes.size(); ++t) {
+		incoming_spikes[t%incoming_spikes.size()]=0;
+	}
+}
+
+
+//!Method that tells if the neuron can be skipped because it is refractory
+bool Neuron::skipRefractory(unsigned int long time) {
+	if(time<active_time) {
+		clock=time+1;	//Same clock as after an update
+		return true;
+	}
+	clock=time;
+	return false;
+}
+
+
 //!Display method
 void Neuron::display() const {
 	std::cout<<"V("<<clock*h<<")="<<potential<<std::endl;
 }
+
+
+//!Method that appends the state of the neuron to a buffer, for the checkpoints
+void Neuron::saveState(std::vector<unsigned char>& buffer) const {
+	
+	buffer.push_back(excitatory);
+	
+	//The potential is copied byte by byte, so that the simulation continues exactly
+	const unsigned char* bytes(reinterpret_cast<const unsigned char*>(&potential));
+	buffer.insert(buffer.end(), bytes, bytes+sizeof(potential));
+	
+	appendInteger(buffer, nbr_spikes, 8);
+	appendInteger(buffer, times.empty() ? 0 : times.back()+1, 8);	//0 if the neuron never spiked
+	appendInteger(buffer, clock, 8);
+	
+	appendInteger(buffer, incoming_spikes.size(), 4);
+	for(auto value : incoming_spikes) {
+		appendInteger(buffer, static_cast<std::uint32_t>(value), 4);
+	}
+}
+
+
+//!Method that restores the state of the neuron written by saveState
+void Neuron::loadState(const unsigned char*& position, const unsigned char* end) {
+	
+	if(*takeBytes(position, end, 1)!=excitatory) {
+		throw std::runtime_error("The state of an excitatory neuron can not be given to an inhibitory one");
+	}
+	std::memcpy(&potential, takeBytes(position, end, sizeof(potential)), sizeof(potential));
+	
+	nbr_spikes=getInteger(takeBytes(position, end, 8), 8);
+	const unsigned int long last_time(getInteger(takeBytes(position, end, 8), 8));
+	times.clear();
+	if(last_time>0) {
+		times.push_back(last_time-1);
+	}
+	clock=getInteger(takeBytes(position, end, 8), 8);
+	active_time=(last_time>0) ? last_time-1+refractory_steps : 0;
+	
+	if(getInteger(takeBytes(position, end, 4), 4)!=incoming_spikes.size()) {
+		throw std::runtime_error("The buffer of the neuron does not have the same delay");
+	}
+	for(auto& value : incoming_spikes) {
+		value=static_cast<std::int32_t>(static_cast<std::uint32_t>(getInteger(takeBytes(position, end, 4), 4)));
+	}
+	discardIncomingSpikes(clock, active_time);	//Signals of the refractory period that a state of an older version kept
+}
@@ -79,7 +79,7 @@ class Neuron {
 	/*!
 	 *\return a vector of unsigned int long that corresponds to the targets of the neuron
 	*/
-	std::vector<unsigned int long> getTargets() const;
+	const std::vector<unsigned int long>& getTargets() const;
 
 	
 	//!Setter for the membrane potential value of the neuron
@@ -96,6 +96,13 @@ class Neuron {
 	void addTarget(unsigned int long target);
 	
 	
+	//!Method that allocates the targets of the neuron
+	/*!
+	 *\param nbr_targets the number of targets that the neuron will have
+	*/
+	void reserveTargets(unsigned int long nbr_targets);
+	
+	
 	//!Method used in unitTests to know the number of times the neuron 'neuronNumber' is present in targets
 	/*!
 	 *\param neuronNumber the number of the corresponding neuron
@@ -157,7 +164,8 @@ class Neuron {
 	
 	//!Method that 'manages' when the neuron receives a spike
 	/*!
-	 * add a signal of a certain weight in the neuron buffer (attribute incoming_spikes)
+	 * add a signal of a certain weight in the neuron buffer (attribute incoming_spikes),
+		unless the neuron is refractory at time t
 	 *\param t the time when the membrane potential of the neuron 
 		must increase due to the spike of one of its connections  
 	 *\param weight the weight of the connection between the neuron and the other
@@ -173,6 +181,25 @@ class Neuron {
 	void resetIncomingSpikes();
 	
 	
+	//!Method that removes the signals that arrive between two times
+	/*!
+	 * used for the signals that arrive during the refractory period, which are lost
+	 *\param from the first time whose signals are removed
+	 *\param to the time after the last one whose signals are removed
+	*/
+	void discardIncomingSpikes(unsigned int long from, unsigned int long to);
+	
+	
+	//!Method that tells if the neuron can be skipped because it is refractory
+	/*!
+	 * a refractory neuron keeps its potential at 0.0 and loses the signals it receives (see receiveSpike), so that
+	   only its clock needs to be updated until the end of its refractory period
+	 *\param time the current time
+	 *\return true if the neuron is refractory at this time (its clock is then updated), else false
+	*/
+	bool skipRefractory(unsigned int long time);
+	
+	
 	//!Display method
 	/*!
 	 * displays on the terminal the potential of the neuron
@@ -180,6 +207,24 @@ class Neuron {
 	void display() const;
 	
 	
+	//!Method that appends the state of the neuron to a buffer, for the checkpoints
+	/*!
+	 * the state is the potential, the spike counter, the time of the last spike, the clock and the buffer
+	 * (the targets are not part of the state, and the times before the last spike are not kept)
+	 *\param buffer the buffer where to write the state
+	*/
+	void saveState(std::vector<unsigned char>& buffer) const;
+	
+	
+	//!Method that restores the state of the neuron written by saveState
+	/*!
+	 * throws std::runtime_error if the state is truncated or does not match the neuron
+	 *\param position the position of the state in a buffer, moved after the state
+	 *\param end the end of the buffer
+	*/
+	void loadState(const unsigned char*& position, const unsigned char* end);
+	
+	
 	
 	private :
 	
@@ -188,6 +233,7 @@ class Neuron {
 	unsigned int long nbr_spikes;	//!Total number of spikes of the neuron until the current time
 	std::vector<unsigned int long> times;	//!Times when neuron spikes occured until the current time
 	unsigned int long clock;	//!Local clock of the neuron (current time)
+	unsigned int long active_time;	//!Time of the end of the refractory period (the signals that arrive before are lost)
 	std::vector<int> incoming_spikes;	//!Neuron buffer that stores the incoming spike signals of connections
 	std::vector<unsigned int long> targets;	//!Connections which to send signals when the neuron spikes
 	
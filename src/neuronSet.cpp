@@ -0,0 +1,91 @@
+#include "neuronSet.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+//!Method that creates the set of the neurons of a range
+NeuronSet NeuronSet::range(unsigned int long first, unsigned int long last) {
+	return stride(first, last, 1);
+}
+
+
+//!Method that creates the set of the neurons of a range taken every 'stride' neurons
+NeuronSet NeuronSet::stride(unsigned int long first, unsigned int long last, unsigned int long stride) {
+
+	if(stride==0) {
+		throw std::invalid_argument("The stride of a set of neurons must be strictly positive");
+	}
+
+	std::vector<unsigned int long> neurons;
+	for(unsigned int long neuron(first); neuron<last; neuron+=stride) {
+		neurons.push_back(neuron);
+	}
+
+	return NeuronSet(neurons);
+}
+
+
+//!Method that creates a set of neurons drawn at random (uniformly, without replacement)
+NeuronSet NeuronSet::random(unsigned int long count, unsigned int long nbr_neurons, unsigned int seed) {
+
+	if(count>nbr_neurons) {
+		throw std::invalid_argument("Cannot draw "+std::to_string(count)+" neurons among "+std::to_string(nbr_neurons));
+	}
+
+	//Selection sampling : each neuron is kept with the probability (neurons still needed)/(neurons left)
+	std::mt19937 gen(seed);
+	std::vector<unsigned int long> neurons;
+	for(unsigned int long neuron(0); neuron<nbr_neurons and neurons.size()<count; ++neuron) {
+		std::uniform_int_distribution<unsigned int long> d(0, nbr_neurons-neuron-1);
+		if(d(gen)<count-neurons.size()) {
+			neurons.push_back(neuron);
+		}
+	}
+
+	return NeuronSet(neurons);
+}
+
+
+//!Method that creates a set from a list of neurons
+NeuronSet NeuronSet::list(std::vector<unsigned int long> neurons) {
+
+	std::sort(neurons.begin(), neurons.end());
+	neurons.erase(std::unique(neurons.begin(), neurons.end()), neurons.end());
+
+	return NeuronSet(neurons);
+}
+
+
+//!Getter for the neurons of the set
+const std::vector<unsigned int long>& NeuronSet::getNeurons() const {
+	return neurons;
+}
+
+
+//!Getter for the number of neurons of the set
+size_t NeuronSet::size() const {
+	return neurons.size();
+}
+
+
+//!Method that computes the bitmask of the set
+std::vector<std::uint64_t> NeuronSet::mask(unsigned int long nbr_neurons) const {
+
+	if(!neurons.empty() and neurons.back()>=nbr_neurons) {
+		throw std::out_of_range("The neuron "+std::to_string(neurons.back()+1)+" is not in the network");
+	}
+
+	std::vector<std::uint64_t> bits((nbr_neurons+63)/64, 0);
+	for(auto neuron : neurons) {
+		bits[neuron/64]|=std::uint64_t(1)<<(neuron%64);
+	}
+
+	return bits;
+}
+
+
+//!Constructor
+NeuronSet::NeuronSet(std::vector<unsigned int long> neurons_) : neurons(neurons_) {}
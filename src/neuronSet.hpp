@@ -0,0 +1,91 @@
+//! NeuronSet class
+/*!To choose the neurons of the network watched by a recording device
+ */
+#ifndef NEURONSET_H
+#define NEURONSET_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+class NeuronSet {
+
+	public :
+
+	//!Method that creates the set of the neurons of a range
+	/*!
+	 *\param first the number of the first neuron of the range
+	 *\param last the number of the neuron following the last neuron of the range
+	 *\return the set of the neurons first, first+1, ..., last-1
+	*/
+	static NeuronSet range(unsigned int long first, unsigned int long last);
+
+
+	//!Method that creates the set of the neurons of a range taken every 'stride' neurons
+	/*!
+	 * throws std::invalid_argument if stride is 0
+	 *\param first the number of the first neuron of the range
+	 *\param last the number of the neuron following the last neuron of the range
+	 *\param stride the gap between two neurons of the set (strictly positive)
+	 *\return the set of the neurons first, first+stride, first+2*stride, ... smaller than last
+	*/
+	static NeuronSet stride(unsigned int long first, unsigned int long last, unsigned int long stride);
+
+
+	//!Method that creates a set of neurons drawn at random (uniformly, without replacement)
+	/*!
+	 *\param count the number of neurons of the set
+	 *\param nbr_neurons the number of neurons of the network
+	 *\param seed the seed of the random generator, so that the same neurons can be drawn again
+	 *\return the set of 'count' neurons among the 'nbr_neurons' neurons of the network
+	*/
+	static NeuronSet random(unsigned int long count, unsigned int long nbr_neurons, unsigned int seed);
+
+
+	//!Method that creates a set from a list of neurons
+	/*!
+	 *\param neurons the numbers of the neurons, in any order and possibly repeated
+	 *\return the set of these neurons
+	*/
+	static NeuronSet list(std::vector<unsigned int long> neurons);
+
+
+	//!Getter for the neurons of the set
+	/*!
+	 *\return the numbers of the neurons of the set, in increasing order and without repetition
+	*/
+	const std::vector<unsigned int long>& getNeurons() const;
+
+
+	//!Getter for the number of neurons of the set
+	/*!
+	 *\return the number of neurons of the set
+	*/
+	size_t size() const;
+
+
+	//!Method that computes the bitmask of the set
+	/*!
+	 * throws std::out_of_range if a neuron of the set is not in the network
+	 *\param nbr_neurons the number of neurons of the network
+	 *\return one bit per neuron of the network (bit i%64 of the word i/64 for the neuron i), set for the neurons of the set
+	*/
+	std::vector<std::uint64_t> mask(unsigned int long nbr_neurons) const;
+
+
+
+	private :
+
+	//!Constructor
+	/*!
+	 *\param neurons_ the numbers of the neurons, in increasing order and without repetition
+	*/
+	NeuronSet(std::vector<unsigned int long> neurons_);
+
+
+	std::vector<unsigned int long> neurons;	//!Numbers of the neurons of the set, in increasing order
+
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "simulationServer.hpp"
+#include "options.hpp"
+#include <iostream>
+#include <atomic>
+#include <csignal>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+std::atomic<bool> stop(false);	//Set by SIGINT and SIGTERM to end the server
+
+
+//Function called by the signals that end the server
+void requestStop(int) {
+	stop=true;
+}
+
+}
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc>1 and (std::string(argv[1])=="--help" or std::string(argv[1])=="-h")) {
+		std::cerr<<"Usage : "<<argv[0]<<" [options]"<<std::endl;
+		std::cerr<<"Runs the simulations sent on a Unix socket by the programs of the machine, keeping the networks between them,"<<std::endl;
+		std::cerr<<"until SIGINT or SIGTERM. A client sends one job per line, for example :"<<std::endl;
+		std::cerr<<"  time=1000 g=5 eta=2 seed=1 [noise-seed=3] [rate-bin=1] [excitatory=10000 inhibitory=2500"<<std::endl;
+		std::cerr<<"  connections-excitatory=1000 connections-inhibitory=250]"<<std::endl;
+		std::cerr<<"and receives the rates of the populations per bin while the job runs, then \"done\" and the JSON summary of the"<<std::endl;
+		std::cerr<<"run, or \"error\" and the message. The jobs of a connection run one after the other, those of different"<<std::endl;
+		std::cerr<<"connections at the same time."<<std::endl;
+		std::cerr<<"  --config file                    reads the options of a file, one line \"name = value\" per option"<<std::endl;
+		std::cerr<<"  --socket file                    name of the socket (default : neurons.sock)"<<std::endl;
+		std::cerr<<"  --processes count                jobs run at the same time (default : one per core)"<<std::endl;
+		std::cerr<<"  --cache count                    networks kept, by size and seed (default : 2, 128 MB each for the paper)"<<std::endl;
+		return 1;
+	}
+
+	try {
+		Options options({"socket", "processes", "cache"});
+		options.parse(argc, argv);
+		const std::string socket_path(options.getString("socket", "neurons.sock"));
+		SimulationServer server(socket_path, options.getInteger("processes", 0), options.getInteger("cache", 2));
+
+		std::signal(SIGINT, requestStop);
+		std::signal(SIGTERM, requestStop);
+		std::cout<<"Server : listening on "<<socket_path<<std::endl;
+		server.serve(stop);
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	std::cout<<"Server : stopped"<<std::endl;
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include "populationDensity.hpp"
+#include "meanField.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc<4 or argc>6) {
+		std::cerr<<"Usage : "<<argv[0]<<" time_ms g eta [bin_ms] [output]"<<std::endl;
+		std::cerr<<"Simulates the population rate of the network from the density of the potentials of its neurons,"<<std::endl;
+		std::cerr<<"and writes it in bins of bin_ms (default : 1 ms) in output (default : density_rate.txt),"<<std::endl;
+		std::cerr<<"in the format of the population rates of a spiking run"<<std::endl;
+		return 1;
+	}
+
+	try {
+		const double time(std::stod(argv[1]));
+		const double g(std::stod(argv[2]));
+		const double eta(std::stod(argv[3]));
+		const double bin_width(argc>4 ? std::stod(argv[4]) : 1.0);
+		const std::string output(argc>5 ? argv[5] : "density_rate.txt");
+		if(!(time>=0.0)) {
+			throw std::invalid_argument("The simulation time must be positive");
+		}
+
+		PopulationDensity density(NE, NI, eta, g);
+		const auto start(std::chrono::steady_clock::now());
+		density.run(std::lround(time/h));
+		const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+		density.writeRates(output, bin_width);
+
+		//Mean rate over the second half of the run, after the transient
+		const std::vector<double>& rates(density.getRates());
+		double rate(0.0);
+		for(size_t i(rates.size()/2); i<rates.size(); ++i) {
+			rate+=rates[i];
+		}
+		rate/=std::max<size_t>(1, rates.size()-rates.size()/2);
+
+		std::cout<<"Density : "<<time<<" ms simulated in "<<duration.count()<<" s, rate "<<rate<<" Hz over the second half"
+				 <<" (mean field : "<<MeanField(g, eta).solve().front().rate<<" Hz)"<<std::endl;
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	return 0;
+}
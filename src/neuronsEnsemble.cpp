@@ -0,0 +1,47 @@
+#include "ensemble.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc<5 or argc>7) {
+		std::cerr<<"Usage : "<<argv[0]<<" time_ms g eta trials [processes] [seed]"<<std::endl;
+		std::cerr<<"Runs 'trials' simulations of the same network with the background noise seeds 1, 2, ..., trials,"<<std::endl;
+		std::cerr<<"'processes' at the same time (default : one per core), and writes the spikes of the trial i in trial_i.bin"<<std::endl;
+		return 1;
+	}
+
+	try {
+		const double time(std::stod(argv[1]));
+		const double g(std::stod(argv[2]));
+		const double eta(std::stod(argv[3]));
+		const unsigned int nbr_trials(std::stoul(argv[4]));
+		const unsigned int processes(argc>5 ? std::stoul(argv[5]) : 0);
+		const unsigned int seed(argc>6 ? std::stoul(argv[6]) : 0);
+
+		Ensemble ensemble(time, seed, NE, NI, processes);
+		for(unsigned int i(1); i<=nbr_trials; ++i) {
+			ensemble.addTrial(Trial {g, eta, i, "trial_"+std::to_string(i), 0.0});
+		}
+
+		unsigned int failures(0);
+		for(auto status : ensemble.run()) {
+			failures+=(status!=0);
+		}
+		if(failures>0) {
+			std::cerr<<failures<<" trials failed"<<std::endl;
+			return 1;
+		}
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	std::cout<<"Ensemble : done"<<std::endl;
+
+	return 0;
+}
@@ -0,0 +1,178 @@
+#include "sweep.hpp"
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc>1 and (std::string(argv[1])=="--help" or std::string(argv[1])=="-h")) {
+		std::cerr<<"Usage : "<<argv[0]<<" [options]"<<std::endl;
+		std::cerr<<"Computes the rate, CV, Fano factor, synchrony and regime of the network for each point of a grid of (g, eta)"<<std::endl;
+		std::cerr<<"or of a list of points, with the same connections, and writes them in one table"<<std::endl;
+		std::cerr<<"  --grid g_min g_max g_points eta_min eta_max eta_points"<<std::endl;
+		std::cerr<<"                                   grid of points (default : 1 8 15 0.5 4 8, the diagram of Fig.2)"<<std::endl;
+		std::cerr<<"  --points file                    list of points, one line \"g eta time_ms noise_seed\" per point"<<std::endl;
+		std::cerr<<"  --time time_ms                   simulation time of the points of the grid (default : 1000)"<<std::endl;
+		std::cerr<<"  --transient time_ms              time skipped before computing the statistics (default : 100)"<<std::endl;
+		std::cerr<<"  --noise-seed seed                seed of the background noise of the points of the grid (default : 1)"<<std::endl;
+		std::cerr<<"  --early-stop                     stop the quiescent, saturated or converged points (see stopMonitor.hpp)"<<std::endl;
+		std::cerr<<"  --stop-window width_ms           width of the windows over which the rate is measured (default : 10)"<<std::endl;
+		std::cerr<<"  --quiescence-rate rate_Hz        rate below which a point is quiescent, 0 to disable (default : 0.1)"<<std::endl;
+		std::cerr<<"  --quiescence-time time_ms        time during which a point must stay quiescent (default : 50)"<<std::endl;
+		std::cerr<<"  --saturation-fraction fraction   fraction of 1/Tref above which a point is saturated, 0 to disable (default : 0.5)"<<std::endl;
+		std::cerr<<"  --saturation-time time_ms        time during which a point must stay saturated (default : 50)"<<std::endl;
+		std::cerr<<"  --convergence-tolerance change   relative change below which the statistics converged, 0 to disable (default : 0.01)"<<std::endl;
+		std::cerr<<"  --convergence-windows count      consecutive windows in which the statistics must converge (default : 10)"<<std::endl;
+		std::cerr<<"                                   (each of these options implies --early-stop)"<<std::endl;
+		std::cerr<<"  --predict                        only write the rates predicted by the mean field (see meanField.hpp)"<<std::endl;
+		std::cerr<<"  --seed seed                      seed of the connections (default : drawn)"<<std::endl;
+		std::cerr<<"  --size NE NI CE CI               numbers of excitatory and inhibitory neurons, and of excitatory and"<<std::endl;
+		std::cerr<<"                                   inhibitory connections received by each neuron (default : 10000 2500 1000 250)"<<std::endl;
+		std::cerr<<"  --processes count                number of points computed at the same time (default : one per core)"<<std::endl;
+		std::cerr<<"  --output file                    summary table (default : sweep.csv)"<<std::endl;
+		return 1;
+	}
+
+	try {
+		double grid[6]={1.0, 8.0, 15, 0.5, 4.0, 8};
+		std::string points_file;
+		double time(1000.0);
+		double transient(100.0);
+		unsigned int noise_seed(1);
+		unsigned int seed(0);
+		unsigned int processes(0);
+		std::string output("sweep.csv");
+		NetworkSize size(defaultNetworkSize());
+		StopConditions conditions(defaultStopConditions());
+
+		bool early_stop(false);
+		bool predict(false);
+		bool explicit_grid(false);
+		for(int i(1); i<argc; ++i) {
+			const std::string option(argv[i]);
+			const int nbr_values(option=="--grid" ? 6 : (option=="--size" ? 4 : ((option=="--early-stop" or option=="--predict") ? 0 : 1)));
+			if(i+nbr_values>=argc) {
+				throw std::invalid_argument("Missing value after "+option);
+			}
+
+			if(option=="--grid") {
+				for(int j(0); j<6; ++j) {
+					grid[j]=std::stod(argv[i+1+j]);
+				}
+				explicit_grid=true;
+			} else if(option=="--predict") {
+				predict=true;
+			} else if(option=="--early-stop") {
+				early_stop=true;
+			} else if(option=="--stop-window") {
+				conditions.window=std::stod(argv[i+1]);
+				early_stop=true;
+			} else if(option=="--quiescence-rate") {
+				conditions.quiescence_rate=std::stod(argv[i+1]);
+				early_stop=true;
+			} else if(option=="--quiescence-time") {
+				conditions.quiescence_time=std::stod(argv[i+1]);
+				early_stop=true;
+			} else if(option=="--saturation-fraction") {
+				conditions.saturation_fraction=std::stod(argv[i+1]);
+				early_stop=true;
+			} else if(option=="--saturation-time") {
+				conditions.saturation_time=std::stod(argv[i+1]);
+				early_stop=true;
+			} else if(option=="--convergence-tolerance") {
+				conditions.tolerance=std::stod(argv[i+1]);
+				early_stop=true;
+			} else if(option=="--convergence-windows") {
+				conditions.convergence_windows=std::stoul(argv[i+1]);
+				early_stop=true;
+			} else if(option=="--points") {
+				points_file=argv[i+1];
+			} else if(option=="--time") {
+				time=std::stod(argv[i+1]);
+			} else if(option=="--transient") {
+				transient=std::stod(argv[i+1]);
+			} else if(option=="--noise-seed") {
+				noise_seed=std::stoul(argv[i+1]);
+			} else if(option=="--seed") {
+				seed=std::stoul(argv[i+1]);
+			} else if(option=="--size") {
+				size=NetworkSize {std::stoul(argv[i+1]), std::stoul(argv[i+2]), std::stoul(argv[i+3]), std::stoul(argv[i+4])};
+			} else if(option=="--processes") {
+				processes=std::stoul(argv[i+1]);
+			} else if(option=="--output") {
+				output=argv[i+1];
+			} else {
+				throw std::invalid_argument("Unknown option "+option);
+			}
+			i+=nbr_values;
+		}
+
+		//A list of points replaces the default grid, but not a grid given with --grid
+		const bool use_grid(explicit_grid or points_file.empty());
+
+		Sweep sweep(seed, size.nbr_excitatory, size.nbr_inhibitory, processes, transient);
+		sweep.setNetworkSize(size);
+		if(early_stop) {
+			//The convergence is measured after the transient, like the statistics
+			conditions.min_time=transient;
+			sweep.setStopConditions(conditions);
+		}
+		if(use_grid) {
+			sweep.addGrid(grid[0], grid[1], static_cast<unsigned int>(grid[2]), grid[3], grid[4], static_cast<unsigned int>(grid[5]),
+						  time, noise_seed);
+		}
+		if(!points_file.empty()) {
+			std::ifstream file(points_file);
+			if(file.fail()) {
+				throw std::runtime_error("Cannot open the file "+points_file);
+			}
+			std::string line;
+			while(std::getline(file, line)) {
+				if(line.empty() or line[0]=='#') {
+					continue;
+				}
+				std::istringstream values(line);
+				SweepPoint point;
+				if(!(values>>point.g>>point.eta>>point.time>>point.noise_seed)) {
+					throw std::invalid_argument("Invalid point in "+points_file+" : "+line);
+				}
+				sweep.addPoint(point);
+			}
+		}
+
+		//The mean field gives the rates in a fraction of a millisecond per point
+		if(predict) {
+			const auto start(std::chrono::steady_clock::now());
+			Sweep::writePredictions(output, sweep.getPoints(), size);
+			const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+			std::cout<<"Sweep : "<<sweep.getPoints().size()<<" points predicted in "<<duration.count()<<" s"<<std::endl;
+			return 0;
+		}
+
+		std::cout<<"Sweep : "<<sweep.getPoints().size()<<" points"<<std::endl;
+		const std::vector<SweepResult> results(sweep.run());
+		Sweep::writeTable(output, results, size);
+
+		unsigned int failures(0);
+		for(const auto& result : results) {
+			failures+=(result.status!=0);
+		}
+		if(failures>0) {
+			std::cerr<<failures<<" points failed"<<std::endl;
+			return 1;
+		}
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	std::cout<<"Sweep : done"<<std::endl;
+
+	return 0;
+}
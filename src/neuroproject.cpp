@@ -0,0 +1,252 @@
+#include "neuroproject.h"
+#include "network.hpp"
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+//!Network and configuration behind a handle of the C interface
+struct np_network {
+	NetworkSize size;	//!Numbers of neurons and of connections of the next network
+	double g;	//!Value of g=JI/JE
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	unsigned int seed;	//!Seed asked (0 to draw one)
+	std::unique_ptr<Network> network;	//!Network, created at the first step
+	std::vector<unsigned char> initial_state;	//!State of the network just after its construction, for np_restart
+	std::vector<double> excitatory_rates;	//!Rates of the excitatory population during the last steps
+	std::vector<double> inhibitory_rates;	//!Rates of the inhibitory population during the last steps
+	std::string error;	//!Message of the last error
+};
+
+
+namespace {
+
+//Function that calls a function of the interface, turning its exceptions into error codes
+template<typename Function>
+int guarded(np_network* handle, Function function) {
+	if(handle==nullptr) {
+		return NP_INVALID_ARGUMENT;
+	}
+	handle->error.clear();
+	try {
+		function(*handle);
+		return NP_OK;
+	} catch(const std::invalid_argument& error) {
+		handle->error=error.what();
+		return NP_INVALID_ARGUMENT;
+	} catch(const std::bad_alloc&) {
+		handle->error="Not enough memory for the network";
+		return NP_OUT_OF_MEMORY;
+	} catch(const std::exception& error) {
+		handle->error=error.what();
+		return NP_ERROR;
+	}
+}
+
+
+//Function that creates the network of a handle if it does not exist
+void build(np_network& handle) {
+	if(!handle.network) {
+		handle.network.reset(new Network(handle.size, handle.eta, handle.g/JE, handle.seed));
+		handle.initial_state.clear();
+		handle.network->saveState(handle.initial_state);
+	}
+}
+
+
+//Function that does one step and appends the rates of the populations
+void step(np_network& handle) {
+	Network& network(*handle.network);
+	network.update(0.0);
+	const std::vector<unsigned int long>& spikes(network.getSpikes());
+	const unsigned int long nbr_excitatory(network.getNbrExcitatory());
+	const unsigned int long nbr_inhibitory(network.getNbrNeurons()-nbr_excitatory);
+	const unsigned int long excitatory_spikes(std::lower_bound(spikes.begin(), spikes.end(), nbr_excitatory)-spikes.begin());
+	handle.excitatory_rates.push_back(nbr_excitatory==0 ? 0.0 : excitatory_spikes*1000.0/(nbr_excitatory*h));
+	handle.inhibitory_rates.push_back(nbr_inhibitory==0 ? 0.0 : (spikes.size()-excitatory_spikes)*1000.0/(nbr_inhibitory*h));
+}
+
+}
+
+
+//!Function that gives the version of the library
+int np_api_version(void) {
+	return NP_API_VERSION;
+}
+
+
+//!Function that gives the time step of the networks
+double np_time_step(void) {
+	return h;
+}
+
+
+//!Function that creates a handle
+np_network* np_create(void) {
+	try {
+		return new np_network {defaultNetworkSize(), 5.0, 2.0, 0, nullptr, {}, {}, {}, ""};
+	} catch(const std::exception&) {
+		return nullptr;
+	}
+}
+
+
+//!Function that destroys a handle and its network
+void np_destroy(np_network* network) {
+	delete network;
+}
+
+
+//!Function that gives the message of the last error of a handle
+const char* np_last_error(const np_network* network) {
+	return network==nullptr ? "The handle is NULL" : network->error.c_str();
+}
+
+
+//!Function that sets the numbers of neurons and of connections
+int np_set_size(np_network* network, unsigned long nbr_excitatory, unsigned long nbr_inhibitory,
+				unsigned long connections_excitatory, unsigned long connections_inhibitory) {
+	return guarded(network, [&](np_network& handle) {
+		const NetworkSize size {nbr_excitatory, nbr_inhibitory, connections_excitatory, connections_inhibitory};
+		checkNetworkSize(size);
+		handle.size=size;
+		handle.network.reset();
+		handle.excitatory_rates.clear();
+		handle.inhibitory_rates.clear();
+	});
+}
+
+
+//!Function that sets g and eta
+int np_set_parameters(np_network* network, double g, double eta) {
+	return guarded(network, [&](np_network& handle) {
+		if(!(g>0.0) or !(eta>0.0)) {
+			throw std::invalid_argument("g and eta must be strictly positive");
+		}
+		handle.g=g;
+		handle.eta=eta;
+		if(handle.network) {
+			handle.network->setParameters(eta, g/JE);
+		}
+	});
+}
+
+
+//!Function that sets the seed of the connections and of the background noise
+int np_set_seed(np_network* network, unsigned int seed) {
+	return guarded(network, [&](np_network& handle) {
+		handle.seed=seed;
+		handle.network.reset();
+		handle.excitatory_rates.clear();
+		handle.inhibitory_rates.clear();
+	});
+}
+
+
+//!Function that creates the network of a handle, if it does not exist yet
+int np_build(np_network* network) {
+	return guarded(network, build);
+}
+
+
+//!Function that brings the network back to its state just after its construction
+int np_restart(np_network* network, unsigned int noise_seed) {
+	return guarded(network, [&](np_network& handle) {
+		build(handle);
+		const unsigned char* position(handle.initial_state.data());
+		handle.network->loadState(position, position+handle.initial_state.size());
+		if(noise_seed!=0) {
+			handle.network->reseedNoise(noise_seed);
+		}
+		handle.excitatory_rates.clear();
+		handle.inhibitory_rates.clear();
+	});
+}
+
+
+//!Function that does one step of the network
+int np_step(np_network* network) {
+	return guarded(network, [](np_network& handle) {
+		build(handle);
+		handle.excitatory_rates.clear();
+		handle.inhibitory_rates.clear();
+		step(handle);
+	});
+}
+
+
+//!Function that does several steps of the network
+int np_run(np_network* network, unsigned long nbr_steps, np_spike_callback callback, void* user_data) {
+	return guarded(network, [&](np_network& handle) {
+		build(handle);
+		handle.excitatory_rates.clear();
+		handle.inhibitory_rates.clear();
+		handle.excitatory_rates.reserve(nbr_steps);
+		handle.inhibitory_rates.reserve(nbr_steps);
+		for(unsigned long i(0); i<nbr_steps; ++i) {
+			const unsigned int long clock(handle.network->getClock());
+			step(handle);
+			if(callback!=nullptr) {
+				const std::vector<unsigned int long>& spikes(handle.network->getSpikes());
+				callback(user_data, clock, spikes.data(), spikes.size());
+			}
+		}
+	});
+}
+
+
+//!Function that gives the spikes of the last step, without copy
+int np_spikes(const np_network* network, const unsigned long** neurons, size_t* count) {
+	if(network==nullptr or neurons==nullptr or count==nullptr) {
+		return NP_INVALID_ARGUMENT;
+	}
+	*neurons=nullptr;
+	*count=0;
+	if(network->network) {
+		*neurons=network->network->getSpikes().data();
+		*count=network->network->getSpikes().size();
+	}
+	return NP_OK;
+}
+
+
+//!Function that gives the rates of the populations during the steps of the last np_step or np_run, without copy
+int np_rates(const np_network* network, const double** excitatory, const double** inhibitory, size_t* nbr_steps) {
+	if(network==nullptr or excitatory==nullptr or inhibitory==nullptr or nbr_steps==nullptr) {
+		return NP_INVALID_ARGUMENT;
+	}
+	*excitatory=network->excitatory_rates.data();
+	*inhibitory=network->inhibitory_rates.data();
+	*nbr_steps=network->excitatory_rates.size();
+	return NP_OK;
+}
+
+
+//!Function that gives the clock of the network
+unsigned long np_clock(const np_network* network) {
+	return (network==nullptr or !network->network) ? 0 : network->network->getClock();
+}
+
+
+//!Function that gives the number of neurons
+unsigned long np_nbr_neurons(const np_network* network) {
+	return network==nullptr ? 0 : network->size.nbr_excitatory+network->size.nbr_inhibitory;
+}
+
+
+//!Function that gives the number of excitatory neurons
+unsigned long np_nbr_excitatory(const np_network* network) {
+	return network==nullptr ? 0 : network->size.nbr_excitatory;
+}
+
+
+//!Function that gives the seed of the network
+unsigned int np_seed(const np_network* network) {
+	if(network==nullptr) {
+		return 0;
+	}
+	return network->network ? network->network->getSeed() : network->seed;
+}
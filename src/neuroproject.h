@@ -0,0 +1,217 @@
+//! C interface of the library libneuroproject
+/*!To create, configure and run networks inside another program, without starting Neurons and without files
+ *
+ * The network is hidden behind the handle np_network, and every function has plain C types, so that the interface can be
+ * used from C, from C++ compiled with another compiler, or from any language that calls C (Python ctypes, Julia...).
+ * The functions that can fail return NP_OK or an error code, the message of the error being given by np_last_error.
+ * The spikes and the rates are given without copy : the pointers stay valid until the next call that changes the handle.
+ * A handle must not be used by two threads at the same time, but different handles can run in parallel.
+ */
+#ifndef NEUROPROJECT_H
+#define NEUROPROJECT_H
+#include <stddef.h>
+
+#if defined(__GNUC__)
+#define NP_API __attribute__((visibility("default")))
+#else
+#define NP_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define NP_API_VERSION 1	//!Version of the interface, changed only when a function changes
+
+#define NP_OK 0	//!No error
+#define NP_INVALID_ARGUMENT 1	//!A parameter is not valid (the handle is not changed)
+#define NP_OUT_OF_MEMORY 2	//!The network does not fit in memory
+#define NP_ERROR 3	//!Other error
+
+
+typedef struct np_network np_network;	//!Handle of a network and of its configuration
+
+
+//!Type of the functions called by np_run after each step
+/*!
+ *\param user_data the pointer given to np_run
+ *\param step the step that was just done (the clock of the network before the step)
+ *\param neurons the numbers of the neurons that spiked during the step, in increasing order, valid during the call only
+ *\param count the number of neurons that spiked
+*/
+typedef void (*np_spike_callback)(void* user_data, unsigned long step, const unsigned long* neurons, size_t count);
+
+
+//!Function that gives the version of the library
+/*!
+ *\return NP_API_VERSION of the library, to compare with the one of the header
+*/
+NP_API int np_api_version(void);
+
+
+//!Function that gives the time step of the networks
+/*!
+ *\return the time step h in ms
+*/
+NP_API double np_time_step(void);
+
+
+//!Function that creates a handle
+/*!
+ * the handle has the size of the network of the paper (10000 excitatory and 2500 inhibitory neurons, CE=1000, CI=250),
+   g=5, eta=2 and a drawn seed ; the network itself is created by np_build or by the first step
+ *\return the handle, or NULL if there is not enough memory
+*/
+NP_API np_network* np_create(void);
+
+
+//!Function that destroys a handle and its network
+/*!
+ *\param network the handle (nothing is done if it is NULL)
+*/
+NP_API void np_destroy(np_network* network);
+
+
+//!Function that gives the message of the last error of a handle
+/*!
+ *\param network the handle
+ *\return the message of the last error ("" if none), valid until the next call with the handle
+*/
+NP_API const char* np_last_error(const np_network* network);
+
+
+//!Function that sets the numbers of neurons and of connections
+/*!
+ * the network is created again at the next step if it already exists, and the rates of the old network are removed
+ *\param network the handle
+ *\param nbr_excitatory the number of excitatory neurons (the first neurons of the network)
+ *\param nbr_inhibitory the number of inhibitory neurons
+ *\param connections_excitatory the number of excitatory connections received by each neuron (CE)
+ *\param connections_inhibitory the number of inhibitory connections received by each neuron (CI)
+ *\return NP_OK, or NP_INVALID_ARGUMENT if the size is not valid
+*/
+NP_API int np_set_size(np_network* network, unsigned long nbr_excitatory, unsigned long nbr_inhibitory,
+					   unsigned long connections_excitatory, unsigned long connections_inhibitory);
+
+
+//!Function that sets g and eta
+/*!
+ * an existing network keeps its connections and its state, and continues with the new values
+ *\param network the handle
+ *\param g the value of g=JI/JE
+ *\param eta the value of eta=Nu_ext/Nu_thr
+ *\return NP_OK, or NP_INVALID_ARGUMENT if g or eta is not strictly positive
+*/
+NP_API int np_set_parameters(np_network* network, double g, double eta);
+
+
+//!Function that sets the seed of the connections and of the background noise
+/*!
+ * the network is created again at the next step if it already exists, and the rates of the old network are removed
+ *\param network the handle
+ *\param seed the seed (0 to draw one)
+ *\return NP_OK
+*/
+NP_API int np_set_seed(np_network* network, unsigned int seed);
+
+
+//!Function that creates the network of a handle, if it does not exist yet
+/*!
+ * to separate the time of the construction from the time of the steps ; the steps create the network themselves
+ *\param network the handle
+ *\return NP_OK, or an error code
+*/
+NP_API int np_build(np_network* network);
+
+
+//!Function that brings the network back to its state just after its construction
+/*!
+ * to run many trials with the same connections without creating them again
+ *\param network the handle
+ *\param noise_seed the new seed of the background noise (0 to draw the same noise as the first trial)
+ *\return NP_OK, or an error code
+*/
+NP_API int np_restart(np_network* network, unsigned int noise_seed);
+
+
+//!Function that does one step of the network
+/*!
+ * the spikes of the step are then given by np_spikes, and the rates of the step by np_rates
+ *\param network the handle
+ *\return NP_OK, or an error code
+*/
+NP_API int np_step(np_network* network);
+
+
+//!Function that does several steps of the network
+/*!
+ * the rates of all the steps are then given by np_rates, and the spikes of the last step by np_spikes
+ *\param network the handle
+ *\param nbr_steps the number of steps
+ *\param callback the function called after each step with its spikes (NULL for none)
+ *\param user_data the pointer given to the callback
+ *\return NP_OK, or an error code
+*/
+NP_API int np_run(np_network* network, unsigned long nbr_steps, np_spike_callback callback, void* user_data);
+
+
+//!Function that gives the spikes of the last step, without copy
+/*!
+ *\param network the handle
+ *\param neurons set to the numbers of the neurons that spiked, in increasing order (valid until the next step)
+ *\param count set to the number of neurons that spiked (0 before the first step)
+ *\return NP_OK, or NP_INVALID_ARGUMENT if a pointer is NULL
+*/
+NP_API int np_spikes(const np_network* network, const unsigned long** neurons, size_t* count);
+
+
+//!Function that gives the rates of the populations during the steps of the last np_step or np_run, without copy
+/*!
+ * the rate of a population during a step is its number of spikes divided by its number of neurons and by h
+ *\param network the handle
+ *\param excitatory set to the rates in Hz of the excitatory population, one per step (valid until the next step)
+ *\param inhibitory set to the rates in Hz of the inhibitory population, one per step
+ *\param nbr_steps set to the number of steps
+ *\return NP_OK, or NP_INVALID_ARGUMENT if a pointer is NULL
+*/
+NP_API int np_rates(const np_network* network, const double** excitatory, const double** inhibitory, size_t* nbr_steps);
+
+
+//!Function that gives the clock of the network
+/*!
+ *\param network the handle
+ *\return the number of steps done since the construction (or the restart) of the network
+*/
+NP_API unsigned long np_clock(const np_network* network);
+
+
+//!Function that gives the number of neurons
+/*!
+ *\param network the handle
+ *\return the number of neurons of the network
+*/
+NP_API unsigned long np_nbr_neurons(const np_network* network);
+
+
+//!Function that gives the number of excitatory neurons
+/*!
+ *\param network the handle
+ *\return the number of excitatory neurons, which are the first neurons of the network
+*/
+NP_API unsigned long np_nbr_excitatory(const np_network* network);
+
+
+//!Function that gives the seed of the network
+/*!
+ *\param network the handle
+ *\return the seed of the network (the drawn one once the network exists), with which it can be created again
+*/
+NP_API unsigned int np_seed(const np_network* network);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+#include "options.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+//Function that removes the spaces at both ends of a text
+std::string trim(const std::string& text) {
+	const size_t first(text.find_first_not_of(" \t\r"));
+	if(first==std::string::npos) {
+		return "";
+	}
+	return text.substr(first, text.find_last_not_of(" \t\r")-first+1);
+}
+
+}
+
+
+//!Constructor
+Options::Options(const std::vector<std::string>& names_) : names(names_) {}
+
+
+//!Method that reads a configuration file
+void Options::readFile(const std::string& filename) {
+
+	std::ifstream file(filename);
+	if(file.fail()) {
+		throw std::runtime_error("Cannot open the file "+filename);
+	}
+
+	std::string line;
+	unsigned int number(0);
+	while(std::getline(file, line)) {
+		++number;
+		line=trim(line);
+		if(line.empty() or line[0]=='#') {
+			continue;
+		}
+		const size_t equal(line.find('='));
+		if(equal==std::string::npos or trim(line.substr(0, equal)).empty() or trim(line.substr(equal+1)).empty()) {
+			throw std::invalid_argument(filename+":"+std::to_string(number)+" : expected \"name = value\"");
+		}
+		set(trim(line.substr(0, equal)), trim(line.substr(equal+1)));
+	}
+}
+
+
+//!Method that reads the options of the command line
+void Options::parse(int argc, char** argv) {
+
+	for(int i(1); i<argc; ++i) {
+		const std::string option(argv[i]);
+		if(option.compare(0, 2, "--")!=0) {
+			throw std::invalid_argument("Unexpected argument "+option);
+		}
+		if(i+1>=argc) {
+			throw std::invalid_argument("Missing value after "+option);
+		}
+		if(option=="--config") {
+			readFile(argv[i+1]);
+		} else {
+			set(option.substr(2), argv[i+1]);
+		}
+		++i;
+	}
+}
+
+
+//!Method that gives a value to a parameter
+void Options::set(const std::string& name, const std::string& value) {
+	if(std::find(names.begin(), names.end(), name)==names.end()) {
+		throw std::invalid_argument("Unknown parameter "+name);
+	}
+	values[name]=value;
+}
+
+
+//!Method that tells if a parameter was given
+bool Options::has(const std::string& name) const {
+	return values.count(name)>0;
+}
+
+
+//!Getter for a parameter as text
+std::string Options::getString(const std::string& name, const std::string& default_value) const {
+	const auto value(values.find(name));
+	return (value==values.end()) ? default_value : value->second;
+}
+
+
+//!Getter for a parameter as a number
+double Options::getDouble(const std::string& name, double default_value) const {
+
+	const auto value(values.find(name));
+	if(value==values.end()) {
+		return default_value;
+	}
+
+	//The whole value must be read, so that "2.5ms" or "1,5" is not taken for a number
+	size_t end(0);
+	double number(0.0);
+	try {
+		number=std::stod(value->second, &end);
+	} catch(const std::exception&) {
+		end=0;
+	}
+	if(end==0 or end!=value->second.size()) {
+		throw std::invalid_argument("The value of "+name+" is not a number : "+value->second);
+	}
+	return number;
+}
+
+
+//!Getter for a parameter as a positive integer
+unsigned int long Options::getInteger(const std::string& name, unsigned int long default_value) const {
+
+	const auto value(values.find(name));
+	if(value==values.end()) {
+		return default_value;
+	}
+
+	//std::stoul would accept a sign, and wrap the negative values
+	const std::string& text(value->second);
+	if(text.empty() or text.size()>19 or !std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c))!=0; })) {
+		throw std::invalid_argument("The value of "+name+" is not a positive integer : "+text);
+	}
+	return std::stoul(text);
+}
+
+
+//!Getter for a parameter as a seed of the random generators
+unsigned int Options::getSeed(const std::string& name, unsigned int default_value) const {
+
+	//A larger value would be cut to its low bits, and give the network of another seed
+	const unsigned int long seed(getInteger(name, default_value));
+	if(seed>std::numeric_limits<unsigned int>::max()) {
+		throw std::invalid_argument("The value of "+name+" is larger than the largest seed ("
+									+std::to_string(std::numeric_limits<unsigned int>::max())+") : "+values.at(name));
+	}
+	return seed;
+}
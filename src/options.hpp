@@ -0,0 +1,109 @@
+//! Options class
+/*!To read the parameters of a program from configuration files and from the command line
+ *
+ * A configuration file has one "name = value" per line, the empty lines and the lines starting with '#' being ignored.
+ * On the command line, "--name value" gives the same parameter, and "--config file" reads a configuration file : the
+ * parameters are read in their order, so that an option given after a file replaces the value of the file.
+ * Only the names given to the constructor are accepted, so that a misspelt name is an error instead of being ignored.
+ */
+#ifndef OPTIONS_H
+#define OPTIONS_H
+#include <map>
+#include <string>
+#include <vector>
+
+
+
+class Options {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param names_ the names of the parameters that can be given (without the "--" of the command line)
+	*/
+	Options(const std::vector<std::string>& names_);
+
+
+	//!Method that reads a configuration file
+	/*!
+	 * throws std::runtime_error if the file cannot be read, std::invalid_argument if a line is not valid
+	 *\param filename the name of the file
+	*/
+	void readFile(const std::string& filename);
+
+
+	//!Method that reads the options of the command line
+	/*!
+	 * throws std::invalid_argument if an option is unknown or has no value
+	 *\param argc the number of arguments, the first one being the name of the program
+	 *\param argv the arguments
+	*/
+	void parse(int argc, char** argv);
+
+
+	//!Method that gives a value to a parameter
+	/*!
+	 * throws std::invalid_argument if the name is not one of the parameters
+	 *\param name the name of the parameter
+	 *\param value its value, replacing the previous one
+	*/
+	void set(const std::string& name, const std::string& value);
+
+
+	//!Method that tells if a parameter was given
+	/*!
+	 *\param name the name of the parameter
+	 *\return true if a value was given to the parameter
+	*/
+	bool has(const std::string& name) const;
+
+
+	//!Getter for a parameter as text
+	/*!
+	 *\param name the name of the parameter
+	 *\param default_value the value if the parameter was not given
+	 *\return the value of the parameter
+	*/
+	std::string getString(const std::string& name, const std::string& default_value) const;
+
+
+	//!Getter for a parameter as a number
+	/*!
+	 * throws std::invalid_argument if the value is not a number
+	 *\param name the name of the parameter
+	 *\param default_value the value if the parameter was not given
+	 *\return the value of the parameter
+	*/
+	double getDouble(const std::string& name, double default_value) const;
+
+
+	//!Getter for a parameter as a positive integer
+	/*!
+	 * throws std::invalid_argument if the value is not a positive integer
+	 *\param name the name of the parameter
+	 *\param default_value the value if the parameter was not given
+	 *\return the value of the parameter
+	*/
+	unsigned int long getInteger(const std::string& name, unsigned int long default_value) const;
+
+
+	//!Getter for a parameter as a seed of the random generators
+	/*!
+	 * throws std::invalid_argument if the value is not a positive integer or does not fit in an unsigned int
+	 *\param name the name of the parameter
+	 *\param default_value the value if the parameter was not given
+	 *\return the value of the parameter
+	*/
+	unsigned int getSeed(const std::string& name, unsigned int default_value) const;
+
+
+
+	private :
+
+	std::vector<std::string> names;	//!Names of the parameters that can be given
+	std::map<std::string, std::string> values;	//!Value of each parameter given
+
+};
+
+#endif
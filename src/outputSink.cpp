@@ -0,0 +1,534 @@
+#include "outputSink.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#ifndef O_DIRECT
+#define O_DIRECT 0	//The blocks are still written aligned, but through the page cache
+#endif
+
+
+namespace {
+
+const size_t block_size(1<<20);	//Size of the blocks written by PwriteSink and UringSink
+const size_t alignment(4096);	//Alignment of the buffers, sizes and offsets required by O_DIRECT
+const unsigned int nbr_buffers(4);	//Number of registered buffers of UringSink, ie maximal number of writes in flight
+
+
+//Rounding of a size up to the alignment of O_DIRECT
+size_t alignSize(size_t size) {
+	return (size+alignment-1)/alignment*alignment;
+}
+
+
+//Allocation of a block aligned for O_DIRECT
+char* allocateBlock() {
+	void* block(nullptr);
+	if(posix_memalign(&block, alignment, block_size)!=0) {
+		throw std::bad_alloc();
+	}
+	return static_cast<char*>(block);
+}
+
+
+//Opening of a file for writing, with O_DIRECT if possible
+int openFile(const std::string& filename, bool& direct) {
+
+	int fd(::open(filename.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_DIRECT, 0644));
+	direct=(fd>=0 and O_DIRECT!=0);
+
+	//Some file systems (tmpfs for example) do not support O_DIRECT
+	if(fd<0 and errno==EINVAL) {
+		fd=::open(filename.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+	}
+	if(fd<0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot open "+filename);
+	}
+	return fd;
+}
+
+
+#ifdef HAVE_IO_URING
+
+//System calls of io_uring (there is no wrapper in the C library)
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+	return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ring_fd, unsigned opcode, const void* arg, unsigned nr_args) {
+	return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+#endif
+
+}
+
+
+//!Function that gives the backend corresponding to a name
+SinkBackend sinkBackendFromName(const std::string& name) {
+	if(name=="stream") {
+		return SinkBackend::Stream;
+	}
+	if(name=="pwrite") {
+		return SinkBackend::Pwrite;
+	}
+	if(name=="uring") {
+		return SinkBackend::Uring;
+	}
+	throw std::invalid_argument("Unknown output backend "+name+" (stream, pwrite or uring)");
+}
+
+
+//!Destructor
+OutputSink::~OutputSink() {}
+
+
+//!Function that creates a sink
+std::unique_ptr<OutputSink> makeSink(const std::string& filename, SinkBackend backend) {
+
+	switch(backend) {
+
+		case SinkBackend::Stream :
+			return std::unique_ptr<OutputSink>(new StreamSink(filename));
+
+		case SinkBackend::Pwrite :
+			return std::unique_ptr<OutputSink>(new PwriteSink(filename));
+
+		case SinkBackend::Uring :
+			try {
+				return std::unique_ptr<OutputSink>(new UringSink(filename));
+			} catch(const std::system_error& error) {
+				//Old kernels, seccomp filters or file systems without O_DIRECT
+				std::cerr<<"io_uring not available for "<<filename<<" ("<<error.what()<<"), using pwrite"<<std::endl;
+				return std::unique_ptr<OutputSink>(new PwriteSink(filename));
+			}
+	}
+
+	throw std::invalid_argument("Unknown output backend");
+}
+
+
+
+//!Constructor
+StreamSink::StreamSink(const std::string& filename) : output_file(filename, std::ios::binary) {
+	if(!output_file) {
+		throw std::runtime_error("Cannot open "+filename);
+	}
+}
+
+
+//!Method that appends bytes at the end of the file
+void StreamSink::write(const char* data, size_t size) {
+	output_file.write(data, size);
+}
+
+
+//!Method that closes the file
+void StreamSink::close() {
+	output_file.close();
+}
+
+
+
+//!Constructor
+PwriteSink::PwriteSink(const std::string& filename)
+: fd(-1), direct(false), buffer(nullptr), filled(0), offset(0)
+{
+	fd=openFile(filename, direct);
+	buffer=allocateBlock();
+}
+
+
+//!Destructor
+PwriteSink::~PwriteSink() {
+	if(fd>=0) {
+		try {
+			close();
+		} catch(const std::exception& error) {
+			std::cerr<<error.what()<<std::endl;
+		}
+	}
+	free(buffer);
+}
+
+
+//!Method that appends bytes at the end of the file
+void PwriteSink::write(const char* data, size_t size) {
+
+	while(size>0) {
+		const size_t copied(std::min(size, block_size-filled));
+		std::memcpy(buffer+filled, data, copied);
+		filled+=copied;
+		data+=copied;
+		size-=copied;
+
+		if(filled==block_size) {
+			writeBlock(block_size);
+		}
+	}
+}
+
+
+//!Method that writes the last block and closes the file
+void PwriteSink::close() {
+
+	if(fd<0) {
+		return;
+	}
+
+	const unsigned int long size(offset+filled);
+	if(filled>0) {
+		writeBlock(filled);
+	}
+
+	//With O_DIRECT, the last block was padded to the alignment
+	if(direct and ftruncate(fd, size)!=0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot truncate the output file");
+	}
+
+	::close(fd);
+	fd=-1;
+}
+
+
+//!Method that writes the block of the buffer at the end of the file
+void PwriteSink::writeBlock(size_t size) {
+
+	const size_t written_size(direct ? alignSize(size) : size);
+	std::memset(buffer+size, 0, written_size-size);
+
+	size_t written(0);
+	while(written<written_size) {
+		const ssize_t result(pwrite(fd, buffer+written, written_size-written, offset+written));
+		if(result<0) {
+			if(errno==EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), "Cannot write the output file");
+		}
+		written+=result;
+	}
+
+	offset+=size;
+	filled=0;
+}
+
+
+
+#ifdef HAVE_IO_URING
+
+//!Constructor
+UringSink::UringSink(const std::string& filename)
+: fd(-1), ring_fd(-1), sq_ring(MAP_FAILED), cq_ring(MAP_FAILED), sqes(MAP_FAILED),
+  sq_ring_size(0), cq_ring_size(0), sqes_size(0), current(0), filled(0), offset(0), size_written(0)
+{
+	fd=::open(filename.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_DIRECT, 0644);
+	if(fd<0) {
+		throw std::system_error(errno, std::generic_category(), "O_DIRECT");
+	}
+
+	io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	ring_fd=ioUringSetup(2*nbr_buffers, &params);
+	if(ring_fd<0) {
+		const int error(errno);
+		release();
+		throw std::system_error(error, std::generic_category(), "io_uring_setup");
+	}
+
+	//Mapping of the rings shared with the kernel
+	sq_ring_size=params.sq_off.array+params.sq_entries*sizeof(unsigned);
+	cq_ring_size=params.cq_off.cqes+params.cq_entries*sizeof(io_uring_cqe);
+	if(params.features&IORING_FEAT_SINGLE_MMAP) {
+		sq_ring_size=std::max(sq_ring_size, cq_ring_size);
+	}
+	sq_ring=mmap(nullptr, sq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+	if(params.features&IORING_FEAT_SINGLE_MMAP) {
+		cq_ring=sq_ring;
+	} else if(sq_ring!=MAP_FAILED) {
+		cq_ring=mmap(nullptr, cq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+	}
+	sqes_size=params.sq_entries*sizeof(io_uring_sqe);
+	sqes=mmap(nullptr, sqes_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+	if(sq_ring==MAP_FAILED or cq_ring==MAP_FAILED or sqes==MAP_FAILED) {
+		const int error(errno);
+		release();
+		throw std::system_error(error, std::generic_category(), "io_uring mmap");
+	}
+
+	char* sq(static_cast<char*>(sq_ring));
+	char* cq(static_cast<char*>(cq_ring));
+	sq_tail=reinterpret_cast<unsigned*>(sq+params.sq_off.tail);
+	sq_mask=reinterpret_cast<unsigned*>(sq+params.sq_off.ring_mask);
+	sq_array=reinterpret_cast<unsigned*>(sq+params.sq_off.array);
+	cq_head=reinterpret_cast<unsigned*>(cq+params.cq_off.head);
+	cq_tail=reinterpret_cast<unsigned*>(cq+params.cq_off.tail);
+	cq_mask=reinterpret_cast<unsigned*>(cq+params.cq_off.ring_mask);
+	cqes=cq+params.cq_off.cqes;
+
+	//The buffers are registered once, so that the kernel does not map them at each write
+	std::vector<iovec> iovecs;
+	for(unsigned int i(0); i<nbr_buffers; ++i) {
+		buffers.push_back(allocateBlock());
+		iovecs.push_back(iovec {buffers.back(), block_size});
+	}
+	if(ioUringRegister(ring_fd, IORING_REGISTER_BUFFERS, iovecs.data(), nbr_buffers)<0) {
+		const int error(errno);
+		release();
+		throw std::system_error(error, std::generic_category(), "io_uring_register");
+	}
+
+	for(unsigned int i(1); i<nbr_buffers; ++i) {
+		free_buffers.push_back(i);
+	}
+	current=0;
+}
+
+
+//!Destructor
+UringSink::~UringSink() {
+	if(fd>=0) {
+		try {
+			close();
+		} catch(const std::exception& error) {
+			std::cerr<<error.what()<<std::endl;
+		}
+	}
+	release();
+}
+
+
+//!Method that appends bytes at the end of the file
+void UringSink::write(const char* data, size_t size) {
+
+	size_written+=size;
+
+	while(size>0) {
+		const size_t copied(std::min(size, block_size-filled));
+		std::memcpy(buffers[current]+filled, data, copied);
+		filled+=copied;
+		data+=copied;
+		size-=copied;
+
+		if(filled==block_size) {
+			submit(block_size);
+		}
+	}
+}
+
+
+//!Method that submits the last block, waits for all the writes and closes the file
+void UringSink::close() {
+
+	if(fd<0) {
+		return;
+	}
+
+	if(filled>0) {
+		submit(filled);
+	}
+	while(free_buffers.size()+1<buffers.size()) {	//The current buffer is not in free_buffers
+		waitCompletion();
+	}
+
+	//The last block was padded to the alignment
+	if(ftruncate(fd, size_written)!=0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot truncate the output file");
+	}
+
+	::close(fd);
+	fd=-1;
+}
+
+
+//!Method that submits the current buffer at the end of the file and takes a free buffer
+void UringSink::submit(size_t size) {
+
+	const size_t written_size(alignSize(size));
+	std::memset(buffers[current]+size, 0, written_size-size);
+
+	//Filling of the next submission entry (this thread is the only one to write in the submission ring)
+	const unsigned tail(*sq_tail);
+	const unsigned index(tail&*sq_mask);
+	io_uring_sqe* sqe(static_cast<io_uring_sqe*>(sqes)+index);
+	std::memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode=IORING_OP_WRITE_FIXED;
+	sqe->fd=fd;
+	sqe->addr=reinterpret_cast<unsigned long>(buffers[current]);
+	sqe->len=written_size;
+	sqe->off=offset;
+	sqe->buf_index=current;
+	sqe->user_data=(static_cast<unsigned long>(written_size)<<8)|current;
+	sq_array[index]=index;
+	__atomic_store_n(sq_tail, tail+1, __ATOMIC_RELEASE);
+
+	while(ioUringEnter(ring_fd, 1, 0, 0)<0) {
+		if(errno!=EINTR) {
+			throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+		}
+	}
+
+	offset+=size;
+	filled=0;
+
+	//The next block is filled in a free buffer while the kernel writes this one
+	if(free_buffers.empty()) {
+		waitCompletion();
+	}
+	current=free_buffers.back();
+	free_buffers.pop_back();
+}
+
+
+//!Method that waits for the completion of at least one write
+void UringSink::waitCompletion() {
+
+	unsigned head(*cq_head);
+	while(head==__atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+		if(ioUringEnter(ring_fd, 0, 1, IORING_ENTER_GETEVENTS)<0 and errno!=EINTR) {
+			throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+		}
+	}
+
+	const unsigned tail(__atomic_load_n(cq_tail, __ATOMIC_ACQUIRE));
+	for(; head!=tail; ++head) {
+		const io_uring_cqe& cqe(static_cast<io_uring_cqe*>(cqes)[head&*cq_mask]);
+		const size_t buffer(cqe.user_data&0xff);
+		const size_t size(cqe.user_data>>8);
+
+		if(cqe.res<0) {
+			throw std::system_error(-cqe.res, std::generic_category(), "Cannot write the output file");
+		}
+		if(static_cast<size_t>(cqe.res)!=size) {
+			throw std::runtime_error("Short write in the output file");
+		}
+		free_buffers.push_back(buffer);
+	}
+	__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+}
+
+
+//!Method that unmaps the rings and closes the file descriptors
+void UringSink::release() {
+
+	if(sqes!=MAP_FAILED) {
+		munmap(sqes, sqes_size);
+	}
+	if(cq_ring!=MAP_FAILED and cq_ring!=sq_ring) {
+		munmap(cq_ring, cq_ring_size);
+	}
+	if(sq_ring!=MAP_FAILED) {
+		munmap(sq_ring, sq_ring_size);
+	}
+	sqes=cq_ring=sq_ring=MAP_FAILED;
+
+	if(ring_fd>=0) {
+		::close(ring_fd);	//Also unregisters the buffers
+		ring_fd=-1;
+	}
+	if(fd>=0) {
+		::close(fd);
+		fd=-1;
+	}
+
+	for(auto buffer : buffers) {
+		free(buffer);
+	}
+	buffers.clear();
+}
+
+#else
+
+//Without io_uring, the constructor fails and makeSink() uses a PwriteSink
+
+//!Constructor
+UringSink::UringSink(const std::string&) : fd(-1), ring_fd(-1) {
+	throw std::system_error(ENOSYS, std::generic_category(), "io_uring");
+}
+
+//!Destructor
+UringSink::~UringSink() {}
+
+//!Method that appends bytes at the end of the file
+void UringSink::write(const char*, size_t) {}
+
+//!Method that submits the last block, waits for all the writes and closes the file
+void UringSink::close() {}
+
+//!Method that submits the current buffer at the end of the file and takes a free buffer
+void UringSink::submit(size_t) {}
+
+//!Method that waits for the completion of at least one write
+void UringSink::waitCompletion() {}
+
+//!Method that unmaps the rings and closes the file descriptors
+void UringSink::release() {}
+
+#endif
+
+
+
+//!Constructor
+SocketSink::SocketSink(int fd_) : fd(fd_) {}
+
+
+//!Destructor
+SocketSink::~SocketSink() {
+	if(!buffer.empty()) {
+		try {
+			send();
+		} catch(const std::exception&) {}	//The receiver is gone
+	}
+}
+
+
+//!Method that appends bytes to the stream
+void SocketSink::write(const char* data, size_t size) {
+	buffer.append(data, size);
+	if(buffer.size()>=alignment) {
+		send();
+	}
+}
+
+
+//!Method that sends the remaining bytes
+void SocketSink::close() {
+	send();
+}
+
+
+//!Method that sends the bytes of the buffer
+void SocketSink::send() {
+	size_t sent(0);
+	while(sent<buffer.size()) {
+		//MSG_NOSIGNAL : a closed connection gives an error instead of killing the process with SIGPIPE
+		const ssize_t result(::send(fd, buffer.data()+sent, buffer.size()-sent, MSG_NOSIGNAL));
+		if(result<0) {
+			if(errno==EINTR) {
+				continue;
+			}
+			buffer.clear();
+			throw std::system_error(errno, std::generic_category(), "Cannot send the results");
+		}
+		sent+=result;
+	}
+	buffer.clear();
+}
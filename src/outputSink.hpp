@@ -0,0 +1,243 @@
+//! Output sink classes
+/*!To write the recordings in a file, sequentially, with different system interfaces
+ */
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+//!System interface used to write a recording
+enum class SinkBackend {
+	Stream,	//!std::ofstream
+	Pwrite,	//!pwrite with O_DIRECT when the file system supports it
+	Uring	//!io_uring with registered buffers and O_DIRECT, or Pwrite when io_uring is not available
+};
+
+
+//!Function that gives the backend corresponding to a name
+/*!
+ *\param name "stream", "pwrite" or "uring"
+ *\return the corresponding backend (an exception is thrown for an unknown name)
+*/
+SinkBackend sinkBackendFromName(const std::string& name);
+
+
+
+class OutputSink {
+
+	public :
+
+	//!Destructor
+	virtual ~OutputSink();
+
+
+	//!Method that appends bytes at the end of the file
+	/*!
+	 *\param data the bytes to write
+	 *\param size the number of bytes to write
+	*/
+	virtual void write(const char* data, size_t size)=0;
+
+
+	//!Method that writes the remaining bytes and closes the file
+	virtual void close()=0;
+
+};
+
+
+//!Function that creates a sink
+/*!
+ *\param filename the name of the file to create
+ *\param backend the system interface to use
+ *\return the sink
+*/
+std::unique_ptr<OutputSink> makeSink(const std::string& filename, SinkBackend backend);
+
+
+
+//! Sink that writes through std::ofstream
+class StreamSink : public OutputSink {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param filename the name of the file to create
+	*/
+	StreamSink(const std::string& filename);
+
+
+	//!Method that appends bytes at the end of the file
+	virtual void write(const char* data, size_t size) override;
+
+
+	//!Method that closes the file
+	virtual void close() override;
+
+
+
+	private :
+
+	std::ofstream output_file;	//!Written file
+
+};
+
+
+
+//! Sink that writes blocks of 1 MiB with pwrite, with O_DIRECT when the file system supports it
+class PwriteSink : public OutputSink {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param filename the name of the file to create
+	*/
+	PwriteSink(const std::string& filename);
+
+
+	//!Destructor
+	virtual ~PwriteSink();
+
+
+	//!Method that appends bytes at the end of the file
+	virtual void write(const char* data, size_t size) override;
+
+
+	//!Method that writes the last block and closes the file
+	virtual void close() override;
+
+
+
+	private :
+
+	//!Method that writes the block of the buffer at the end of the file
+	/*!
+	 *\param size the number of bytes of the buffer to write (rounded up to the alignment with O_DIRECT)
+	*/
+	void writeBlock(size_t size);
+
+
+	int fd;	//!File descriptor of the written file
+	bool direct;	//!True if the file is opened with O_DIRECT
+	char* buffer;	//!Aligned block being filled
+	size_t filled;	//!Number of bytes of the block already filled
+	unsigned int long offset;	//!Position of the block in the file
+
+};
+
+
+
+//! Sink that submits blocks of 1 MiB to io_uring from registered buffers, with O_DIRECT
+class UringSink : public OutputSink {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * throws std::system_error if io_uring can not be used
+	 *\param filename the name of the file to create
+	*/
+	UringSink(const std::string& filename);
+
+
+	//!Destructor
+	virtual ~UringSink();
+
+
+	//!Method that appends bytes at the end of the file
+	virtual void write(const char* data, size_t size) override;
+
+
+	//!Method that submits the last block, waits for all the writes and closes the file
+	virtual void close() override;
+
+
+
+	private :
+
+	//!Method that submits the current buffer at the end of the file and takes a free buffer
+	/*!
+	 *\param size the number of bytes of the buffer to write (rounded up to the alignment)
+	*/
+	void submit(size_t size);
+
+
+	//!Method that waits for the completion of at least one write
+	void waitCompletion();
+
+
+	//!Method that unmaps the rings and closes the file descriptors
+	void release();
+
+
+	int fd;	//!File descriptor of the written file
+	int ring_fd;	//!File descriptor of the io_uring instance
+	void* sq_ring;	//!Mapping of the submission ring
+	void* cq_ring;	//!Mapping of the completion ring (the same as sq_ring on recent kernels)
+	void* sqes;	//!Mapping of the submission entries
+	size_t sq_ring_size;	//!Size of the mapping of the submission ring
+	size_t cq_ring_size;	//!Size of the mapping of the completion ring
+	size_t sqes_size;	//!Size of the mapping of the submission entries
+	unsigned* sq_tail;	//!Tail of the submission ring
+	unsigned* sq_mask;	//!Mask of the submission ring
+	unsigned* sq_array;	//!Indexes of the submitted entries
+	unsigned* cq_head;	//!Head of the completion ring
+	unsigned* cq_tail;	//!Tail of the completion ring
+	unsigned* cq_mask;	//!Mask of the completion ring
+	void* cqes;	//!Completion entries
+	std::vector<char*> buffers;	//!Registered buffers
+	std::vector<size_t> free_buffers;	//!Indexes of the buffers that are not being written
+	size_t current;	//!Index of the buffer being filled
+	size_t filled;	//!Number of bytes of the current buffer already filled
+	unsigned int long offset;	//!Position of the next block in the file
+	unsigned int long size_written;	//!Number of bytes really given to write (without the padding of the last block)
+
+};
+
+
+//! Sink that sends the bytes on a socket, by blocks of 4 KiB so that the receiver gets them while they are written
+class SocketSink : public OutputSink {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param fd_ the file descriptor of the connected socket (not closed by the sink)
+	*/
+	SocketSink(int fd_);
+
+
+	//!Destructor
+	virtual ~SocketSink();
+
+
+	//!Method that appends bytes to the stream
+	/*!
+	 * throws std::system_error if the receiver closed the connection
+	*/
+	virtual void write(const char* data, size_t size) override;
+
+
+	//!Method that sends the remaining bytes
+	virtual void close() override;
+
+
+
+	private :
+
+	//!Method that sends the bytes of the buffer
+	void send();
+
+
+	int fd;	//!File descriptor of the socket
+	std::string buffer;	//!Bytes not sent yet
+
+};
+
+#endif
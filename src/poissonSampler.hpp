@@ -0,0 +1,69 @@
+//! PoissonSampler class
+/*!To draw the background noise of the neurons : Poisson numbers of a fixed mean, by inversion of a table of the
+ * cumulative distribution, with one 32 bits number of the random generator per draw
+ */
+#ifndef POISSONSAMPLER_H
+#define POISSONSAMPLER_H
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+
+class PoissonSampler {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * computes the cumulative distribution until its tail is smaller than the resolution of the draws (2^-32)
+	 *\param mean_ the mean of the Poisson distribution
+	*/
+	PoissonSampler(double mean_=0.0) : mean(mean_) {
+
+		const double scale(4294967296.0);	//2^32
+		double probability(std::exp(-mean));
+		double cumulative(probability);
+		for(unsigned int k(1); cumulative*scale<scale-1.0 and k<1000; ++k) {
+			thresholds.push_back(static_cast<std::uint64_t>(cumulative*scale));
+			probability*=mean/k;
+			cumulative+=probability;
+		}
+		thresholds.push_back(std::uint64_t(1)<<32);	//Larger than all the draws, so that the search always stops
+	}
+
+
+	//!Getter for the mean of the distribution
+	/*!
+	 *\return the mean of the Poisson distribution
+	*/
+	double getMean() const {
+		return mean;
+	}
+
+
+	//!Method that draws a number
+	/*!
+	 *\param generator a random generator of 32 bits numbers (std::mt19937)
+	 *\return the smallest k such that the draw of the generator is below P(X<=k)
+	*/
+	template<typename Generator>
+	unsigned int operator()(Generator& generator) const {
+		const std::uint64_t draw(static_cast<std::uint32_t>(generator()));
+		unsigned int k(0);
+		while(draw>=thresholds[k]) {
+			++k;
+		}
+		return k;
+	}
+
+
+
+	private :
+
+	double mean;	//!Mean of the distribution
+	std::vector<std::uint64_t> thresholds;	//!P(X<=k)*2^32 for each k, the last one being 2^32
+
+};
+
+#endif
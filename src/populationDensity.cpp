@@ -0,0 +1,207 @@
+#include "populationDensity.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+const double V_reset(0.0);	//Potential of a neuron after its refractory period (see Neuron::update)
+const double smallest_diffusion(1e-12);	//Diffusion used without background noise, to keep the fluxes finite
+const double max_peclet(200.0);	//Largest |Pe| for which exp(Pe) is computed by products from face to face
+
+
+//Function of Bernoulli x/(exp(x)-1), used by the fluxes of Scharfetter-Gummel
+double bernoulli(double x) {
+	return (x==0.0) ? 1.0 : x/std::expm1(x);
+}
+
+}
+
+
+//!Constructor
+PopulationDensity::PopulationDensity(unsigned int long nbr_excitatory_, unsigned int long nbr_inhibitory_, double eta_,
+									 double g_, double dv_, double v_min_)
+: nbr_excitatory(nbr_excitatory_), nbr_inhibitory(nbr_inhibitory_), eta(eta_), g(g_), dv(dv_), v_min(v_min_),
+  reset_cell(0), refractory_steps(0), clock(0)
+{
+	if(!(eta>=0.0) or !(g>=0.0) or !(dv>0.0) or !(v_min<V_reset-dv)) {
+		throw std::invalid_argument("The density needs eta and g positive, cells of positive width and a lowest potential below 0");
+	}
+
+	//The cells fill exactly [v_min, V_thr]
+	const size_t nbr_cells(std::max(2l, std::lround((V_thr-v_min)/dv)));
+	dv=(V_thr-v_min)/nbr_cells;
+	reset_cell=std::min(nbr_cells-1, static_cast<size_t>((V_reset-v_min)/dv));
+
+	//Same test as Neuron::isRefractory : the neuron is refractory while (clock-last spike)*h<Tref
+	while(refractory_steps*h<Tref) {
+		++refractory_steps;
+	}
+
+	density.assign(nbr_cells, 0.0);
+	density[reset_cell]=1.0/dv;
+	refractory.assign(std::max(1ul, refractory_steps), 0.0);
+	lower.resize(nbr_cells);
+	diagonal.resize(nbr_cells);
+	upper.resize(nbr_cells);
+}
+
+
+//!Getter for the clock of the density
+unsigned int long PopulationDensity::getClock() const {
+	return clock;
+}
+
+
+//!Getter for the rate of the network during the last step
+double PopulationDensity::getRate() const {
+	return rates.empty() ? 0.0 : rates.back();
+}
+
+
+//!Getter for the rates of all the steps done
+const std::vector<double>& PopulationDensity::getRates() const {
+	return rates;
+}
+
+
+//!Getter for the density of the potentials
+std::vector<double> PopulationDensity::getDensity() const {
+	std::vector<double> probabilities(density);
+	for(auto& probability : probabilities) {
+		probability*=dv;
+	}
+	return probabilities;
+}
+
+
+//!Getter for the fraction of the neurons that are refractory
+double PopulationDensity::getRefractory() const {
+	double sum(0.0);
+	for(auto probability : refractory) {
+		sum+=probability;
+	}
+	return sum;
+}
+
+
+//!Method that updates the density by one step of h
+void PopulationDensity::update() {
+
+	//Input of the neurons, from the rate of the network one delay earlier (in spikes per ms), as in MeanField
+	const unsigned int long delay_step(delay_steps);
+	const double delayed((clock>=delay_step) ? rates[clock-delay_step]/1000.0 : 0.0);
+	const double nu_ext(eta*V_thr/(CE*J*TAU));
+	const double mu(CE*J*TAU*(nu_ext+delayed*(1.0-g*CI/CE)));
+	const double diffusion(std::max(smallest_diffusion, J*J*CE*(nu_ext+delayed*(1.0+g*g*CI/CE))/2.0));
+
+	//Flux through the face between the cells i-1 and i : k*(B(-Pe)*P[i-1]-B(Pe)*P[i]), with Pe=(mu-V)/TAU*dv/diffusion
+	const size_t nbr_cells(density.size());
+	const double c(h*diffusion/(dv*dv));
+	double below_plus(0.0);	//h/dv*k*B(-Pe) of the face below the current cell (0 : reflecting at v_min)
+	double below_minus(0.0);	//h/dv*k*B(Pe) of the face below the current cell
+
+	//Pe decreases by the same value from one face to the next, so that exp(Pe) is updated by a product instead of
+	//being computed at each face (unless it would overflow)
+	const double first_peclet((mu-(v_min+dv))/TAU*dv/diffusion);
+	const double peclet_step(-dv*dv/(TAU*diffusion));
+	const bool recurrence(std::fabs(first_peclet)<max_peclet and std::fabs(first_peclet+nbr_cells*peclet_step)<max_peclet);
+	const double exp_step(std::exp(peclet_step));
+	double exp_peclet(std::exp(first_peclet));
+
+	for(size_t i(0); i<nbr_cells; ++i) {
+
+		double plus, minus;	//Same coefficients for the face above the cell
+		if(i+1<nbr_cells) {
+			const double peclet(first_peclet+i*peclet_step);
+			if(recurrence) {
+				minus=c*((std::fabs(peclet)<1e-6) ? 1.0-0.5*peclet : peclet/(exp_peclet-1.0));
+				exp_peclet*=exp_step;
+			} else {
+				minus=c*bernoulli(peclet);
+			}
+			plus=minus+c*peclet;	//B(-x) = B(x)+x
+		} else {
+			//Absorbing threshold : the density is 0 at V_thr, half a cell above the center of the last cell
+			const double peclet((mu-V_thr)/TAU*(dv/2.0)/diffusion);
+			plus=2.0*c*(bernoulli(peclet)+peclet);
+			minus=0.0;
+		}
+
+		//Implicit step : P[i]-h/dv*(flux below-flux above) = previous P[i]
+		lower[i]=-below_plus;
+		diagonal[i]=1.0+below_minus+plus;
+		upper[i]=-minus;
+		below_plus=plus;
+		below_minus=minus;
+	}
+
+	//The neurons that left the density refractory_steps steps ago come back at V_reset
+	const size_t slot(clock%refractory.size());
+	density[reset_cell]+=refractory[slot]/dv;
+
+	//Thomas algorithm
+	for(size_t i(1); i<nbr_cells; ++i) {
+		const double factor(lower[i]/diagonal[i-1]);
+		diagonal[i]-=factor*upper[i-1];
+		density[i]-=factor*density[i-1];
+	}
+	density[nbr_cells-1]/=diagonal[nbr_cells-1];
+	for(size_t i(nbr_cells-1); i-->0;) {
+		density[i]=(density[i]-upper[i]*density[i+1])/diagonal[i];
+	}
+
+	//The flux through V_thr is the rate of the network
+	const double left(below_plus*density[nbr_cells-1]*dv);	//Probability that left during the step
+	refractory[slot]=left;
+	rates.push_back(left/h*1000.0);
+
+	++clock;
+}
+
+
+//!Method that updates the density during a number of steps
+void PopulationDensity::run(unsigned int long steps) {
+	rates.reserve(rates.size()+steps);
+	for(unsigned int long i(0); i<steps; ++i) {
+		update();
+	}
+}
+
+
+//!Method that writes the rates in the format of PopulationRateRecorder
+void PopulationDensity::writeRates(const std::string& filename, double bin_width) const {
+
+	std::ofstream file(filename);
+	if(file.fail()) {
+		throw std::runtime_error("Cannot create the file "+filename);
+	}
+
+	file<<"# time (ms)\texcitatory spikes\tinhibitory spikes\texcitatory rate (Hz)\tinhibitory rate (Hz)\n";
+	const unsigned int long bin_steps(std::max(1l, std::lround(bin_width/h)));
+	for(unsigned int long start(0); start<rates.size(); start+=bin_steps) {
+		const unsigned int long end(std::min<unsigned int long>(rates.size(), start+bin_steps));
+		double rate(0.0);
+		for(unsigned int long step(start); step<end; ++step) {
+			rate+=rates[step];
+		}
+		rate/=bin_steps;
+
+		//Expected number of spikes of a population : rate * number of neurons * duration of the bin in s
+		const double duration(bin_steps*h/1000.0);
+		char line[160];
+		std::snprintf(line, sizeof(line), "%.3f\t%.3f\t%.3f\t%.3f\t%.3f\n", start*h, rate*nbr_excitatory*duration,
+					  rate*nbr_inhibitory*duration, rate, rate);
+		file<<line;
+	}
+
+	file.close();
+	if(file.fail()) {
+		throw std::runtime_error("Cannot write the file "+filename);
+	}
+}
@@ -0,0 +1,119 @@
+//! PopulationDensity class
+/*!To simulate the population rate of the network without simulating its neurons, from the density of their potentials
+ *
+ * In the diffusion approximation (see MeanField), the density P(V, t) of the potentials of the neurons follows the
+ * Fokker-Planck equation TAU*dP/dt = d/dV((V-mu)*P) + sigma^2/2*d2P/dV2, where mu and sigma depend on the rate of the
+ * network one delay earlier. The neurons leave the density at V_thr (the flux there is the rate of the network), stay
+ * refractory during Tref, then come back at V_reset = 0. The excitatory and inhibitory neurons receive the same input,
+ * so that one density describes both populations.
+ *
+ * The potentials are discretized in cells of width dv between v_min (reflecting) and V_thr (absorbing), with the fluxes
+ * of Scharfetter-Gummel (exact for a constant drift in a cell, the density stays positive), and each step of h is
+ * implicit (a tridiagonal system), so that it is stable for any dv. The cost of a step depends on the number of cells,
+ * not on the number of neurons.
+ */
+#ifndef POPULATIONDENSITY_H
+#define POPULATIONDENSITY_H
+#include "constants.hpp"
+#include <string>
+#include <vector>
+
+
+
+class PopulationDensity {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * starts with all the potentials at 0, like Network
+	 * throws std::invalid_argument if a value is not valid
+	 *\param nbr_excitatory_ the number of excitatory neurons of the network (used to write the numbers of spikes)
+	 *\param nbr_inhibitory_ the number of inhibitory neurons of the network
+	 *\param eta_ the value of eta=Nu_ext/Nu_thr (positive)
+	 *\param g_ the value of g=JI/JE (positive)
+	 *\param dv_ the width of the cells of the potentials in mV
+	 *\param v_min_ the lowest potential in mV (negative)
+	*/
+	PopulationDensity(unsigned int long nbr_excitatory_, unsigned int long nbr_inhibitory_, double eta_, double g_,
+					  double dv_=0.1, double v_min_=-2.0*V_thr);
+
+
+	//!Getter for the clock of the density
+	/*!
+	 *\return the number of steps done
+	*/
+	unsigned int long getClock() const;
+
+
+	//!Getter for the rate of the network during the last step
+	/*!
+	 *\return the rate of a neuron in Hz
+	*/
+	double getRate() const;
+
+
+	//!Getter for the rates of all the steps done
+	/*!
+	 *\return the rate of a neuron in Hz during each step
+	*/
+	const std::vector<double>& getRates() const;
+
+
+	//!Getter for the density of the potentials
+	/*!
+	 *\return the probability of each cell (the first cell starts at v_min, the last one ends at V_thr)
+	*/
+	std::vector<double> getDensity() const;
+
+
+	//!Getter for the fraction of the neurons that are refractory
+	/*!
+	 *\return the probability that a neuron is refractory (1 minus the sum of the density)
+	*/
+	double getRefractory() const;
+
+
+	//!Method that updates the density by one step of h
+	void update();
+
+
+	//!Method that updates the density during a number of steps
+	/*!
+	 *\param steps the number of steps
+	*/
+	void run(unsigned int long steps);
+
+
+	//!Method that writes the rates in the format of PopulationRateRecorder
+	/*!
+	 * one line "time (ms) \t excitatory spikes \t inhibitory spikes \t excitatory rate (Hz) \t inhibitory rate (Hz)" per bin,
+	 * the numbers of spikes being the expected numbers (not integers)
+	 *\param filename the name of the file
+	 *\param bin_width the width of a bin in ms (rounded to a number of steps, at least one)
+	*/
+	void writeRates(const std::string& filename, double bin_width=h) const;
+
+
+
+	private :
+
+	unsigned int long nbr_excitatory;	//!Number of excitatory neurons
+	unsigned int long nbr_inhibitory;	//!Number of inhibitory neurons
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	double g;	//!Value of g=JI/JE
+	double dv;	//!Width of the cells in mV
+	double v_min;	//!Lowest potential in mV
+	size_t reset_cell;	//!Cell that contains V_reset
+	unsigned int long refractory_steps;	//!Duration of the refractory period in steps
+	unsigned int long clock;	//!Number of steps done
+	std::vector<double> density;	//!Probability density of the potential in each cell (1/mV)
+	std::vector<double> refractory;	//!Probability that left the density at each of the last refractory_steps steps
+	std::vector<double> rates;	//!Rate of the network during each step in Hz
+	std::vector<double> lower;	//!Lower diagonal of the system of a step
+	std::vector<double> diagonal;	//!Diagonal of the system of a step
+	std::vector<double> upper;	//!Upper diagonal of the system of a step
+
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include "preciseNetwork.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+//Function that computes exp(-duration/TAU) for 0 <= duration <= delay, with a relative error below 1e-9
+inline double decay(double duration) {
+	const double x(-duration/TAU);
+	return 1.0+x*(1.0+x/2.0*(1.0+x/3.0*(1.0+x/4.0*(1.0+x/5.0*(1.0+x/6.0)))));
+}
+
+}
+
+
+//!Constructor
+PreciseNetwork::PreciseNetwork(const Network& network, double eta_, double g_, double step_, unsigned int noise_seed)
+: eta(eta_), g(g_), step(step_), clock(0), nbrNeurons(network.getNbrNeurons()), nbrExcitatory(network.getNbrExcitatory()),
+  offsets(1, 0), potentials(nbrNeurons, 0.0), refractory_ends(nbrNeurons, -Tref),
+  events(static_cast<size_t>(std::floor(delay/step_))+2), received_sums(events.size(), std::vector<Received>(nbrNeurons, Received {0.0f, 0.0f})),
+  marked(nbrNeurons, 0), first_inputs(nbrNeurons, 0), backgrounds(nbrNeurons, 0),
+  step_decay(decay(step_)), background_decay(TAU/step_*(1.0-std::exp(-step_/TAU))), noise(eta_*V_thr*step_/(J*TAU))
+{
+	if(!(step>0.0) or step>delay) {
+		throw std::invalid_argument("The time step must be strictly positive and not larger than the delay");
+	}
+
+	//The targets of all the neurons are stored contiguously
+	for(unsigned int long i(0); i<nbrNeurons; ++i) {
+		for(auto target : network.getNeuron(i).getTargets()) {
+			targets.push_back(target);
+		}
+		offsets.push_back(targets.size());
+	}
+
+	std::seed_seq sequence {noise_seed, 1u};
+	noise_gen.seed(sequence);
+}
+
+
+//!Getter for the clock of the network
+unsigned int long PreciseNetwork::getClock() const {
+	return clock;
+}
+
+
+//!Getter for the time step
+double PreciseNetwork::getStep() const {
+	return step;
+}
+
+
+//!Getter for the number of neurons of the network
+unsigned int long PreciseNetwork::getNbrNeurons() const {
+	return nbrNeurons;
+}
+
+
+//!Getter for the potential of a neuron at the end of the last step
+double PreciseNetwork::getPotential(unsigned int long neuron) const {
+	return potentials[neuron];
+}
+
+
+//!Getter for the neurons that spiked during the last step
+const std::vector<unsigned int long>& PreciseNetwork::getSpikes() const {
+	return spikes;
+}
+
+
+//!Getter for the times of the spikes of the last step
+const std::vector<double>& PreciseNetwork::getSpikeTimes() const {
+	return spike_times;
+}
+
+
+//!Method that updates the network by one step
+void PreciseNetwork::update() {
+
+	spikes.clear();
+	spike_times.clear();
+
+	const double start(clock*step);
+	const double end(start+step);
+	const size_t slot(clock%events.size());
+	std::vector<Received>& received_slot(received_sums[slot]);
+
+	//First the neurons that cannot reach the threshold during the step : the order of their inputs does not matter
+	slow.clear();
+	for(unsigned int long i(0); i<nbrNeurons; ++i) {
+
+		const unsigned int background(noise(noise_gen));
+		double& potential(potentials[i]);
+
+		if(refractory_ends[i]>=end) {
+			potential=0.0;	//Refractory during the whole step : the inputs are lost
+		} else if(refractory_ends[i]<=start and std::max(potential, 0.0)+received_slot[i].excitation+J*JE*background<=V_thr) {
+			potential=potential*step_decay+received_slot[i].decayed+J*JE*background*background_decay;
+		} else {
+			slow.push_back(i);
+			backgrounds[i]=background;
+		}
+		received_slot[i]=Received {0.0f, 0.0f};
+	}
+
+	//The recurrent inputs of the other neurons are gathered from the spikes that arrive, in the order of their times, and
+	//grouped by neuron (stable counting sort)
+	std::vector<Event>& arriving(events[slot]);
+	if(!slow.empty()) {
+		std::sort(arriving.begin(), arriving.end(), [](const Event& a, const Event& b) {
+			return a.offset<b.offset;
+		});
+		for(auto neuron : slow) {
+			marked[neuron]=1;
+		}
+		//Without branch : each target is written, and kept only if it is marked
+		unsigned int long total(1);
+		for(const auto& event : arriving) {
+			total+=offsets[event.source+1]-offsets[event.source];
+		}
+		gathered_targets.resize(total);
+		gathered.resize(total);
+		size_t nbr_gathered(0);
+		for(const auto& event : arriving) {
+			const Input input {event.offset, event.weight};
+			for(unsigned int long j(offsets[event.source]); j<offsets[event.source+1]; ++j) {
+				const std::uint32_t target(targets[j]);
+				gathered_targets[nbr_gathered]=target;
+				gathered[nbr_gathered]=input;
+				nbr_gathered+=marked[target];
+				first_inputs[target]+=marked[target];
+			}
+		}
+		unsigned int long position(0);
+		for(auto neuron : slow) {
+			const unsigned int long count(first_inputs[neuron]);
+			first_inputs[neuron]=position;
+			position+=count;
+			marked[neuron]=0;
+		}
+		sorted.resize(position);
+		for(size_t j(0); j<nbr_gathered; ++j) {
+			sorted[first_inputs[gathered_targets[j]]++]=gathered[j];
+		}
+	}
+	arriving.clear();
+
+	//Then their inputs are applied in the order of their times, and a neuron spikes when its potential crosses the threshold
+	const double scale(step/4294967296.0);	//From a 32 bits number to a time in the step
+	const float background_weight(J*JE);
+	unsigned int long first(0);	//Start of the inputs of the neuron in sorted
+	for(auto i : slow) {
+
+		//Times of the background spikes, sorted by insertion (there are few)
+		received.clear();
+		for(unsigned int j(0); j<backgrounds[i]; ++j) {
+			const float offset(static_cast<float>(noise_gen()*scale));
+			received.push_back(Input {offset, background_weight});
+			for(size_t k(received.size()-1); k>0 and received[k-1].offset>offset; --k) {
+				std::swap(received[k-1], received[k]);
+			}
+		}
+
+		double& potential(potentials[i]);
+		double& refractory_end(refractory_ends[i]);
+		double time(start);	//Time of the potential
+		const unsigned int long last(first_inputs[i]);
+		first_inputs[i]=0;
+		size_t next(0);	//Next background spike in received
+		while(first<last or next<received.size()) {
+
+			//Merge of the recurrent and background inputs
+			const Input& input((next==received.size() or (first<last and sorted[first].offset<received[next].offset))
+							   ? sorted[first++] : received[next++]);
+			const double arrival(start+input.offset);
+			if(arrival<refractory_end) {
+				continue;
+			}
+			if(time<refractory_end) {
+				potential=0.0;
+				time=refractory_end;
+			}
+			potential=potential*decay(arrival-time)+input.weight;
+			time=arrival;
+			if(potential>V_thr) {
+				fire(i, arrival);
+				potential=0.0;
+				refractory_end=arrival+Tref;
+			}
+		}
+		potential=(time<refractory_end) ? 0.0 : potential*decay(end-time);
+	}
+
+	++clock;
+}
+
+
+//!Method that runs the network and gives its spikes to recorders
+void PreciseNetwork::run(unsigned int long steps, const std::vector<Recorder*>& recorders) {
+
+	const RunInfo info {step, g, eta, steps, nbrNeurons, nbrExcitatory, 0};
+	for(auto recorder : recorders) {
+		recorder->open(info);
+	}
+
+	for(unsigned int long i(0); i<steps; ++i) {
+		const unsigned int long current(clock);
+		update();
+		for(auto recorder : recorders) {
+			recorder->record(current, spikes);
+		}
+	}
+
+	for(auto recorder : recorders) {
+		recorder->close();
+	}
+}
+
+
+//!Method that sends a spike to the targets of a neuron
+void PreciseNetwork::fire(unsigned int long neuron, double time) {
+
+	spikes.push_back(neuron);
+	spike_times.push_back(time);
+
+	//Same weights as Network : the inhibitory weight is an integer number of JE
+	const float weight(J*(neuron<nbrExcitatory ? JE : static_cast<int>(-g/JE)));
+
+	//The spike reaches its targets one delay later, in a later step since the step is not larger than the delay
+	const double arrival(time+delay);
+	const unsigned int long arrival_step(std::max(clock+1, static_cast<unsigned int long>(arrival/step)));
+	const float offset(std::min(std::max(0.0, arrival-arrival_step*step), std::nextafter(step, 0.0)));
+	events[arrival_step%events.size()].push_back(Event {static_cast<std::uint32_t>(neuron), offset, weight});
+
+	//The sums of the targets are enough for those that cannot reach the threshold
+	std::vector<Received>& received_slot(received_sums[arrival_step%events.size()]);
+	const Received sums {static_cast<float>(weight*decay(step-offset)), std::max(0.0f, weight)};
+	for(unsigned int long j(offsets[neuron]); j<offsets[neuron+1]; ++j) {
+		Received& target(received_slot[targets[j]]);
+		target.decayed+=sums.decayed;
+		target.excitation+=sums.excitation;
+	}
+}
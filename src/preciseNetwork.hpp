@@ -0,0 +1,170 @@
+//! PreciseNetwork class
+/*!To simulate the network with exact spike times, so that the time step can be larger than h
+ *
+ * Between two inputs, the potential of a neuron only decays (the synapses are instantaneous and there is no external
+ * current), so that it can only cross the threshold when it receives an input. Each input has its exact time in the step :
+ * the recurrent spikes arrive one delay after the exact time of their spike, and the background spikes at uniformly drawn
+ * times. The inputs of a neuron are applied in the order of their times, and the neuron spikes at the time of the input
+ * that makes its potential cross the threshold. The step only fixes how often the inputs are grouped, not the precision
+ * of the spike times, so that a step of 0.5 ms gives about the same dynamics as a step of 0.1 ms.
+ *
+ * A neuron whose potential cannot reach the threshold during the step (its potential, or 0 if it is negative since it
+ * then decays towards 0, plus all its excitatory inputs is below V_thr) does not need the order of its inputs : its potential at the end of the step is the sum of the decayed
+ * inputs, the background spikes being counted with their mean decay (their spread in the step changes the potential by
+ * less than 0.01 mV). This is the case of most neurons, so that the times are only drawn and sorted for the others.
+ * The larger the step, the more neurons may reach the threshold during a step : steps of 0.2 to 0.5 ms are the fastest.
+ * The connections and the weights are those of the Network given to the constructor.
+ */
+#ifndef PRECISENETWORK_H
+#define PRECISENETWORK_H
+#include "network.hpp"
+#include "recorder.hpp"
+#include "poissonSampler.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+
+class PreciseNetwork {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * copies the connections of a network, and starts with all the potentials at 0
+	 * throws std::invalid_argument if the step is not between 0 and the delay
+	 *\param network the network whose connections are used
+	 *\param eta_ the value of eta=Nu_ext/Nu_thr
+	 *\param g_ the value of g=JI/JE
+	 *\param step_ the time step in ms (at most the delay, so that a spike never reaches its targets in its own step)
+	 *\param noise_seed the seed of the background noise
+	*/
+	PreciseNetwork(const Network& network, double eta_, double g_, double step_=0.5, unsigned int noise_seed=1);
+
+
+	//!Getter for the clock of the network
+	/*!
+	 *\return the number of steps done
+	*/
+	unsigned int long getClock() const;
+
+
+	//!Getter for the time step
+	/*!
+	 *\return the time step in ms
+	*/
+	double getStep() const;
+
+
+	//!Getter for the number of neurons of the network
+	/*!
+	 *\return the number of neurons
+	*/
+	unsigned int long getNbrNeurons() const;
+
+
+	//!Getter for the potential of a neuron at the end of the last step
+	/*!
+	 *\param neuron the number of the neuron
+	 *\return the membrane potential in mV
+	*/
+	double getPotential(unsigned int long neuron) const;
+
+
+	//!Getter for the neurons that spiked during the last step
+	/*!
+	 *\return the numbers of the neurons that spiked, in increasing order
+	*/
+	const std::vector<unsigned int long>& getSpikes() const;
+
+
+	//!Getter for the times of the spikes of the last step
+	/*!
+	 *\return the time in ms of each spike of getSpikes()
+	*/
+	const std::vector<double>& getSpikeTimes() const;
+
+
+	//!Method that updates the network by one step
+	void update();
+
+
+	//!Method that runs the network and gives its spikes to recorders
+	/*!
+	 * the recorders receive the time step of this network as h, and the number of the step of each spike
+	 *\param steps the number of steps to run
+	 *\param recorders the recorders of the spikes
+	*/
+	void run(unsigned int long steps, const std::vector<Recorder*>& recorders);
+
+
+
+	private :
+
+	//!Input received by a neuron during a step
+	struct Input {
+
+		float offset;	//!Time of the input from the start of the step in ms
+		float weight;	//!Jump of the potential in mV
+
+	};
+
+
+	//!Spike that reaches its targets during a future step
+	struct Event {
+
+		std::uint32_t source;	//!Number of the neuron that spiked
+		float offset;	//!Time of the arrival from the start of its step in ms
+		float weight;	//!Jump of the potential in mV
+
+	};
+
+
+	//!Sums of the spikes that reach a neuron during a future step
+	struct Received {
+
+		float decayed;	//!Sum of the weights, decayed to the end of the step
+		float excitation;	//!Sum of the positive weights
+
+	};
+
+
+	//!Method that sends a spike to the targets of a neuron
+	/*!
+	 *\param neuron the number of the neuron that spiked
+	 *\param time the time of the spike in ms
+	*/
+	void fire(unsigned int long neuron, double time);
+
+
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	double g;	//!Value of g=JI/JE
+	double step;	//!Time step in ms
+	unsigned int long clock;	//!Number of steps done
+	unsigned int long nbrNeurons;	//!Number of neurons
+	unsigned int long nbrExcitatory;	//!Number of excitatory neurons
+	std::vector<unsigned int long> offsets;	//!Position of the targets of each neuron in targets
+	std::vector<std::uint32_t> targets;	//!Targets of all the neurons
+	std::vector<double> potentials;	//!Potential of each neuron at the start of the current step
+	std::vector<double> refractory_ends;	//!Time in ms at which each neuron leaves its refractory period
+	std::vector<std::vector<Event> > events;	//!Spikes that reach the neurons during each of the next steps (ring buffer)
+	std::vector<std::vector<Received> > received_sums;	//!Sums of these spikes for each neuron
+	std::vector<unsigned int long> slow;	//!Neurons that may reach the threshold during the current step
+	std::vector<char> marked;	//!Whether each neuron is in slow
+	std::vector<unsigned int long> first_inputs;	//!Position of the recurrent inputs of each of these neurons in sorted
+	std::vector<unsigned int> backgrounds;	//!Number of background spikes of each of these neurons
+	std::vector<std::uint32_t> gathered_targets;	//!Neuron of each recurrent input of these neurons
+	std::vector<Input> gathered;	//!Recurrent inputs of these neurons, in the order of their times
+	std::vector<Input> sorted;	//!Same inputs, grouped by neuron
+	std::vector<Input> received;	//!Background inputs of the neuron being updated, in the order of their times
+	double step_decay;	//!Decay of the potential during a step
+	double background_decay;	//!Mean decay of a background spike to the end of its step
+	std::vector<unsigned int long> spikes;	//!Neurons that spiked during the last step
+	std::vector<double> spike_times;	//!Times of the spikes of the last step
+	std::mt19937 noise_gen;	//!Random generator of the background noise
+	PoissonSampler noise;	//!Number of background spikes per step
+
+};
+
+#endif
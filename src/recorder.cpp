@@ -0,0 +1,268 @@
+#include "recorder.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+const size_t buffer_size(1<<16);	//Size of the formatted text given to the sink at once
+
+
+//Writing of a number in decimal at the end of a buffer (faster than the operator << of the streams)
+void appendDecimal(std::vector<char>& buffer, unsigned int long value) {
+	char digits[20];
+	size_t nbr_digits(0);
+	do {
+		digits[nbr_digits++]=static_cast<char>('0'+value%10);
+		value/=10;
+	} while(value!=0);
+
+	while(nbr_digits>0) {
+		buffer.push_back(digits[--nbr_digits]);
+	}
+}
+
+}
+
+
+//!Destructor
+Recorder::~Recorder() {}
+
+
+//!Method called once before the first step of the simulation
+void Recorder::open(const RunInfo&) {}
+
+
+//!Method called once after the last step of the simulation
+void Recorder::close() {}
+
+
+//!Method called before close when the simulation stops before its simulation time
+void Recorder::stopEarly(unsigned int long) {}
+
+
+
+//!Constructor
+TextSpikeRecorder::TextSpikeRecorder(const std::string& filename, SinkBackend backend)
+: sink(makeSink(filename, backend))
+{
+	buffer.reserve(buffer_size+64);
+}
+
+
+//!Destructor
+TextSpikeRecorder::~TextSpikeRecorder() {
+	if(sink) {
+		try {
+			close();
+		} catch(const std::exception&) {}	//A destructor called during the unwinding of an error must not throw
+	}
+}
+
+
+//!Method that writes the spikes of a step, one line per spike
+void TextSpikeRecorder::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+
+	for(auto neuron : spikes) {
+		//The neurons are numbered from 1 in the text file
+		appendDecimal(buffer, step);
+		buffer.push_back('\t');
+		appendDecimal(buffer, neuron+1);
+		buffer.push_back('\n');
+		
+		if(buffer.size()>=buffer_size) {
+			sink->write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+}
+
+
+//!Method that writes the end of the buffer and closes the output file
+void TextSpikeRecorder::close() {
+	if(!sink) {
+		return;
+	}
+	sink->write(buffer.data(), buffer.size());
+	buffer.clear();
+	
+	//The sink is released first, so that a sink that fails is not closed again by the destructor
+	std::unique_ptr<OutputSink> closed_sink(std::move(sink));
+	closed_sink->close();
+}
+
+
+
+//!Constructor
+SpikeDevice::SpikeDevice(Recorder& target_, const NeuronSet& neurons_, double start_, double stop_)
+: target(target_), neurons(neurons_), start(start_), stop(stop_), start_step(0), stop_step(0)
+{}
+
+
+//!Method that computes the bitmask of the set and the steps of the window, and opens the target recorder
+void SpikeDevice::open(const RunInfo& info) {
+	
+	mask=neurons.mask(info.nbrNeurons);
+	start_step=std::lround(start/info.h);
+	stop_step=(stop<0.0) ? info.simtime : std::lround(stop/info.h);
+	
+	target.open(info);
+}
+
+
+//!Method that gives the spikes of the set to the target recorder
+void SpikeDevice::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+	
+	if(step<start_step or step>=stop_step) {
+		return;
+	}
+	
+	selected.clear();
+	
+	if(spikes.size()<=neurons.size()) {
+		
+		//Few spikes : each spike is looked up in the bitmask
+		for(auto neuron : spikes) {
+			if(mask[neuron/64]&(std::uint64_t(1)<<(neuron%64))) {
+				selected.push_back(neuron);
+			}
+		}
+		
+	} else {
+		
+		//Small set (50 neurons for a raster) : each neuron of the set is looked for in the spikes, which are in increasing order
+		auto position(spikes.begin());
+		for(auto neuron : neurons.getNeurons()) {
+			position=std::lower_bound(position, spikes.end(), neuron);
+			if(position==spikes.end()) {
+				break;
+			}
+			if(*position==neuron) {
+				selected.push_back(neuron);
+			}
+		}
+		
+	}
+	
+	if(!selected.empty()) {
+		target.record(step, selected);
+	}
+}
+
+
+//!Method that gives the number of steps done to the target recorder
+void SpikeDevice::stopEarly(unsigned int long steps) {
+	target.stopEarly(steps);
+}
+
+
+//!Method that closes the target recorder
+void SpikeDevice::close() {
+	target.close();
+}
+
+
+
+//!Constructor
+PopulationRateRecorder::PopulationRateRecorder(const std::string& filename, double bin_width_, SinkBackend backend)
+: sink(makeSink(filename, backend)), bin_width(bin_width_), info{}, opened(false), bin_steps(1), bin(0), excitatory_spikes(0), inhibitory_spikes(0)
+{}
+
+
+//!Constructor
+PopulationRateRecorder::PopulationRateRecorder(std::unique_ptr<OutputSink> sink_, double bin_width_)
+: sink(std::move(sink_)), bin_width(bin_width_), info{}, opened(false), bin_steps(1), bin(0), excitatory_spikes(0), inhibitory_spikes(0)
+{}
+
+
+//!Destructor
+PopulationRateRecorder::~PopulationRateRecorder() {
+	if(sink) {
+		try {
+			close();
+		} catch(const std::exception&) {}	//A destructor called during the unwinding of an error must not throw
+	}
+}
+
+
+//!Method that computes the number of steps per bin and writes the header line
+void PopulationRateRecorder::open(const RunInfo& info_) {
+	
+	info=info_;
+	opened=true;
+	bin_steps=std::max(1l, std::lround(bin_width/info.h));
+	bin=0;
+	excitatory_spikes=0;
+	inhibitory_spikes=0;
+	
+	const std::string header("# time (ms)\texcitatory spikes\tinhibitory spikes\texcitatory rate (Hz)\tinhibitory rate (Hz)\n");
+	sink->write(header.data(), header.size());
+}
+
+
+//!Method that adds the spikes of a step to the counts of the current bin
+void PopulationRateRecorder::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+	
+	//The bins ended before this step are written, even without spikes
+	while(step>=info.first_step+(bin+1)*bin_steps) {
+		writeBin();
+	}
+	
+	for(auto neuron : spikes) {
+		if(neuron<info.nbrExcitatory) {
+			++excitatory_spikes;
+		} else {
+			++inhibitory_spikes;
+		}
+	}
+}
+
+
+//!Method that makes the last bins end at the last step done
+void PopulationRateRecorder::stopEarly(unsigned int long steps) {
+	info.simtime=steps;
+}
+
+
+//!Method that writes the last bins and closes the file
+void PopulationRateRecorder::close() {
+	
+	if(!sink) {
+		return;
+	}
+	
+	//The bins are written until the end of the simulation time, if the run started
+	while(opened and info.first_step+bin*bin_steps<info.simtime) {
+		writeBin();
+	}
+	
+	//The sink is released first, so that a sink that fails is not closed again by the destructor
+	std::unique_ptr<OutputSink> closed_sink(std::move(sink));
+	closed_sink->close();
+}
+
+
+//!Method that writes the current bin and starts the next one
+void PopulationRateRecorder::writeBin() {
+	
+	//Rate of a population : number of spikes / (number of neurons * duration of the bin in s)
+	const double duration(bin_steps*info.h/1000.0);
+	const unsigned int long nbr_inhibitory(info.nbrNeurons-info.nbrExcitatory);
+	const double excitatory_rate(info.nbrExcitatory>0 ? excitatory_spikes/(info.nbrExcitatory*duration) : 0.0);
+	const double inhibitory_rate(nbr_inhibitory>0 ? inhibitory_spikes/(nbr_inhibitory*duration) : 0.0);
+	
+	char line[128];
+	const int size(std::snprintf(line, sizeof(line), "%.3f\t%lu\t%lu\t%.3f\t%.3f\n", (info.first_step+bin*bin_steps)*info.h,
+								 excitatory_spikes, inhibitory_spikes, excitatory_rate, inhibitory_rate));
+	sink->write(line, size);
+	
+	++bin;
+	excitatory_spikes=0;
+	inhibitory_spikes=0;
+}
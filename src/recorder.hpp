@@ -0,0 +1,241 @@
+//! Recorder classes
+/*!To record what happens in the network during a simulation
+ */
+#ifndef RECORDER_H
+#define RECORDER_H
+#include "constants.hpp"
+#include "outputSink.hpp"
+#include "neuronSet.hpp"
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+//!Parameters of a run, given to the recorders before the first step
+struct RunInfo {
+
+	double h;	//!Time step of the simulation in ms
+	double g;	//!Value of the ratio JI/JE
+	double eta;	//!Value of the ratio Nu_ext/Nu_thr
+	unsigned int long simtime;	//!Simulation time in steps
+	unsigned int long nbrNeurons;	//!Total number of neurons in the network
+	unsigned int long nbrExcitatory;	//!Number of excitatory neurons in the network
+	unsigned int long first_step;	//!First step given to the recorders (the clock of a continued run, 0 otherwise)
+
+};
+
+
+
+class Recorder {
+
+	public :
+
+	//!Destructor
+	virtual ~Recorder();
+
+
+	//!Method called once before the first step of the simulation
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info);
+
+
+	//!Method called after each step of the simulation
+	/*!
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step, in increasing order
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes)=0;
+
+
+	//!Method called before close when the simulation stops before its simulation time
+	/*!
+	 *\param steps the number of steps done, which replaces the simulation time of the run
+	*/
+	virtual void stopEarly(unsigned int long steps);
+
+
+	//!Method called once after the last step of the simulation
+	virtual void close();
+
+};
+
+
+
+//! Recorder of the spikes in the text format "time \t neuron number"
+class TextSpikeRecorder : public Recorder {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param filename the name of the file where to write the spikes
+	 *\param backend the system interface used to write the file
+	*/
+	TextSpikeRecorder(const std::string& filename, SinkBackend backend=SinkBackend::Stream);
+	
+	
+	//!Destructor
+	virtual ~TextSpikeRecorder();
+
+
+	//!Method that writes the spikes of a step, one line per spike
+	/*!
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Method that writes the end of the buffer and closes the output file
+	virtual void close() override;
+
+
+
+	private :
+
+	std::unique_ptr<OutputSink> sink;	//!File where to write the spikes
+	std::vector<char> buffer;	//!Formatted lines not written yet
+
+};
+
+
+
+//! Recording device that gives the spikes of a set of neurons during a time window to another recorder
+class SpikeDevice : public Recorder {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param target_ the recorder that receives the spikes of the set (for example a BinarySpikeRecorder with its own file)
+	 *\param neurons_ the neurons watched by the device
+	 *\param start_ the time in ms from which the spikes are recorded
+	 *\param stop_ the time in ms from which the spikes are no more recorded (negative for the end of the simulation)
+	*/
+	SpikeDevice(Recorder& target_, const NeuronSet& neurons_, double start_=0.0, double stop_=-1.0);
+
+
+	//!Method that computes the bitmask of the set and the steps of the window, and opens the target recorder
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info) override;
+
+
+	//!Method that gives the spikes of the set to the target recorder
+	/*!
+	 * the work is proportional to the smallest of the number of spikes of the step and the size of the set
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step, in increasing order
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Method that gives the number of steps done to the target recorder
+	/*!
+	 *\param steps the number of steps done
+	*/
+	virtual void stopEarly(unsigned int long steps) override;
+
+
+	//!Method that closes the target recorder
+	virtual void close() override;
+
+
+
+	private :
+
+	Recorder& target;	//!Recorder that receives the spikes of the set
+	NeuronSet neurons;	//!Neurons watched by the device
+	double start;	//!Time in ms from which the spikes are recorded
+	double stop;	//!Time in ms from which the spikes are no more recorded (negative for the end of the simulation)
+	std::vector<std::uint64_t> mask;	//!One bit per neuron of the network, set for the neurons of the set
+	unsigned int long start_step;	//!First recorded step
+	unsigned int long stop_step;	//!Step following the last recorded step
+	std::vector<unsigned int long> selected;	//!Spikes of the set during the current step
+
+};
+
+
+
+//! Recorder of the number of spikes of each population per time bin
+/*!
+ * writes one line per bin : "time (ms) \t excitatory spikes \t inhibitory spikes \t excitatory rate (Hz) \t inhibitory rate (Hz)"
+ * the bins start at the first step of the run (the checkpoint of a continued run)
+ */
+class PopulationRateRecorder : public Recorder {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param filename the name of the file where to write the bins
+	 *\param bin_width_ the width of a bin in ms (rounded to a number of steps, at least one)
+	 *\param backend the system interface used to write the file
+	*/
+	PopulationRateRecorder(const std::string& filename, double bin_width_=h, SinkBackend backend=SinkBackend::Stream);
+	
+	
+	//!Constructor
+	/*!
+	 *\param sink_ the sink where to write the bins (a socket for example)
+	 *\param bin_width_ the width of a bin in ms (rounded to a number of steps, at least one)
+	*/
+	PopulationRateRecorder(std::unique_ptr<OutputSink> sink_, double bin_width_=h);
+
+
+	//!Destructor
+	virtual ~PopulationRateRecorder();
+
+
+	//!Method that computes the number of steps per bin and writes the header line
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info) override;
+
+
+	//!Method that adds the spikes of a step to the counts of the current bin
+	/*!
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Method that makes the last bins end at the last step done
+	/*!
+	 *\param steps the number of steps done
+	*/
+	virtual void stopEarly(unsigned int long steps) override;
+
+
+	//!Method that writes the last bins and closes the file
+	virtual void close() override;
+
+
+
+	private :
+
+	//!Method that writes the current bin and starts the next one
+	void writeBin();
+
+
+	std::unique_ptr<OutputSink> sink;	//!File where to write the bins
+	double bin_width;	//!Asked width of a bin in ms
+	RunInfo info;	//!Parameters of the run
+	bool opened;	//!True once open was called, the bins being written only for a run that started
+	unsigned int long bin_steps;	//!Number of steps per bin
+	unsigned int long bin;	//!Index of the current bin
+	unsigned int long excitatory_spikes;	//!Number of spikes of excitatory neurons in the current bin
+	unsigned int long inhibitory_spikes;	//!Number of spikes of inhibitory neurons in the current bin
+
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "runSummary.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+//Function that writes a number in JSON (null if it is not finite)
+std::string number(double value) {
+	if(!std::isfinite(value)) {
+		return "null";
+	}
+	char text[32];
+	std::snprintf(text, sizeof(text), "%.10g", value);
+	return text;
+}
+
+
+//Function that writes a text in JSON, with its special characters escaped
+std::string text(const std::string& value) {
+	std::string escaped("\"");
+	for(char c : value) {
+		if(c=='"' or c=='\\') {
+			escaped+='\\';
+			escaped+=c;
+		} else if(static_cast<unsigned char>(c)<0x20) {
+			char code[8];
+			std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned int>(c));
+			escaped+=code;
+		} else {
+			escaped+=c;
+		}
+	}
+	return escaped+"\"";
+}
+
+}
+
+
+//!Function that gives the summary of a run in JSON
+std::string formatRunSummary(const RunSummary& summary, bool single_line) {
+
+	//One line : the same text without the line breaks and the indentation
+	const std::string line_end(single_line ? " " : "\n");
+	const std::string indent(single_line ? "" : "  ");
+	const std::string field(line_end+indent+indent);
+
+	const NetworkStatistics& statistics(summary.statistics);
+	std::ostringstream json;
+	json<<"{"<<line_end
+		<<indent<<"\"status\": "<<text(summary.success ? "done" : "failed")<<","<<line_end
+		<<indent<<"\"error\": "<<(summary.success ? "null" : text(summary.error))<<","<<line_end
+		<<indent<<"\"parameters\": {"
+		<<field<<"\"time_ms\": "<<number(summary.time)<<","
+		<<field<<"\"g\": "<<number(summary.g)<<","
+		<<field<<"\"eta\": "<<number(summary.eta)<<","
+		<<field<<"\"seed\": "<<summary.seed<<","
+		<<field<<"\"excitatory\": "<<summary.size.nbr_excitatory<<","
+		<<field<<"\"inhibitory\": "<<summary.size.nbr_inhibitory<<","
+		<<field<<"\"connections_excitatory\": "<<summary.size.connections_excitatory<<","
+		<<field<<"\"connections_inhibitory\": "<<summary.size.connections_inhibitory<<line_end
+		<<indent<<"},"<<line_end
+		<<indent<<"\"timings\": {"
+		<<field<<"\"construction_s\": "<<number(summary.construction_time)<<","
+		<<field<<"\"simulation_s\": "<<number(summary.run_time)<<","
+		<<field<<"\"total_s\": "<<number(summary.total_time)<<line_end
+		<<indent<<"},"<<line_end
+		<<indent<<"\"result\": {"
+		<<field<<"\"steps\": "<<summary.steps<<","
+		<<field<<"\"simulated_ms\": "<<number(summary.steps*h)<<","
+		<<field<<"\"stop_reason\": "<<text(summary.stop_reason)<<","
+		<<field<<"\"rate_hz\": "<<number(statistics.rate)<<","
+		<<field<<"\"cv\": "<<number(statistics.cv)<<","
+		<<field<<"\"fano_factor\": "<<number(statistics.fano_factor)<<","
+		<<field<<"\"synchrony\": "<<number(statistics.synchrony)<<","
+		<<field<<"\"regime\": "<<text(statistics.regime)<<","
+		<<field<<"\"dropped_spikes\": "<<summary.dropped_spikes<<line_end
+		<<indent<<"}"<<line_end
+		<<"}";
+	return json.str();
+}
+
+
+//!Function that writes the summary of a run
+void writeRunSummary(const std::string& filename, const RunSummary& summary) {
+
+	const std::string temporary(filename+".tmp");
+	std::ofstream file(temporary);
+	if(file.fail()) {
+		throw std::runtime_error("Cannot create the file "+temporary);
+	}
+	file<<formatRunSummary(summary)<<"\n";
+
+	file.close();
+	if(file.fail()) {
+		throw std::runtime_error("Cannot write the file "+temporary);
+	}
+	if(std::rename(temporary.c_str(), filename.c_str())!=0) {
+		throw std::runtime_error("Cannot rename "+temporary+" to "+filename);
+	}
+}
@@ -0,0 +1,53 @@
+//! RunSummary structure
+/*!To write the parameters, the timings and the results of a run in a JSON file, read by the scripts that run many
+ * simulations instead of the messages of the terminal
+ */
+#ifndef RUNSUMMARY_H
+#define RUNSUMMARY_H
+#include "network.hpp"
+#include "statisticsRecorder.hpp"
+#include <string>
+
+
+
+//!Parameters, timings and results of a run
+struct RunSummary {
+
+	bool success;	//!True if the run ended without error
+	std::string error;	//!Message of the error that stopped the run
+	double time;	//!Simulation time asked in ms
+	double g;	//!Value of g=JI/JE
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	unsigned int seed;	//!Seed of the network (the drawn one if none was given)
+	NetworkSize size;	//!Numbers of neurons and of connections
+	double construction_time;	//!Time in s spent creating the network
+	double run_time;	//!Time in s spent simulating
+	double total_time;	//!Time in s of the whole program
+	unsigned int long steps;	//!Number of steps done
+	std::string stop_reason;	//!Reason why the run stopped before its simulation time ("none" if it did not)
+	NetworkStatistics statistics;	//!Statistics of the network
+	unsigned int long dropped_spikes;	//!Number of spikes that the recorders could not write
+
+};
+
+
+//!Function that gives the summary of a run in JSON
+/*!
+ * the numbers that are not finite (the cv of a silent network) are written as null
+ *\param summary the summary of the run
+ *\param single_line true to give the summary on one line (for the line protocols), false to indent it
+ *\return the JSON object, without line break at its end
+*/
+std::string formatRunSummary(const RunSummary& summary, bool single_line=false);
+
+
+//!Function that writes the summary of a run
+/*!
+ * the file is written under a temporary name and then renamed, so that a script never reads a partial summary
+ * throws std::runtime_error if the file cannot be written
+ *\param filename the name of the JSON file
+ *\param summary the summary of the run
+*/
+void writeRunSummary(const std::string& filename, const RunSummary& summary);
+
+#endif
@@ -0,0 +1,116 @@
+#include "network.hpp"
+#include "options.hpp"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+//Function that gives the sizes 1, 2, 5, 10, 20, 50... times 1000 from min_neurons to max_neurons
+std::vector<unsigned int long> sizeSeries(unsigned int long min_neurons, unsigned int long max_neurons) {
+	std::vector<unsigned int long> sizes;
+	for(unsigned int long decade(1); decade<=max_neurons; decade*=10) {
+		for(auto factor : {1ul, 2ul, 5ul}) {
+			if(decade*factor>=min_neurons and decade*factor<=max_neurons) {
+				sizes.push_back(decade*factor);
+			}
+		}
+	}
+	return sizes;
+}
+
+}
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc>1 and (std::string(argv[1])=="--help" or std::string(argv[1])=="-h")) {
+		std::cerr<<"Usage : "<<argv[0]<<" [options]"<<std::endl;
+		std::cerr<<"Simulates networks of 1k, 2k, 5k, 10k... neurons in one process, 80% of them excitatory, and writes the time of"<<std::endl;
+		std::cerr<<"their construction and of a simulated second :"<<std::endl;
+		std::cerr<<"- with the same numbers of connections per neuron for all the sizes (in-degree), the work per neuron is"<<std::endl;
+		std::cerr<<"  constant, so that the time per neuron shows the cost of the memory accesses of the larger networks"<<std::endl;
+		std::cerr<<"- with the same probability of connection (probability), the numbers of connections grow with the network"<<std::endl;
+		std::cerr<<"  like in the model of the paper (0.1 : CE=1000 and CI=250 for 12500 neurons)"<<std::endl;
+		std::cerr<<"  --config file                    reads the options of a file, one line \"name = value\" per option"<<std::endl;
+		std::cerr<<"  --min-neurons count              smallest network (default : 1000)"<<std::endl;
+		std::cerr<<"  --max-neurons count              largest network (default : 1000000)"<<std::endl;
+		std::cerr<<"  --connections-excitatory count   excitatory connections per neuron of the in-degree series (default : 100)"<<std::endl;
+		std::cerr<<"  --connections-inhibitory count   inhibitory connections per neuron of the in-degree series (default : 25)"<<std::endl;
+		std::cerr<<"  --probability p                  probability of connection of the probability series (default : 0.1)"<<std::endl;
+		std::cerr<<"  --max-connections count          networks with more connections are skipped (default : 200000000, 1.6 GB)"<<std::endl;
+		std::cerr<<"  --time time_ms                   simulation time of each network (default : 100)"<<std::endl;
+		std::cerr<<"  --g g                            value of g (default : 5)"<<std::endl;
+		std::cerr<<"  --eta eta                        value of eta (default : 2)"<<std::endl;
+		std::cerr<<"  --seed seed                      seed of the networks (default : 1)"<<std::endl;
+		return 1;
+	}
+
+	try {
+		Options options({"min-neurons", "max-neurons", "connections-excitatory", "connections-inhibitory", "probability",
+						 "max-connections", "time", "g", "eta", "seed"});
+		options.parse(argc, argv);
+		const unsigned int long min_neurons(options.getInteger("min-neurons", 1000));
+		const unsigned int long max_neurons(options.getInteger("max-neurons", 1000000));
+		const unsigned int long in_degree[2]={options.getInteger("connections-excitatory", 100),
+											  options.getInteger("connections-inhibitory", 25)};
+		const double probability(options.getDouble("probability", 0.1));
+		const unsigned int long max_connections(options.getInteger("max-connections", 200000000));
+		const double time(options.getDouble("time", 100.0));
+		const double g(options.getDouble("g", 5.0));
+		const double eta(options.getDouble("eta", 2.0));
+		const unsigned int seed(options.getSeed("seed", 1));
+		if(!(time>0.0) or !(g>0.0) or !(eta>0.0) or !(probability>0.0 and probability<=1.0) or min_neurons==0) {
+			throw std::invalid_argument("The time, g, eta and the smallest network must be strictly positive, and the probability in ]0, 1]");
+		}
+
+		const unsigned int long steps(time/h);
+		std::printf("series\tneurons\tCE\tCI\tconnections\tconstruction (s)\ts per simulated s\tus per neuron and simulated s\trate (Hz)\n");
+		for(const std::string series : {"in-degree", "probability"}) {
+			for(auto nbr_neurons : sizeSeries(min_neurons, max_neurons)) {
+
+				NetworkSize size {nbr_neurons*4/5, nbr_neurons-nbr_neurons*4/5, in_degree[0], in_degree[1]};
+				if(series=="probability") {
+					size.connections_excitatory=std::lround(probability*size.nbr_excitatory);
+					size.connections_inhibitory=std::lround(probability*size.nbr_inhibitory);
+				}
+				const unsigned int long connections(nbr_neurons*(size.connections_excitatory+size.connections_inhibitory));
+				if(connections>max_connections) {
+					std::printf("%s\t%lu\t%lu\t%lu\t%lu\tskipped (more than %lu connections)\n", series.c_str(), nbr_neurons,
+								size.connections_excitatory, size.connections_inhibitory, connections, max_connections);
+					continue;
+				}
+
+				const auto start(std::chrono::steady_clock::now());
+				Network network(size, eta, g/JE, seed);
+				const std::chrono::duration<double> construction(std::chrono::steady_clock::now()-start);
+
+				unsigned int long nbr_spikes(0);
+				const auto run_start(std::chrono::steady_clock::now());
+				for(unsigned int long i(0); i<steps; ++i) {
+					network.update(0.0);
+					nbr_spikes+=network.getSpikes().size();
+				}
+				const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-run_start);
+
+				const double per_second(duration.count()*1000.0/(steps*h));
+				std::printf("%s\t%lu\t%lu\t%lu\t%lu\t%.2f\t%.2f\t%.3f\t%.1f\n", series.c_str(), nbr_neurons, size.connections_excitatory,
+							size.connections_inhibitory, connections, construction.count(), per_second, per_second*1e6/nbr_neurons,
+							nbr_spikes/(nbr_neurons*steps*h/1000.0));
+				std::fflush(stdout);
+			}
+		}
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -1,12 +1,20 @@
 #include "simulation.hpp"
+#include "checkpoint.hpp"
 #include <iostream>
 #include <fstream>
-#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 
 //!Constructor
-Simulation::Simulation() {
+Simulation::Simulation()
+: seed(0), size(defaultNetworkSize()), checkpoint_interval(0.0), warm_start(false), noise_seed(0), early_stop(false),
+  stop_reason(StopReason::None), network_seed(0), construction_time(0.0), run_time(0.0)
+{
 	
 	clock=0;
 	simtimeEntry();	//!Entry of the simulation time
@@ -16,6 +24,18 @@ Simulation::Simulation() {
 }
 	
 	
+//!Constructor
+Simulation::Simulation(double time, double g, double eta_)
+: clock(0), eta(eta_), JI(g/JE), seed(0), size(defaultNetworkSize()), checkpoint_interval(0.0), warm_start(false), noise_seed(0), early_stop(false),
+  stop_reason(StopReason::None), network_seed(0), construction_time(0.0), run_time(0.0)
+{
+	if(!(time>=0.0) or !(g>0.0) or !(eta>0.0)) {
+		throw std::invalid_argument("The simulation time must be positive, g and eta strictly positive");
+	}
+	simtime=(static_cast<unsigned int long>(time*10))/(static_cast<unsigned long>(h*10)); //To avoid round errors
+}
+	
+	
 //!Destructor
 Simulation::~Simulation() {}
 	
@@ -24,8 +44,9 @@ Simulation::~Simulation() {}
 void Simulation::simtimeEntry() {
 	std::cout<<"Enter the simulation time in ms : ";
 	double time;
-	std::cin>>time;
-	assert(time>=0); //Verifies that time is positive
+	if(!(std::cin>>time) or !(time>=0.0)) {
+		throw std::invalid_argument("The simulation time must be a positive number");
+	}
 	simtime=(static_cast<unsigned int long>(time*10))/(static_cast<unsigned long>(h*10)); //To avoid round errors
 	std::cout<<std::endl;
 }
@@ -35,8 +56,9 @@ void Simulation::simtimeEntry() {
 double Simulation::etaEntry() {
 	std::cout<<"Enter the value of Nu_ext/Nu_thr : ";
 	double eta_;
-	std::cin>>eta_;
-	assert(eta_>0); //Verifies that eta_ is strictly positive
+	if(!(std::cin>>eta_) or !(eta_>0.0)) {
+		throw std::invalid_argument("eta must be a strictly positive number");
+	}
 	return eta_;
 }
 
@@ -45,8 +67,9 @@ double Simulation::etaEntry() {
 double Simulation::gEntry() {
 	std::cout<<"Enter the value of g=JE/JI : ";
 	double g_;
-	std::cin>>g_;
-	assert(g_>0); //Verifies that g_ is strictly positive
+	if(!(std::cin>>g_) or !(g_>0.0)) {
+		throw std::invalid_argument("g must be a strictly positive number");
+	}
 	return g_;
 }
 
@@ -69,28 +92,210 @@ void Simulation::updateClock() {
 }
 
 
+//!Method that adds a recorder to the simulation
+void Simulation::addRecorder(Recorder* recorder) {
+	recorders.push_back(recorder);
+}
+
+
+//!Method that adds a multimeter to the simulation
+void Simulation::addMultimeter(Multimeter* multimeter) {
+	multimeters.push_back(multimeter);
+}
+
+
+//!Setter for the seed of the network
+void Simulation::setSeed(unsigned int seed_) {
+	seed=seed_;
+}
+
+
+//!Setter for the size of the network
+void Simulation::setNetworkSize(const NetworkSize& size_) {
+	checkNetworkSize(size_);
+	size=size_;
+}
+
+
+//!Method that makes the simulation write checkpoints during the run
+void Simulation::setCheckpoints(const std::string& filename, double interval) {
+	checkpoint_filename=filename;
+	checkpoint_interval=interval;
+}
+
+
+//!Method that makes the next run continue a simulation from a checkpoint
+void Simulation::restore(const std::string& filename) {
+	restore_filename=filename;
+	warm_start=false;
+}
+
+
+//!Method that makes the next run start from the state saved in a checkpoint, for instance after the initial transient
+void Simulation::warmStart(const std::string& filename, unsigned int noise_seed_) {
+	restore_filename=filename;
+	warm_start=true;
+	noise_seed=noise_seed_;
+}
+
+
+//!Method that makes the simulation stop before its simulation time when a stop condition is met
+void Simulation::setStopConditions(const StopConditions& conditions) {
+	stop_monitor=StopMonitor(conditions);
+	early_stop=true;
+}
+
+
+//!Getter for the seed of the network of the last run
+unsigned int Simulation::getNetworkSeed() const {
+	return network_seed;
+}
+
+
+//!Getter for the time spent creating the network of the last run
+double Simulation::getConstructionTime() const {
+	return construction_time;
+}
+
+
+//!Getter for the time spent simulating the last run
+double Simulation::getRunTime() const {
+	return run_time;
+}
+
+
+//!Getter for the reason why the last run stopped
+StopReason Simulation::getStopReason() const {
+	return stop_reason;
+}
+
+
 //!Method that runs the simulation at each simulation step
-void Simulation::run(std::ofstream& output_file) { 
+void Simulation::run() { 
+	
+	const auto start(std::chrono::steady_clock::now());
+	
+	//A continued simulation needs the network of the checkpoint, created again from its seed
+	std::unique_ptr<Checkpoint> checkpoint;
+	unsigned int created_seed(seed);
+	if(!restore_filename.empty()) {
+		checkpoint.reset(new Checkpoint(restore_filename));
+		if(!warm_start and (checkpoint->getG()!=JI*JE or checkpoint->getEta()!=eta)) {
+			throw std::invalid_argument(restore_filename+" was not written with the same values of g and eta");
+		}
+		created_seed=checkpoint->getSeed();
+	}
 	
 	/*
-	 * Creation of a network with nbrExcitNeuronsEntry() excitatory neurons 
-		and nbrInhibNeuronsEntry() inhibitory neurons
+	 * Creation of a network with the numbers of neurons and of connections of the simulation
+	 * (NE, NI, CE and CI by default)
 	*/
-	Network network (NE, NI, eta, JI);
+	Network network (size, eta, JI, created_seed);
+	std::cout<<"Connections : done"<<std::endl;
+	
+	if(checkpoint) {
+		checkpoint->restore(network);
+		if(warm_start) {
+			clock=0;
+			if(noise_seed!=0) {
+				network.reseedNoise(noise_seed);
+			}
+			std::cout<<"Checkpoint : started from the state at "<<network.getClock()*h<<" ms"<<std::endl;
+		} else {
+			clock=checkpoint->getClock();
+			std::cout<<"Checkpoint : continued from "<<clock*h<<" ms"<<std::endl;
+		}
+		checkpoint.reset();
+	}
+	
+	const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+	run(network, duration.count());
+}
+
+
+//!Method that runs the simulation with a network already created
+void Simulation::run(Network& network, double construction_time_) {
+	
+	const auto start(std::chrono::steady_clock::now());
+	network_seed=network.getSeed();
+	construction_time=construction_time_;
+	
+	//The steps given to the recorders are counted from the start of the simulation, not from the creation of the network
+	const unsigned int long first_step(network.getClock()-getClock());
+	const unsigned int long checkpoint_steps(checkpoint_filename.empty() ? 0 : std::max(1l, std::lround(checkpoint_interval/h)));
+	
+	
+	//The recorders receive the parameters of the run before the first step, a continued run starting at the checkpoint
+	const RunInfo info {h, JI*JE, eta, simtime, network.getNbrNeurons(), network.getNbrExcitatory(), getClock()};
+	for(auto recorder : recorders) {
+		recorder->open(info);
+	}
+	for(auto multimeter : multimeters) {
+		multimeter->open(info);
+	}
+	if(early_stop) {
+		stop_monitor.open(info);
+	}
+	stop_reason=StopReason::None;
 	
 	
 	/*
 	 * While the simulation time is not up, at each simulation step :
 	 * update of the network 'network'
+	 * recording of the spikes of the step
+	 * sampling of the potentials
 	 * update of the global clock
 	*/
 	while (getClock()<simtime) {
 		
-		network.update(0.0, output_file);  //External_current of 0.0
+		const unsigned int long step(network.getClock()-first_step);
+		network.update(0.0);  //External_current of 0.0
+		
+		for(auto recorder : recorders) {
+			recorder->record(step, network.getSpikes());
+		}
+		for(auto multimeter : multimeters) {
+			multimeter->sample(step, network);
+		}
+		if(early_stop) {
+			stop_monitor.record(step, network.getSpikes());
+		}
 		
 		updateClock();		
+		
+		if(checkpoint_steps>0 and getClock()%checkpoint_steps==0) {
+			Checkpoint::write(checkpoint_filename, JI*JE, eta, getClock(), network);
+		}
+		
+		if(early_stop and stop_monitor.getReason()!=StopReason::None) {
+			stop_reason=stop_monitor.getReason();
+			break;
+		}
 
-	}	
+	}
+	
+	//The last state is saved, so that the run can be extended or used as the start of other runs
+	if(checkpoint_steps>0 and getClock()%checkpoint_steps!=0) {
+		Checkpoint::write(checkpoint_filename, JI*JE, eta, getClock(), network);
+	}
+	
+	//The recorders that depend on the simulation time end at the last step done
+	if(stop_reason!=StopReason::None) {
+		std::cout<<"Simulation : stopped at "<<getClock()*h<<" ms ("<<stopReasonName(stop_reason)<<")"<<std::endl;
+		for(auto recorder : recorders) {
+			recorder->stopEarly(getClock());
+		}
+	}
+	
+	for(auto recorder : recorders) {
+		recorder->close();
+	}
+	for(auto multimeter : multimeters) {
+		multimeter->close();
+	}
+	
+	const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+	run_time=duration.count();
 }
 		
 	
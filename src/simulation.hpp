@@ -4,7 +4,11 @@
 /*!To model simulations
  */
 #include "network.hpp"
+#include "recorder.hpp"
+#include "multimeter.hpp"
+#include "stopMonitor.hpp"
 #include <iostream>
+#include <string>
 #include <vector>
 #include <cmath>
 
@@ -14,17 +18,35 @@ class Simulation {
 	public :
 	
 	//!Constructor
+	/*!
+	 * asks the simulation time, g and eta on the terminal
+	 * throws std::invalid_argument if a value is not valid or cannot be read
+	*/
 	Simulation();
 	
+	
+	//!Constructor
+	/*!
+	 * throws std::invalid_argument if a value is not valid
+	 *\param time the simulation time in ms (positive)
+	 *\param g the value of g=JI/JE (strictly positive)
+	 *\param eta_ the value of eta=Nu_ext/Nu_thr (strictly positive)
+	*/
+	Simulation(double time, double g, double eta_);
+	
 	//!Destructor
 	~Simulation();
 	
 	
 	//!For the entry of the simulation time
+	/*!
+	 * throws std::invalid_argument if the time is not a positive number (or if the input ended)
+	*/
 	void simtimeEntry();
 	
 	//!For the entry of the eta value
 	/*!
+	 * throws std::invalid_argument if eta is not a strictly positive number (or if the input ended)
 	 *\return the value of eta=Nu_ext/Nu_thr
 	*/
 	double etaEntry();
@@ -32,6 +54,7 @@ class Simulation {
 	
 	//!For the entry of the g value
 	/*!
+	 * throws std::invalid_argument if g is not a strictly positive number (or if the input ended)
 	 *\return the value of g=JE/JI
 	*/
 	double gEntry();
@@ -55,11 +78,115 @@ class Simulation {
 	void updateClock();
 	
 	
+	//!Method that adds a recorder to the simulation
+	/*!
+	 *\param recorder a recorder that will receive the spikes of each step (not owned by the simulation)
+	*/
+	void addRecorder(Recorder* recorder);
+	
+	
+	//!Method that adds a multimeter to the simulation
+	/*!
+	 *\param multimeter a multimeter that will sample the potentials after each step (not owned by the simulation)
+	*/
+	void addMultimeter(Multimeter* multimeter);
+	
+	
+	//!Setter for the seed of the network
+	/*!
+	 *\param seed_ the seed of the random generators of the network (0, the default, to draw one)
+	*/
+	void setSeed(unsigned int seed_);
+	
+	
+	//!Setter for the size of the network
+	/*!
+	 * throws std::invalid_argument if the size is not valid (see checkNetworkSize)
+	 *\param size_ the numbers of neurons and of connections of the network (defaultNetworkSize() by default)
+	*/
+	void setNetworkSize(const NetworkSize& size_);
+	
+	
+	//!Method that makes the simulation write checkpoints during the run
+	/*!
+	 *\param filename the name of the checkpoint file, replaced at each checkpoint
+	 *\param interval the time between two checkpoints in ms
+	*/
+	void setCheckpoints(const std::string& filename, double interval);
+	
+	
+	//!Method that makes the next run continue a simulation from a checkpoint
+	/*!
+	 * the run fails if the checkpoint was not written with the same values of g and eta
+	 * the recorders only receive the steps that follow the checkpoint
+	 *\param filename the name of the checkpoint file
+	*/
+	void restore(const std::string& filename);
+	
+	
+	//!Method that makes the next run start from the state saved in a checkpoint, for instance after the initial transient
+	/*!
+	 * the values of g and eta of this simulation are used, even if they differ from those of the checkpoint
+	 * the clock of the simulation and the steps given to the recorders start at 0
+	 *\param filename the name of the checkpoint file
+	 *\param noise_seed the seed of the background noise of this run (0 to keep the random generator of the checkpoint)
+	*/
+	void warmStart(const std::string& filename, unsigned int noise_seed=0);
+	
+	
+	//!Method that makes the simulation stop before its simulation time when a stop condition is met
+	/*!
+	 * the recorders are then told the number of steps done before being closed (see Recorder::stopEarly)
+	 *\param conditions the stop conditions (see StopMonitor)
+	*/
+	void setStopConditions(const StopConditions& conditions);
+	
+	
+	//!Getter for the seed of the network of the last run
+	/*!
+	 *\return the seed with which the connections of the last run can be created again (0 before the first run)
+	*/
+	unsigned int getNetworkSeed() const;
+	
+	
+	//!Getter for the time spent creating the network of the last run
+	/*!
+	 *\return the time in s spent creating the connections and restoring the checkpoint (0 for a network already created)
+	*/
+	double getConstructionTime() const;
+	
+	
+	//!Getter for the time spent simulating the last run
+	/*!
+	 *\return the time in s spent updating the network and recording its spikes
+	*/
+	double getRunTime() const;
+	
+	
+	//!Getter for the reason why the last run stopped
+	/*!
+	 *\return StopReason::None if the last run reached its simulation time
+	*/
+	StopReason getStopReason() const;
+	
+	
 	//!Method that runs the simulation at each simulation step
 	/*!
-	 *\param file the file where to write times of the neuron spikes
+	 * a checkpoint is also written at the end of the run when the checkpoints are enabled
+	 * the spikes of each step are given to the recorders of the simulation
+	 * the network is given to the multimeters of the simulation after each step
+	*/
+	void run();
+	
+	
+	//!Method that runs the simulation with a network already created
+	/*!
+	 * the network keeps its connections and its state, and is updated until the simulation time
+	 * (used to run several simulations with the same connections, see Ensemble)
+	 *\param network the network of the simulation
+	 *\param construction_time_ the time spent creating the network in s, 0 for a network created by the caller
 	*/
-	void run(std::ofstream& file);
+	void run(Network& network, double construction_time_=0.0);
 	
 	
 	
@@ -69,6 +196,21 @@ class Simulation {
 	unsigned int long simtime;	//!Simulation time
 	double eta;	//!Value of the ratio Nu_ext/Nu_thr
 	double JI;	//!Value of the ratio g/JE -> weight of inhibitory connections
+	std::vector<Recorder*> recorders;	//!Recorders of the spikes of the simulation
+	std::vector<Multimeter*> multimeters;	//!Multimeters of the simulation
+	unsigned int seed;	//!Seed of the network (0 to draw one)
+	NetworkSize size;	//!Numbers of neurons and of connections of the network
+	std::string checkpoint_filename;	//!Name of the checkpoint file (empty without checkpoints)
+	double checkpoint_interval;	//!Time between two checkpoints in ms
+	std::string restore_filename;	//!Name of the checkpoint from which the run continues (empty to start from the beginning)
+	bool warm_start;	//!True if the run starts from the checkpoint instead of continuing it
+	unsigned int noise_seed;	//!Seed of the background noise of a warm start (0 to keep the one of the checkpoint)
+	bool early_stop;	//!True if the stop conditions are evaluated during the run
+	StopMonitor stop_monitor;	//!Monitor of the stop conditions
+	StopReason stop_reason;	//!Reason why the last run stopped
+	unsigned int network_seed;	//!Seed of the network of the last run
+	double construction_time;	//!Time in s spent creating the network of the last run
+	double run_time;	//!Time in s spent simulating the last run
 	
 	
 	
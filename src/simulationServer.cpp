@@ -0,0 +1,500 @@
+#include "simulationServer.hpp"
+#include "simulation.hpp"
+#include "statisticsRecorder.hpp"
+#include "runSummary.hpp"
+#include "options.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+namespace {
+
+const size_t max_line(1<<16);	//Size of the longest line accepted from a client
+
+
+//Function that sends one line to a client
+void sendLine(int fd, const std::string& line) {
+	SocketSink sink(fd);
+	sink.write(line.data(), line.size());
+	sink.write("\n", 1);
+	sink.close();
+}
+
+
+//Function that closes, in the process of a job, the files of the server other than the socket of its client and the pipe
+void closeOtherFiles(int client_fd, int wake_fd) {
+	std::vector<int> others;
+	DIR* directory(opendir("/proc/self/fd"));
+	if(directory==nullptr) {
+		return;
+	}
+	while(const dirent* entry=readdir(directory)) {
+		const int fd(std::atoi(entry->d_name));
+		if(fd>2 and fd!=client_fd and fd!=wake_fd and fd!=dirfd(directory)) {
+			others.push_back(fd);
+		}
+	}
+	closedir(directory);
+	for(int fd : others) {
+		close(fd);
+	}
+}
+
+
+//Function that runs a job in the process created for it, and gives the status of the process
+int runJob(int fd, const Job& job, Network* kept_network, double construction_time) {
+
+	try {
+		//A network without seed is created for the job only
+		std::unique_ptr<Network> own_network;
+		if(kept_network==nullptr) {
+			const auto start(std::chrono::steady_clock::now());
+			own_network.reset(new Network(job.size, job.eta, job.g/JE, job.seed));
+			const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+			construction_time=duration.count();
+		}
+		Network& network(kept_network!=nullptr ? *kept_network : *own_network);
+		network.setParameters(job.eta, job.g/JE);
+		if(job.noise_seed!=0) {
+			network.reseedNoise(job.noise_seed);
+		}
+
+		//The rates are sent while the job runs, the statistics at the end
+		Simulation simulation(job.time, job.g, job.eta);
+		StatisticsRecorder statistics_recorder(1.0, 0.0, false);
+		simulation.addRecorder(&statistics_recorder);
+		std::unique_ptr<PopulationRateRecorder> rate_recorder;
+		if(job.rate_bin>0.0) {
+			rate_recorder.reset(new PopulationRateRecorder(std::unique_ptr<OutputSink>(new SocketSink(fd)), job.rate_bin));
+			simulation.addRecorder(rate_recorder.get());
+		}
+		simulation.run(network);
+
+		const std::chrono::duration<double> total(std::chrono::steady_clock::now()-job.received);
+		const RunSummary summary {true, "", job.time, job.g, job.eta, simulation.getNetworkSeed(), job.size, construction_time,
+								  simulation.getRunTime(), total.count(), simulation.getClock(),
+								  stopReasonName(simulation.getStopReason()), statistics_recorder.getStatistics(), 0};
+		sendLine(fd, "done "+formatRunSummary(summary, true));
+		return 0;
+
+	} catch(const std::exception& error) {
+		try {
+			sendLine(fd, std::string("error ")+error.what());
+		} catch(const std::exception&) {}	//The client is gone
+		return 1;
+	}
+}
+
+}
+
+
+//!Function that reads a job
+Job parseJob(const std::string& line) {
+
+	Options options({"time", "g", "eta", "seed", "noise-seed", "excitatory", "inhibitory", "connections-excitatory",
+					 "connections-inhibitory", "rate-bin"});
+	std::istringstream words(line);
+	std::string word;
+	while(words>>word) {
+		const size_t equal(word.find('='));
+		if(equal==std::string::npos) {
+			throw std::invalid_argument("The parameter "+word+" has no value (name=value)");
+		}
+		options.set(word.substr(0, equal), word.substr(equal+1));
+	}
+	for(const std::string name : {"time", "g", "eta"}) {
+		if(!options.has(name)) {
+			throw std::invalid_argument("The parameter "+name+" is missing");
+		}
+	}
+
+	const NetworkSize default_size(defaultNetworkSize());
+	Job job {options.getDouble("time", 0.0), options.getDouble("g", 0.0), options.getDouble("eta", 0.0),
+			 options.getSeed("seed", 0), options.getSeed("noise-seed", 0),
+			 NetworkSize {options.getInteger("excitatory", default_size.nbr_excitatory),
+						  options.getInteger("inhibitory", default_size.nbr_inhibitory),
+						  options.getInteger("connections-excitatory", default_size.connections_excitatory),
+						  options.getInteger("connections-inhibitory", default_size.connections_inhibitory)},
+			 options.getDouble("rate-bin", 1.0), std::chrono::steady_clock::now()};
+	if(!(job.time>=0.0) or !(job.g>0.0) or !(job.eta>0.0) or !(job.rate_bin>=0.0)) {
+		throw std::invalid_argument("The time and rate-bin must be positive, g and eta strictly positive");
+	}
+	checkNetworkSize(job.size);
+	return job;
+}
+
+
+//!Constructor
+SimulationServer::SimulationServer(const std::string& socket_path_, unsigned int processes_, unsigned int long cache_size_)
+: socket_path(socket_path_), processes(processes_>0 ? processes_ : std::max(1u, std::thread::hardware_concurrency())),
+  cache_size(cache_size_), listen_fd(-1), wake_fds{-1, -1}, nbr_jobs(0), building(false), built(false), build_time(0.0)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family=AF_UNIX;
+	if(socket_path.empty() or socket_path.size()>=sizeof(address.sun_path)) {
+		throw std::invalid_argument("The name of the socket must have 1 to "+std::to_string(sizeof(address.sun_path)-1)+" characters");
+	}
+	std::strcpy(address.sun_path, socket_path.c_str());
+
+	if(pipe(wake_fds)<0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot create the pipe of the server");
+	}
+	listen_fd=socket(AF_UNIX, SOCK_STREAM, 0);
+	if(listen_fd<0) {
+		const int error(errno);
+		close(wake_fds[0]);
+		close(wake_fds[1]);
+		throw std::system_error(error, std::generic_category(), "Cannot create the socket");
+	}
+
+	//The file of a server that was not stopped properly is replaced
+	unlink(socket_path.c_str());
+	if(bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address))<0 or listen(listen_fd, 64)<0) {
+		const int error(errno);
+		close(listen_fd);
+		close(wake_fds[0]);
+		close(wake_fds[1]);
+		throw std::system_error(error, std::generic_category(), "Cannot listen on "+socket_path);
+	}
+}
+
+
+//!Destructor
+SimulationServer::~SimulationServer() {
+	if(builder.joinable()) {
+		builder.join();
+	}
+	while(!running.empty() and reap(true)>0) {}
+	for(const auto& connection : connections) {
+		close(connection.first);
+	}
+	close(listen_fd);
+	close(wake_fds[0]);
+	close(wake_fds[1]);
+	unlink(socket_path.c_str());
+}
+
+
+//!Method that accepts the connections and runs their jobs until stop becomes true
+void SimulationServer::serve(const std::atomic<bool>& stop) {
+
+	while(!stop) {
+
+		//The connections that can still send jobs, or that have errors to receive, are watched with the listening socket and the end of the jobs
+		std::vector<pollfd> watched {{listen_fd, POLLIN, 0}, {wake_fds[0], POLLIN, 0}};
+		for(const auto& connection : connections) {
+			const short events((connection.second.input_closed ? 0 : POLLIN)|(connection.second.output.empty() ? 0 : POLLOUT));
+			if(events!=0) {
+				watched.push_back({connection.first, events, 0});
+			}
+		}
+		//A process that wrote in the pipe but did not exit yet is waited for again 1 ms later
+		if(poll(watched.data(), watched.size(), ending.empty() ? 100 : 1)<0) {
+			if(errno==EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), "Cannot wait for the clients");
+		}
+
+		if(watched[0].revents&POLLIN) {
+			const int fd(accept(listen_fd, nullptr, nullptr));
+			if(fd>=0) {
+				connections[fd]=Connection {fd, "", "", {}, false, false};
+			}
+		}
+		//The pipe gives the processes that are ending : they are waited for without blocking, so that a job never waits for another
+		if(watched[1].revents&POLLIN) {
+			pid_t pids[16];
+			const ssize_t size(read(wake_fds[0], pids, sizeof(pids)));
+			if(size<0 and errno!=EINTR) {
+				throw std::system_error(errno, std::generic_category(), "Cannot read the pipe of the server");
+			}
+			for(ssize_t i(0); i<size/static_cast<ssize_t>(sizeof(pid_t)); ++i) {
+				if(pids[i]!=0) {	//0 only wakes the server at the end of the builder thread
+					ending.insert(pids[i]);
+				}
+			}
+		}
+		for(size_t i(2); i<watched.size(); ++i) {
+			Connection& connection(connections[watched[i].fd]);
+			if(watched[i].revents&POLLOUT) {
+				flush(connection);
+			}
+			if((watched[i].events&POLLIN) and watched[i].revents!=0) {
+				receive(connection);
+			}
+		}
+
+		//The jobs of the connections start while processes are free, one job at a time per connection, after the errors sent before
+		//(the jobs answered by an error do not run, so the next ones start at once, and a job whose network is being created waits)
+		reap(false);
+		if(building and built) {
+			endBuild();
+		}
+		for(auto& connection : connections) {
+			while(running.size()<processes and !connection.second.running and connection.second.output.empty()
+				  and !connection.second.jobs.empty() and start(connection.second)) {}
+		}
+
+		//A connection is closed once the client stopped sending and all its jobs and errors are done
+		for(auto connection(connections.begin()); connection!=connections.end();) {
+			if(connection->second.input_closed and !connection->second.running and connection->second.jobs.empty()
+			   and connection->second.output.empty()) {
+				close(connection->first);
+				connection=connections.erase(connection);
+			} else {
+				++connection;
+			}
+		}
+	}
+}
+
+
+//!Getter for the number of networks kept
+unsigned int long SimulationServer::getCachedNetworks() const {
+	return cache.size();
+}
+
+
+//!Method that reads the bytes sent by a client and queues its jobs
+void SimulationServer::receive(Connection& connection) {
+
+	char buffer[4096];
+	const ssize_t size(read(connection.fd, buffer, sizeof(buffer)));
+	if(size<0 and (errno==EINTR or errno==EAGAIN)) {
+		return;
+	}
+	if(size<=0) {
+		connection.input_closed=true;
+		return;
+	}
+	connection.input.append(buffer, size);
+
+	size_t end;
+	while((end=connection.input.find('\n'))!=std::string::npos) {
+		std::string line(connection.input.substr(0, end));
+		connection.input.erase(0, end+1);
+		line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+		if(line.find_first_not_of(" \t")!=std::string::npos and line[line.find_first_not_of(" \t")]!='#') {
+			connection.jobs.emplace_back(line, std::chrono::steady_clock::now());
+		}
+	}
+
+	//A client that never ends its line is not read any more (an empty line is never queued otherwise)
+	if(connection.input.size()>max_line) {
+		connection.input.clear();
+		connection.jobs.emplace_back("", std::chrono::steady_clock::now());
+		connection.input_closed=true;
+	}
+}
+
+
+//!Method that sends a line to a client without waiting
+void SimulationServer::answer(Connection& connection, const std::string& line) {
+	connection.output+=line+"\n";
+	flush(connection);
+}
+
+
+//!Method that sends the bytes of the errors not sent yet to a client, as many as its socket takes without waiting
+void SimulationServer::flush(Connection& connection) {
+
+	//The flags of the socket are shared with the processes of the jobs, which send while blocking : only these sends do not wait
+	while(!connection.output.empty()) {
+		const ssize_t sent(send(connection.fd, connection.output.data(), connection.output.size(), MSG_DONTWAIT|MSG_NOSIGNAL));
+		if(sent<0) {
+			if(errno==EINTR) {
+				continue;
+			}
+			if(errno!=EAGAIN and errno!=EWOULDBLOCK) {
+				//The client is gone : its other jobs are not run
+				connection.output.clear();
+				connection.jobs.clear();
+				connection.input_closed=true;
+			}
+			return;
+		}
+		connection.output.erase(0, sent);
+	}
+}
+
+
+//!Method that starts the next job of a connection in its own process
+bool SimulationServer::start(Connection& connection) {
+
+	const auto request(connection.jobs.front());
+
+	//The errors of the parameters and of the creation of the network are answered by the server
+	Job job;
+	Network* network(nullptr);
+	double construction_time(0.0);
+	try {
+		if(request.first.empty()) {
+			throw std::invalid_argument("The line is longer than "+std::to_string(max_line)+" bytes");
+		}
+		job=parseJob(request.first);
+		job.received=request.second;
+		if(job.seed!=0 and cache_size>0) {
+			network=cachedNetwork(job, construction_time);
+			if(network==nullptr) {
+				return false;	//The job stays first in the queue until its network is created
+			}
+		}
+	} catch(const std::exception& error) {
+		connection.jobs.pop_front();
+		answer(connection, std::string("error ")+error.what());
+		return true;
+	}
+	connection.jobs.pop_front();
+
+	//The buffers are emptied, so that the process does not write them again
+	std::cout.flush();
+	std::cerr.flush();
+
+	const pid_t pid(fork());
+	if(pid<0) {
+		answer(connection, "error Cannot create the process of the job");
+		return true;
+	}
+
+	if(pid==0) {
+		//Process of the job : the other clients, and the sockets of a program that runs the server, are not kept open by it
+		close(listen_fd);
+		close(wake_fds[0]);
+		for(const auto& other : connections) {
+			if(other.first!=connection.fd) {
+				close(other.first);
+			}
+		}
+		closeOtherFiles(connection.fd, wake_fds[1]);
+		const int status(runJob(connection.fd, job, network, construction_time));
+		std::cout.flush();
+		std::cerr.flush();
+		const pid_t end(getpid());
+		if(write(wake_fds[1], &end, sizeof(end))<0) {
+			_exit(1);
+		}
+		_exit(status);
+	}
+
+	running[pid]=connection.fd;
+	connection.running=true;
+	++nbr_jobs;
+	return true;
+}
+
+
+//!Method that gives the network of a job from the cache, or makes the builder thread create it
+Network* SimulationServer::cachedNetwork(const Job& job, double& construction_time) {
+
+	const CacheKey key(job.size.nbr_excitatory, job.size.nbr_inhibitory, job.size.connections_excitatory,
+					   job.size.connections_inhibitory, job.seed);
+
+	//A failed creation is answered to one job, the next jobs of this network try again
+	const auto failed(build_errors.find(key));
+	if(failed!=build_errors.end()) {
+		const std::string message(failed->second);
+		build_errors.erase(failed);
+		throw std::runtime_error(message);
+	}
+
+	const auto kept(cache.find(key));
+	if(kept==cache.end()) {
+		//The builder creates one network at a time : the jobs of the other networks wait for the end of the current one
+		if(!building) {
+			//The network used the longest time ago makes room for the new one, before it is created
+			while(!cache.empty() and cache.size()>=cache_size) {
+				cache.erase(std::min_element(cache.begin(), cache.end(),
+											 [](const std::pair<const CacheKey, CachedNetwork>& a, const std::pair<const CacheKey, CachedNetwork>& b) {
+												 return a.second.last_use<b.second.last_use;
+											 }));
+			}
+			building=true;
+			built=false;
+			building_key=key;
+			builder=std::thread(&SimulationServer::build, this, job);
+		}
+		return nullptr;
+	}
+
+	kept->second.last_use=nbr_jobs;
+	construction_time=kept->second.construction_time;
+	kept->second.construction_time=0.0;
+	return kept->second.network.get();
+}
+
+
+//!Method run by the builder thread, that creates the network of a job and wakes the server
+void SimulationServer::build(const Job& job) {
+
+	const auto start(std::chrono::steady_clock::now());
+	try {
+		built_network.reset(new Network(job.size, job.eta, job.g/JE, job.seed));
+	} catch(const std::exception& error) {
+		build_error=error.what();
+	}
+	const std::chrono::duration<double> duration(std::chrono::steady_clock::now()-start);
+	build_time=duration.count();
+	built=true;
+
+	//The server is woken at once, so that the jobs of the network start
+	const pid_t end(0);
+	if(write(wake_fds[1], &end, sizeof(end))<0) {
+		return;	//The server sees the end of the builder at its next poll, 100 ms later at most
+	}
+}
+
+
+//!Method that adds the network created by the builder thread to the cache, once the thread ended
+void SimulationServer::endBuild() {
+
+	builder.join();
+	building=false;
+	if(built_network) {
+		cache.emplace(building_key, CachedNetwork {std::move(built_network), nbr_jobs, build_time});
+	} else {
+		build_errors[building_key]=build_error;
+	}
+	build_error.clear();
+}
+
+
+//!Method that notes the end of the processes of the finished jobs
+unsigned int SimulationServer::reap(bool wait) {
+
+	unsigned int ended(0);
+	int status;
+	pid_t pid;
+	while((pid=waitpid(-1, &status, wait ? 0 : WNOHANG))!=0) {
+		if(pid<0) {
+			if(errno==EINTR) {
+				continue;
+			}
+			break;
+		}
+		ending.erase(pid);
+		const auto process(running.find(pid));
+		if(process!=running.end()) {
+			connections[process->second].running=false;
+			running.erase(process);
+			++ended;
+		}
+		wait=false;
+	}
+	return ended;
+}
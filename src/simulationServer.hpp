@@ -0,0 +1,200 @@
+//! SimulationServer class
+/*!To run simulations for other programs of the same machine, which send them on a Unix socket, without paying the start of
+ * a process and the creation of the connections at each simulation
+ *
+ * A client sends one job per line, as "name=value" parameters separated by spaces (see parseJob), and receives for each
+ * job, in the order of the jobs of its connection : the rates of the populations per bin as written by
+ * PopulationRateRecorder, while the job runs, then a line "done" followed by the summary of the run in JSON (see
+ * formatRunSummary), or a line "error" followed by the message.
+ *
+ * Like Ensemble, each job runs in its own process, created by fork from the network kept by the server : the connections
+ * are shared by the processes without copy, and only the pages of the state of the neurons are copied. The networks of
+ * the jobs with a seed are kept in a cache, by size and seed, so that the next jobs of a sweep start at once. A network
+ * missing from the cache is created by a builder thread, while the server keeps answering the other clients : the
+ * jobs of this network wait for it in the queue of their connection.
+ */
+#ifndef SIMULATIONSERVER_H
+#define SIMULATIONSERVER_H
+#include "network.hpp"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <sys/types.h>
+
+
+//!Parameters of a job of the server
+struct Job {
+	double time;	//!Simulation time in ms
+	double g;	//!Value of g=JI/JE
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	unsigned int seed;	//!Seed of the connections (0 to draw one : the network is then created for the job only)
+	unsigned int noise_seed;	//!Seed of the background noise (0 for the noise of the network created with seed)
+	NetworkSize size;	//!Numbers of neurons and of connections
+	double rate_bin;	//!Width in ms of the bins of the rates sent during the run (0 for no rates)
+	std::chrono::steady_clock::time_point received;	//!Time when the server received the job
+};
+
+
+//!Function that reads a job
+/*!
+ * the parameters are time, g and eta (needed), seed, noise-seed, excitatory, inhibitory, connections-excitatory,
+   connections-inhibitory (the size of the paper by default) and rate-bin (1 ms by default)
+ * throws std::invalid_argument if a parameter is unknown, missing or not valid
+ *\param line the line sent by the client, for example "time=1000 g=5 eta=2 seed=1"
+ *\return the job
+*/
+Job parseJob(const std::string& line);
+
+
+class SimulationServer {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * creates the socket (an existing file with the same name is replaced)
+	 * throws std::system_error if the socket cannot be created
+	 *\param socket_path_ the name of the socket file
+	 *\param processes_ the maximal number of jobs run at the same time (0 for the number of cores)
+	 *\param cache_size_ the maximal number of networks kept (the one used the longest time ago is removed first, 0 to keep none)
+	*/
+	SimulationServer(const std::string& socket_path_, unsigned int processes_=0, unsigned int long cache_size_=2);
+
+
+	//!Destructor
+	/*!
+	 * waits for the network being created and for the running jobs, closes the connections and removes the socket file
+	*/
+	~SimulationServer();
+
+
+	//!Method that accepts the connections and runs their jobs until stop becomes true
+	/*!
+	 * the networks of the cache are created by the builder thread, one at a time, while the server answers
+	 *\param stop the flag that ends the server (checked 10 times per second, it can be set by a signal handler)
+	*/
+	void serve(const std::atomic<bool>& stop);
+
+
+	//!Getter for the number of networks kept
+	/*!
+	 *\return the number of networks of the cache
+	*/
+	unsigned int long getCachedNetworks() const;
+
+
+
+	private :
+
+	//!Connection of a client
+	struct Connection {
+		int fd;	//!File descriptor of the connected socket
+		std::string input;	//!Bytes received after the last complete line
+		std::string output;	//!Bytes of the errors answered by the server that the socket did not take yet
+		std::deque<std::pair<std::string, std::chrono::steady_clock::time_point>> jobs;	//!Lines of the jobs waiting, with their time
+		bool running;	//!True if a job of the connection is running
+		bool input_closed;	//!True if the client will not send other jobs
+	};
+
+
+	//!Network kept by the server
+	struct CachedNetwork {
+		std::unique_ptr<Network> network;	//!Network, never updated by the server
+		unsigned int long last_use;	//!Number of the last job that used the network
+		double construction_time;	//!Time in s spent creating the network, given to the first job that uses it
+	};
+
+
+	typedef std::tuple<unsigned int long, unsigned int long, unsigned int long, unsigned int long, unsigned int> CacheKey;
+
+
+	//!Method that reads the bytes sent by a client and queues its jobs
+	/*!
+	 *\param connection the connection of the client
+	*/
+	void receive(Connection& connection);
+
+
+	//!Method that sends a line to a client without waiting
+	/*!
+	 * the bytes that the socket does not take are sent by serve when the client reads
+	 *\param connection the connection of the client
+	 *\param line the line, without its end
+	*/
+	void answer(Connection& connection, const std::string& line);
+
+
+	//!Method that sends the bytes of the errors not sent yet to a client, as many as its socket takes without waiting
+	/*!
+	 * a client that is gone loses its other jobs
+	 *\param connection the connection of the client
+	*/
+	void flush(Connection& connection);
+
+
+	//!Method that starts the next job of a connection in its own process
+	/*!
+	 *\param connection the connection of the client
+	 *\return false if the job waits for the creation of its network, true if it was started or answered by an error
+	*/
+	bool start(Connection& connection);
+
+
+	//!Method that gives the network of a job from the cache, or makes the builder thread create it
+	/*!
+	 * throws std::runtime_error if the last creation of this network failed
+	 *\param job the job
+	 *\param construction_time set to the time in s spent creating the network (0 if it was used by another job)
+	 *\return the network kept for the size and the seed of the job, nullptr if it is not created yet
+	*/
+	Network* cachedNetwork(const Job& job, double& construction_time);
+
+
+	//!Method run by the builder thread, that creates the network of a job and wakes the server
+	/*!
+	 *\param job the job
+	*/
+	void build(const Job& job);
+
+
+	//!Method that adds the network created by the builder thread to the cache, once the thread ended
+	void endBuild();
+
+
+	//!Method that notes the end of the processes of the finished jobs
+	/*!
+	 *\param wait true to wait for at least one process
+	 *\return the number of processes of jobs that ended
+	*/
+	unsigned int reap(bool wait);
+
+
+	std::string socket_path;	//!Name of the socket file
+	unsigned int processes;	//!Maximal number of jobs run at the same time
+	unsigned int long cache_size;	//!Maximal number of networks kept
+	int listen_fd;	//!File descriptor of the listening socket
+	int wake_fds[2];	//!Pipe where the process of a job writes its pid when it ends (the builder thread 0), so that the next job starts at once
+	std::set<pid_t> ending;	//!Processes that wrote in the pipe and were not waited for yet
+	std::map<int, Connection> connections;	//!Connections of the clients, by file descriptor
+	std::map<pid_t, int> running;	//!Connection of the job run by each process
+	std::map<CacheKey, CachedNetwork> cache;	//!Networks kept, by size and seed
+	unsigned int long nbr_jobs;	//!Number of jobs started
+	std::thread builder;	//!Thread that creates the network missing from the cache, so that the server keeps answering
+	bool building;	//!True from the start of the builder thread until its network is added to the cache
+	std::atomic<bool> built;	//!True once the builder thread ended
+	CacheKey building_key;	//!Size and seed of the network created by the builder thread
+	std::unique_ptr<Network> built_network;	//!Network created by the builder thread, nullptr if its creation failed
+	double build_time;	//!Time in s spent creating it
+	std::string build_error;	//!Error of the creation
+	std::map<CacheKey, std::string> build_errors;	//!Errors of the creations not answered yet, by size and seed
+
+};
+
+#endif
@@ -0,0 +1,488 @@
+#include "spikeAnalysis.hpp"
+#include "spikeArchive.hpp"
+#include "spikeFile.hpp"
+#include "binaryIo.hpp"
+#include "outputSink.hpp"
+#include "constants.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace {
+
+const size_t buffer_size(1<<20);	//Size of the buffers of the written files
+const size_t archive_round(64);	//Number of chunks of an archive given to each thread at once
+const size_t binary_round(1<<16);	//Number of raster spikes of a binary spike file kept before being written
+
+
+//Window of the analysis, in steps
+struct Window {
+
+	unsigned int long start_step;	//First step of the window
+	unsigned int long stop_step;	//Step following the last step of the window
+	unsigned int long bin_steps;	//Number of steps per bin
+	unsigned int long first_neuron;	//First neuron of the raster
+	unsigned int long last_neuron;	//Last neuron of the raster, included
+	unsigned int long nbr_excitatory;	//Number of excitatory neurons
+
+};
+
+
+//Counts and raster spikes found by one thread
+struct Partial {
+
+	std::vector<unsigned int long> excitatory;	//Number of spikes of the excitatory neurons in each bin
+	std::vector<unsigned int long> inhibitory;	//Number of spikes of the inhibitory neurons in each bin
+	std::vector<Spike> raster;	//Spikes of the raster not written yet
+	unsigned int long spikes;	//Number of spikes in the window
+
+};
+
+
+//Function that adds a spike to the counts of a thread
+inline void addSpike(const Window& window, Partial& partial, unsigned int long step, unsigned int long neuron) {
+
+	if(step<window.start_step or step>=window.stop_step) {
+		return;
+	}
+	++partial.spikes;
+
+	const size_t bin((step-window.start_step)/window.bin_steps);
+	if(bin>=partial.excitatory.size()) {
+		partial.excitatory.resize(bin+1, 0);
+		partial.inhibitory.resize(bin+1, 0);
+	}
+	if(neuron<window.nbr_excitatory) {
+		++partial.excitatory[bin];
+	} else {
+		++partial.inhibitory[bin];
+	}
+
+	if(neuron>=window.first_neuron and neuron<=window.last_neuron) {
+		partial.raster.push_back(Spike {step, neuron});
+	}
+}
+
+
+//Function that runs task(0), ..., task(count-1) in parallel and throws the first exception of the tasks
+template<typename Task>
+void runParallel(size_t count, const Task& task) {
+
+	std::vector<std::exception_ptr> errors(count);
+	std::vector<std::thread> threads;
+	for(size_t i(1); i<count; ++i) {
+		threads.emplace_back([&, i]() {
+			try {
+				task(i);
+			} catch(...) {
+				errors[i]=std::current_exception();
+			}
+		});
+	}
+
+	//The first task is done by the calling thread
+	try {
+		task(0);
+	} catch(...) {
+		errors[0]=std::current_exception();
+	}
+
+	for(auto& thread : threads) {
+		thread.join();
+	}
+	for(const auto& error : errors) {
+		if(error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+
+//File of rows of numbers, as csv or as little-endian doubles
+class TableWriter {
+
+	public :
+
+	//Constructor
+	TableWriter(const std::string& filename, AnalysisFormat format_, const std::string& header, std::vector<int> precisions_)
+	: sink(makeSink(filename, SinkBackend::Stream)), format(format_), precisions(precisions_), rows(0)
+	{
+		if(format==AnalysisFormat::Csv) {
+			buffer.assign(header.begin(), header.end());
+		}
+	}
+
+
+	//Method that appends a row (one value per column)
+	void writeRow(const double* values) {
+
+		if(format==AnalysisFormat::Binary) {
+			for(size_t i(0); i<precisions.size(); ++i) {
+				appendDouble(buffer, values[i]);
+			}
+		} else {
+			char line[64];
+			for(size_t i(0); i<precisions.size(); ++i) {
+				const int size(std::snprintf(line, sizeof(line), "%.*f%c", precisions[i], values[i], i+1<precisions.size() ? ',' : '\n'));
+				buffer.insert(buffer.end(), line, line+size);
+			}
+		}
+
+		++rows;
+		if(buffer.size()>=buffer_size) {
+			flush();
+		}
+	}
+
+
+	//Getter for the number of rows written
+	unsigned int long getRows() const {
+		return rows;
+	}
+
+
+	//Method that writes the end of the buffer and closes the file
+	void close() {
+		flush();
+		sink->close();
+	}
+
+
+
+	private :
+
+	//Method that writes the buffer in the file
+	void flush() {
+		sink->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		buffer.clear();
+	}
+
+
+	std::unique_ptr<OutputSink> sink;	//Written file
+	AnalysisFormat format;	//Format of the file
+	std::vector<int> precisions;	//Number of decimals of each column in csv
+	std::vector<unsigned char> buffer;	//Rows not written yet
+	unsigned int long rows;	//Number of rows written
+
+};
+
+
+//Function that writes the spikes of a raster
+void writeRaster(TableWriter& raster_file, const std::vector<Spike>& spikes, double h) {
+	for(const auto& spike : spikes) {
+		const double row[2]={spike.step*h, double(spike.neuron+1)};
+		raster_file.writeRow(row);
+	}
+}
+
+
+//Function that parses the lines "step \t neuron number" of a part of a text spike file
+void parseText(const char* position, const char* end, const Window& window, Partial& partial) {
+
+	while(position<end) {
+
+		//Empty lines and comments are skipped
+		if(*position=='\n' or *position=='\r' or *position=='#') {
+			position=static_cast<const char*>(std::memchr(position, '\n', end-position));
+			position=(position==nullptr) ? end : position+1;
+			continue;
+		}
+
+		unsigned int long values[2]={0, 0};
+		for(auto& value : values) {
+			while(position<end and (*position==' ' or *position=='\t')) {
+				++position;
+			}
+			if(position==end or *position<'0' or *position>'9') {
+				throw std::runtime_error("The spike file contains a line which is not \"time step \\t neuron number\"");
+			}
+			for(; position<end and *position>='0' and *position<='9'; ++position) {
+				value=value*10+(*position-'0');
+			}
+		}
+		if(values[1]==0) {
+			throw std::runtime_error("The neurons of a text spike file are numbered from 1");
+		}
+		addSpike(window, partial, values[0], values[1]-1);
+
+		while(position<end and *position!='\n') {
+			++position;
+		}
+		++position;
+	}
+}
+
+
+//Function that analyses a text spike file by parts of chunk_size bytes, one part per thread
+size_t analyzeText(const std::string& filename, const Window& window, size_t chunk_size, std::vector<Partial>& partials,
+				   TableWriter& raster_file) {
+
+	const int fd(::open(filename.c_str(), O_RDONLY));
+	if(fd<0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot open "+filename);
+	}
+	struct stat status;
+	if(fstat(fd, &status)!=0) {
+		const int error(errno);
+		::close(fd);
+		throw std::system_error(error, std::generic_category(), "Cannot read "+filename);
+	}
+	const size_t size(status.st_size);
+	if(size==0) {
+		::close(fd);
+		return 0;
+	}
+
+	void* mapping(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+	::close(fd);
+	if(mapping==MAP_FAILED) {
+		throw std::runtime_error("Cannot map "+filename);
+	}
+	const char* data(static_cast<const char*>(mapping));
+	madvise(mapping, size, MADV_SEQUENTIAL);
+
+	const size_t page_size(sysconf(_SC_PAGESIZE));
+	size_t chunks(0);
+	size_t position(0);	//Start of the next part
+	size_t released(0);	//End of the pages already given back to the system
+
+	try {
+		while(position<size) {
+
+			//The parts of a round end at the end of a line
+			std::vector<size_t> bounds(1, position);
+			while(bounds.size()<=partials.size() and position<size) {
+				position=std::min(size, position+chunk_size);
+				const void* newline(std::memchr(data+position, '\n', size-position));
+				position=(newline==nullptr) ? size : static_cast<const char*>(newline)-data+1;
+				bounds.push_back(position);
+			}
+			chunks+=bounds.size()-1;
+
+			runParallel(bounds.size()-1, [&](size_t i) {
+				parseText(data+bounds[i], data+bounds[i+1], window, partials[i]);
+			});
+
+			//The parts are in the order of the file, so their raster spikes are written in this order
+			for(auto& partial : partials) {
+				writeRaster(raster_file, partial.raster, h);
+				partial.raster.clear();
+			}
+
+			//The pages already analysed are not kept in memory
+			const size_t end(position/page_size*page_size);
+			if(end>released) {
+				madvise(const_cast<char*>(data)+released, end-released, MADV_DONTNEED);
+				released=end;
+			}
+		}
+	} catch(...) {
+		munmap(mapping, size);
+		throw;
+	}
+
+	munmap(mapping, size);
+	return chunks;
+}
+
+
+//Function that analyses a binary spike file, which can only be decoded from its start
+size_t analyzeBinary(SpikeFileReader& reader, const Window& window, Partial& partial, TableWriter& raster_file) {
+
+	unsigned int long step;
+	std::vector<unsigned int long> spikes;
+	while(reader.nextStep(step, spikes) and step<window.stop_step) {
+		for(auto neuron : spikes) {
+			addSpike(window, partial, step, neuron);
+		}
+		if(partial.raster.size()>=binary_round) {
+			writeRaster(raster_file, partial.raster, reader.getInfo().h);
+			partial.raster.clear();
+		}
+	}
+	writeRaster(raster_file, partial.raster, reader.getInfo().h);
+	partial.raster.clear();
+
+	return 1;
+}
+
+
+//Function that analyses the chunks of an archive, by rounds of archive_round chunks per thread
+size_t analyzeArchive(const SpikeArchive& archive, const Window& window, std::vector<Partial>& partials, TableWriter& raster_file) {
+
+	//The chunks outside of the window are not read
+	std::vector<ChunkEntry> entries;
+	for(const auto& entry : archive.getIndex()) {
+		if(entry.last_step>=window.start_step and entry.first_step<window.stop_step) {
+			entries.push_back(entry);
+		}
+	}
+
+	std::vector<Spike> raster;
+	std::vector<std::vector<Spike> > decoded(partials.size());
+	for(size_t first(0); first<entries.size();) {
+
+		//A round ends between two windows, so that the spikes of the next rounds come after its spikes
+		size_t last(std::min(entries.size(), first+archive_round*partials.size()));
+		unsigned int long last_step(0);
+		for(size_t i(first); i<last; ++i) {
+			last_step=std::max(last_step, entries[i].last_step);
+		}
+		for(; last<entries.size() and entries[last].first_step<=last_step; ++last) {
+			last_step=std::max(last_step, entries[last].last_step);
+		}
+
+		runParallel(std::min(partials.size(), last-first), [&](size_t thread) {
+			for(size_t i(first+thread); i<last; i+=partials.size()) {
+				decoded[thread].clear();
+				archive.readChunk(entries[i], decoded[thread]);
+				for(const auto& spike : decoded[thread]) {
+					addSpike(window, partials[thread], spike.step, spike.neuron);
+				}
+			}
+		});
+
+		//The chunks of the different blocks of neurons are merged
+		for(auto& partial : partials) {
+			raster.insert(raster.end(), partial.raster.begin(), partial.raster.end());
+			partial.raster.clear();
+		}
+		std::sort(raster.begin(), raster.end(), [](const Spike& a, const Spike& b) {
+			return a.step<b.step or (a.step==b.step and a.neuron<b.neuron);
+		});
+		writeRaster(raster_file, raster, archive.getInfo().h);
+		raster.clear();
+
+		first=last;
+	}
+
+	return entries.size();
+}
+
+}
+
+
+//!Function that gives the default parameters of an analysis
+AnalysisOptions defaultAnalysisOptions() {
+	return AnalysisOptions {0.0, -1.0, 0, 49, h, 0, 8<<20, AnalysisFormat::Csv, 0, 0};
+}
+
+
+//!Function that reads a spike file once and writes the raster and the rates
+AnalysisSummary analyzeSpikes(const std::string& input_filename, const std::string& raster_filename,
+							  const std::string& rate_filename, const AnalysisOptions& options) {
+
+	if(options.bin_width<=0.0 or options.start<0.0 or (options.stop>=0.0 and options.stop<options.start)) {
+		throw std::invalid_argument("The window of the analysis must be positive and its bins must not be empty");
+	}
+	if(options.last_neuron<options.first_neuron or options.chunk_size==0) {
+		throw std::invalid_argument("The raster must contain at least one neuron and the chunks at least one byte");
+	}
+
+	AnalysisSummary summary;
+	summary.threads=(options.threads>0) ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+	//The format of the file is recognized by its first bytes
+	char magic[8]={};
+	{
+		std::ifstream input_file(input_filename, std::ios::binary);
+		if(!input_file) {
+			throw std::runtime_error("Cannot open "+input_filename);
+		}
+		input_file.read(magic, sizeof(magic));
+	}
+	const bool binary(std::memcmp(magic, "BRUNSPK1", sizeof(magic))==0);
+	const bool archived(std::memcmp(magic, "BRUNSPA1", sizeof(magic))==0);
+
+	std::unique_ptr<SpikeFileReader> reader;
+	std::unique_ptr<SpikeArchive> archive;
+	if(binary) {
+		reader.reset(new SpikeFileReader(input_filename));
+		summary.info=reader->getInfo();
+	} else if(archived) {
+		archive.reset(new SpikeArchive(input_filename));
+		summary.info=archive->getInfo();
+	} else {
+		//A text file does not store the parameters of the run : its numbers of neurons must be given, for the rates
+		if(options.nbr_excitatory+options.nbr_inhibitory==0) {
+			throw std::invalid_argument(input_filename+" is a text file, which does not store the numbers of neurons : they must be given");
+		}
+		summary.info=RunInfo {h, 0.0, 0.0, 0, options.nbr_excitatory+options.nbr_inhibitory, options.nbr_excitatory, 0};
+	}
+
+	Window window;
+	window.start_step=std::lround(options.start/summary.info.h);
+	if(options.stop>=0.0) {
+		window.stop_step=std::lround(options.stop/summary.info.h);
+	} else {
+		window.stop_step=(binary or archived) ? summary.info.simtime : std::numeric_limits<unsigned int long>::max();
+	}
+	window.bin_steps=std::max(1l, std::lround(options.bin_width/summary.info.h));
+	window.first_neuron=options.first_neuron;
+	window.last_neuron=options.last_neuron;
+	window.nbr_excitatory=summary.info.nbrExcitatory;
+
+	TableWriter raster_file(raster_filename, options.format, "time (ms),neuron\n", std::vector<int> {3, 0});
+	TableWriter rate_file(rate_filename, options.format,
+						  "time (ms),excitatory spikes,inhibitory spikes,excitatory rate (Hz),inhibitory rate (Hz)\n",
+						  std::vector<int> {3, 0, 0, 3, 3});
+
+	std::vector<Partial> partials(binary ? 1 : summary.threads, Partial {{}, {}, {}, 0});
+	if(binary) {
+		summary.chunks=analyzeBinary(*reader, window, partials.front(), raster_file);
+	} else if(archived) {
+		summary.chunks=analyzeArchive(*archive, window, partials, raster_file);
+	} else {
+		summary.chunks=analyzeText(input_filename, window, options.chunk_size, partials, raster_file);
+	}
+	raster_file.close();
+	summary.raster_spikes=raster_file.getRows();
+
+	//The counts of the threads are added
+	summary.bins=0;
+	if(window.stop_step!=std::numeric_limits<unsigned int long>::max()) {
+		summary.bins=(window.stop_step-window.start_step+window.bin_steps-1)/window.bin_steps;
+	}
+	for(const auto& partial : partials) {
+		summary.bins=std::max<unsigned int long>(summary.bins, partial.excitatory.size());
+	}
+	std::vector<unsigned int long> excitatory(summary.bins, 0);
+	std::vector<unsigned int long> inhibitory(summary.bins, 0);
+	summary.spikes=0;
+	for(const auto& partial : partials) {
+		for(size_t bin(0); bin<partial.excitatory.size(); ++bin) {
+			excitatory[bin]+=partial.excitatory[bin];
+			inhibitory[bin]+=partial.inhibitory[bin];
+		}
+		summary.spikes+=partial.spikes;
+	}
+
+	//Rate of a population : number of spikes / (number of neurons * duration of the bin in s)
+	const double duration(window.bin_steps*summary.info.h/1000.0);
+	const unsigned int long nbr_inhibitory(summary.info.nbrNeurons-summary.info.nbrExcitatory);
+	for(unsigned int long bin(0); bin<summary.bins; ++bin) {
+		const double row[5]={(window.start_step+bin*window.bin_steps)*summary.info.h, double(excitatory[bin]), double(inhibitory[bin]),
+							 summary.info.nbrExcitatory>0 ? excitatory[bin]/(summary.info.nbrExcitatory*duration) : 0.0,
+							 nbr_inhibitory>0 ? inhibitory[bin]/(nbr_inhibitory*duration) : 0.0};
+		rate_file.writeRow(row);
+	}
+	rate_file.close();
+
+	return summary;
+}
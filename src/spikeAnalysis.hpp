@@ -0,0 +1,79 @@
+//! Spike analysis
+/*!To compute the data of the figures (raster plot and population rates) from a spike file, in one pass and with several threads
+ *
+ * The spike file can be a text file written by TextSpikeRecorder or SpikesToText, a binary spike file (see spikeFile.hpp)
+ * or a spike archive (see spikeArchive.hpp), recognized by its first bytes.
+ *
+ * Two files are written :
+ * - the raster : one line "time (ms),neuron number" per spike of the chosen neurons (numbered from 1)
+ * - the rates : one line "time (ms),excitatory spikes,inhibitory spikes,excitatory rate (Hz),inhibitory rate (Hz)" per bin
+ * In the binary format, the lines are replaced by the same columns as little-endian doubles, without header.
+ */
+#ifndef SPIKEANALYSIS_H
+#define SPIKEANALYSIS_H
+#include "recorder.hpp"
+#include <cstddef>
+#include <string>
+
+
+
+//!Format of the files written by the analysis
+enum class AnalysisFormat {
+	Csv,	//!Text with a header line and comma separated columns
+	Binary	//!Little-endian doubles, ready to be loaded as an array
+};
+
+
+//!Parameters of an analysis
+struct AnalysisOptions {
+
+	double start;	//!Start of the analysed window in ms
+	double stop;	//!End of the analysed window in ms (negative for the end of the run)
+	unsigned int long first_neuron;	//!First neuron of the raster (numbered from 0)
+	unsigned int long last_neuron;	//!Last neuron of the raster, included
+	double bin_width;	//!Width of the bins of the rates in ms
+	unsigned int threads;	//!Number of threads (0 for the number of cores)
+	size_t chunk_size;	//!Size in bytes of the parts of a text file given to each thread
+	AnalysisFormat format;	//!Format of the written files
+	unsigned int long nbr_excitatory;	//!Number of excitatory neurons of a text file, which does not store it (0 if unknown)
+	unsigned int long nbr_inhibitory;	//!Number of inhibitory neurons of a text file (0 if unknown)
+
+};
+
+
+//!Result of an analysis
+struct AnalysisSummary {
+
+	RunInfo info;	//!Parameters of the run (for a text file, h and the numbers of neurons of the options only)
+	unsigned int long spikes;	//!Number of spikes in the window
+	unsigned int long raster_spikes;	//!Number of spikes written in the raster
+	unsigned int long bins;	//!Number of bins of the rates
+	size_t chunks;	//!Number of parts of the file analysed separately
+	unsigned int threads;	//!Number of threads used
+
+};
+
+
+//!Function that gives the default parameters of an analysis
+/*!
+ *\return the whole run, the neurons 1 to 50 in the raster, bins of h, csv files, one thread per core and no numbers of
+   neurons for a text file
+*/
+AnalysisOptions defaultAnalysisOptions();
+
+
+//!Function that reads a spike file once and writes the raster and the rates
+/*!
+ * the memory used depends on the number of threads, on chunk_size and on the number of bins, not on the size of the file
+ * throws std::invalid_argument if the options are not valid, or if the file is a text file and the options do not give
+   its numbers of neurons
+ *\param input_filename the name of the spike file
+ *\param raster_filename the name of the raster file to create
+ *\param rate_filename the name of the rate file to create
+ *\param options the parameters of the analysis
+ *\return the numbers of spikes, bins and chunks
+*/
+AnalysisSummary analyzeSpikes(const std::string& input_filename, const std::string& raster_filename,
+							  const std::string& rate_filename, const AnalysisOptions& options);
+
+#endif
@@ -0,0 +1,316 @@
+#include "spikeArchive.hpp"
+#include "spikeFile.hpp"
+#include "binaryIo.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace {
+
+const char magic[8]={'B','R','U','N','S','P','A','1'};	//Magic string at the start of the archives
+const char index_magic[8]={'B','R','U','N','I','D','X','2'};	//Magic string at the end of the archives
+const char old_index_magic[8]={'B','R','U','N','I','D','X','1'};	//Magic string at the end of the archives of the version 1
+const unsigned int version(2);	//Version of the archive format
+const size_t header_size(80);	//Size of the header in bytes
+const size_t entry_size(48);	//Size of an entry of the index in bytes
+const size_t trailer_size(32);	//Size of the end of the file after the index in bytes
+const size_t old_trailer_size(24);	//Size of the end of the file after the index in the version 1, without the number of steps done
+
+}
+
+
+//!Constructor
+SpikeArchiveRecorder::SpikeArchiveRecorder(const std::string& filename, double chunk_duration_, unsigned int long chunk_neurons_,
+										   SinkBackend backend)
+: sink(makeSink(filename, backend)), chunk_duration(chunk_duration_), chunk_neurons(std::max(1ul, chunk_neurons_)),
+  chunk_steps(1), window_start(0), offset(0), steps(0)
+{}
+
+
+//!Destructor
+SpikeArchiveRecorder::~SpikeArchiveRecorder() {
+	if(sink) {
+		try {
+			close();
+		} catch(const std::exception&) {}	//A destructor called during the unwinding of an error must not throw
+	}
+}
+
+
+//!Method that writes the header of the archive
+void SpikeArchiveRecorder::open(const RunInfo& info) {
+
+	chunk_steps=std::max(1l, std::lround(chunk_duration/info.h));
+	window_start=0;
+	steps=info.simtime;
+	index.clear();
+	pending.assign((info.nbrNeurons+chunk_neurons-1)/chunk_neurons, std::vector<Spike>());
+
+	unsigned char header[header_size]={};
+	std::memcpy(header, magic, sizeof(magic));
+	putInteger(header+8, version, 4);
+	putDouble(header+16, info.h);
+	putDouble(header+24, info.g);
+	putDouble(header+32, info.eta);
+	putInteger(header+40, info.simtime, 8);
+	putInteger(header+48, info.nbrNeurons, 8);
+	putInteger(header+56, info.nbrExcitatory, 8);
+	putInteger(header+64, chunk_steps, 8);
+	putInteger(header+72, chunk_neurons, 8);
+
+	sink->write(reinterpret_cast<const char*>(header), sizeof(header));
+	offset=sizeof(header);
+}
+
+
+//!Method that stores the spikes of a step in the chunks of the current window
+void SpikeArchiveRecorder::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+
+	if(spikes.empty()) {
+		return;
+	}
+
+	//The window of the step is started once the previous one is written
+	if(step>=window_start+chunk_steps) {
+		writeWindow();
+		window_start=step-step%chunk_steps;
+	}
+
+	for(auto neuron : spikes) {
+		pending[neuron/chunk_neurons].push_back(Spike {step, neuron});
+	}
+}
+
+
+//!Method that notes the number of steps done, written after the index instead of the simulation time
+void SpikeArchiveRecorder::stopEarly(unsigned int long steps_) {
+	steps=steps_;
+}
+
+
+//!Method that writes the last chunks and the index, and closes the archive
+void SpikeArchiveRecorder::close() {
+
+	if(!sink) {
+		return;
+	}
+
+	writeWindow();
+
+	const unsigned int long index_offset(offset);
+	buffer.clear();
+	for(const auto& entry : index) {
+		appendInteger(buffer, entry.first_step, 8);
+		appendInteger(buffer, entry.last_step, 8);
+		appendInteger(buffer, entry.first_neuron, 8);
+		appendInteger(buffer, entry.last_neuron, 8);
+		appendInteger(buffer, entry.offset, 8);
+		appendInteger(buffer, entry.size, 8);
+	}
+	appendInteger(buffer, steps, 8);
+	appendInteger(buffer, index.size(), 8);
+	appendInteger(buffer, index_offset, 8);
+	buffer.insert(buffer.end(), index_magic, index_magic+sizeof(index_magic));
+
+	sink->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+
+	//The sink is released first, so that a sink that fails is not closed again by the destructor
+	std::unique_ptr<OutputSink> closed_sink(std::move(sink));
+	closed_sink->close();
+}
+
+
+//!Method that writes the chunks of the current window and starts the next window
+void SpikeArchiveRecorder::writeWindow() {
+
+	for(auto& spikes : pending) {
+
+		if(spikes.empty()) {
+			continue;
+		}
+
+		ChunkEntry entry {spikes.front().step, spikes.back().step, spikes.front().neuron, spikes.front().neuron, offset, 0};
+
+		//The spikes of the block are grouped by step
+		buffer.clear();
+		unsigned int long next_step(window_start);
+		for(size_t i(0); i<spikes.size();) {
+			step_spikes.clear();
+			const unsigned int long step(spikes[i].step);
+			for(; i<spikes.size() and spikes[i].step==step; ++i) {
+				step_spikes.push_back(spikes[i].neuron);
+				entry.first_neuron=std::min(entry.first_neuron, spikes[i].neuron);
+				entry.last_neuron=std::max(entry.last_neuron, spikes[i].neuron);
+			}
+			appendStepBlock(buffer, step, next_step, step_spikes);
+			next_step=step+1;
+		}
+
+		entry.size=buffer.size();
+		sink->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		offset+=buffer.size();
+		index.push_back(entry);
+
+		spikes.clear();
+	}
+}
+
+
+
+//!Constructor
+SpikeArchive::SpikeArchive(const std::string& filename) : data(nullptr), size(0), chunk_steps(1), chunks_read(0) {
+
+	const int fd(::open(filename.c_str(), O_RDONLY));
+	if(fd<0) {
+		throw std::system_error(errno, std::generic_category(), "Cannot open "+filename);
+	}
+
+	struct stat status;
+	if(fstat(fd, &status)!=0) {
+		const int error(errno);
+		::close(fd);
+		throw std::system_error(error, std::generic_category(), "Cannot read "+filename);
+	}
+	size=status.st_size;
+
+	//Only the pages of the header, of the index and of the queried chunks are read from the disk
+	void* mapping(size>0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED);
+	::close(fd);
+	if(mapping==MAP_FAILED) {
+		throw std::runtime_error("Cannot map "+filename);
+	}
+	data=static_cast<const unsigned char*>(mapping);
+
+	//The archives of the version 1 have a shorter end, without the number of steps done
+	const bool old_version(size>=header_size+old_trailer_size
+						   and std::memcmp(data+size-sizeof(old_index_magic), old_index_magic, sizeof(old_index_magic))==0);
+	const size_t end_size(old_version ? old_trailer_size : trailer_size);
+	if(size<header_size+end_size or std::memcmp(data, magic, sizeof(magic))!=0
+	   or (!old_version and std::memcmp(data+size-sizeof(index_magic), index_magic, sizeof(index_magic))!=0)) {
+		munmap(const_cast<unsigned char*>(data), size);
+		throw std::runtime_error(filename+" is not a complete spike archive");
+	}
+
+	info.h=getDouble(data+16);
+	info.g=getDouble(data+24);
+	info.eta=getDouble(data+32);
+	info.simtime=getInteger(data+40, 8);
+	info.nbrNeurons=getInteger(data+48, 8);
+	info.nbrExcitatory=getInteger(data+56, 8);
+	info.first_step=0;
+	chunk_steps=getInteger(data+64, 8);
+
+	if(!old_version) {
+		info.simtime=getInteger(data+size-trailer_size, 8);
+	}
+
+	//In both versions, the number of chunks and the position of the index are just before the magic string
+	const unsigned char* end(data+size-sizeof(index_magic));
+	const size_t nbr_chunks(getInteger(end-16, 8));
+	const size_t index_offset(getInteger(end-8, 8));
+	if(index_offset+nbr_chunks*entry_size+end_size!=size) {
+		munmap(const_cast<unsigned char*>(data), size);
+		throw std::runtime_error(filename+" has a corrupted index");
+	}
+
+	for(size_t i(0); i<nbr_chunks; ++i) {
+		const unsigned char* entry(data+index_offset+i*entry_size);
+		index.push_back(ChunkEntry {getInteger(entry, 8), getInteger(entry+8, 8), getInteger(entry+16, 8),
+									getInteger(entry+24, 8), getInteger(entry+32, 8), getInteger(entry+40, 8)});
+	}
+}
+
+
+//!Destructor
+SpikeArchive::~SpikeArchive() {
+	munmap(const_cast<unsigned char*>(data), size);
+}
+
+
+//!Getter for the parameters of the run stored in the header
+const RunInfo& SpikeArchive::getInfo() const {
+	return info;
+}
+
+
+//!Getter for the index of the archive
+const std::vector<ChunkEntry>& SpikeArchive::getIndex() const {
+	return index;
+}
+
+
+//!Method that reads the spikes of a window
+std::vector<Spike> SpikeArchive::query(unsigned int long start_step, unsigned int long stop_step,
+									   unsigned int long first_neuron, unsigned int long last_neuron) {
+
+	std::vector<Spike> spikes;
+	chunks_read=0;
+
+	for(const auto& entry : index) {
+
+		//The chunks that do not intersect the window are skipped without being read
+		if(entry.last_step<start_step or entry.first_step>=stop_step
+		   or entry.last_neuron<first_neuron or entry.first_neuron>last_neuron) {
+			continue;
+		}
+		++chunks_read;
+
+		//Only the spikes of the chunk that are in the window are kept
+		const size_t first(spikes.size());
+		readChunk(entry, spikes);
+		spikes.erase(std::remove_if(spikes.begin()+first, spikes.end(), [&](const Spike& spike) {
+			return spike.step<start_step or spike.step>=stop_step or spike.neuron<first_neuron or spike.neuron>last_neuron;
+		}), spikes.end());
+	}
+
+	//The chunks of the different blocks of neurons of a window are merged
+	std::sort(spikes.begin(), spikes.end(), [](const Spike& a, const Spike& b) {
+		return a.step<b.step or (a.step==b.step and a.neuron<b.neuron);
+	});
+
+	return spikes;
+}
+
+
+//!Method that decodes all the spikes of a chunk
+void SpikeArchive::readChunk(const ChunkEntry& entry, std::vector<Spike>& spikes) const {
+
+	const unsigned char* position(data+entry.offset);
+	const unsigned char* end(position+entry.size);
+	unsigned int long next_step(entry.first_step-entry.first_step%chunk_steps);	//First step of the window of the chunk
+
+	while(position<end) {
+		unsigned int long gap, count;
+		if(!readVarint(position, end, gap) or !readVarint(position, end, count)) {
+			throw std::runtime_error("Corrupted chunk in the spike archive");
+		}
+		const unsigned int long step(next_step+gap);
+		next_step=step+1;
+
+		unsigned int long neuron(0);
+		for(unsigned int long i(0); i<count; ++i) {
+			if(!readVarint(position, end, gap)) {
+				throw std::runtime_error("Corrupted chunk in the spike archive");
+			}
+			neuron=(i==0) ? gap : neuron+gap+1;
+			spikes.push_back(Spike {step, neuron});
+		}
+	}
+}
+
+
+//!Getter for the number of chunks decoded by the last query
+size_t SpikeArchive::getChunksRead() const {
+	return chunks_read;
+}
@@ -0,0 +1,198 @@
+//! Spike archive
+/*!To store the spikes in chunks indexed by time and neuron number, so that a window can be read without the whole file
+ *
+ * The file starts with a header of 80 bytes (little-endian) :
+ * - the magic string "BRUNSPA1" and the format version (uint32) followed by 4 unused bytes
+ * - h, g and eta (double)
+ * - the simulation time in steps, the number of neurons and the number of excitatory neurons (uint64)
+ * - the number of steps and the number of neurons covered by a chunk (uint64)
+ *
+ * Then come the chunks : each chunk holds the spikes of a block of neurons during a window of steps,
+ * as step blocks of the binary spike format (see spikeFile.hpp), the first gap being counted from the first step of the window.
+ *
+ * The file ends with the index, one entry of 48 bytes per chunk :
+ * - the first and the last step with spikes, the smallest and the largest neuron number (uint64)
+ * - the position of the chunk in the file and its size in bytes (uint64)
+ * followed by the number of steps done (uint64, smaller than the simulation time of the header if the run stopped early),
+ * the number of chunks, the position of the index (uint64) and the magic string "BRUNIDX2".
+ * The archives of the version 1 end with "BRUNIDX1" without the number of steps done.
+ */
+#ifndef SPIKEARCHIVE_H
+#define SPIKEARCHIVE_H
+#include "recorder.hpp"
+#include "outputSink.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+//!Spike read from an archive
+struct Spike {
+
+	unsigned int long step;	//!Step of the spike
+	unsigned int long neuron;	//!Number of the neuron that spiked
+
+};
+
+
+//!Entry of the index of an archive
+struct ChunkEntry {
+
+	unsigned int long first_step;	//!First step with spikes in the chunk
+	unsigned int long last_step;	//!Last step with spikes in the chunk
+	unsigned int long first_neuron;	//!Smallest neuron number of the chunk
+	unsigned int long last_neuron;	//!Largest neuron number of the chunk
+	unsigned int long offset;	//!Position of the chunk in the file
+	unsigned int long size;	//!Size of the chunk in bytes
+
+};
+
+
+
+//! Recorder of the spikes in a chunked archive
+class SpikeArchiveRecorder : public Recorder {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param filename the name of the archive
+	 *\param chunk_duration_ the duration covered by a chunk in ms
+	 *\param chunk_neurons_ the number of neurons covered by a chunk
+	 *\param backend the system interface used to write the file
+	*/
+	SpikeArchiveRecorder(const std::string& filename, double chunk_duration_=100.0, unsigned int long chunk_neurons_=1024,
+						 SinkBackend backend=SinkBackend::Stream);
+
+
+	//!Destructor
+	virtual ~SpikeArchiveRecorder();
+
+
+	//!Method that writes the header of the archive
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info) override;
+
+
+	//!Method that stores the spikes of a step in the chunks of the current window
+	/*!
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step, in increasing order
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Method that notes the number of steps done, written after the index instead of the simulation time
+	/*!
+	 *\param steps the number of steps done
+	*/
+	virtual void stopEarly(unsigned int long steps) override;
+
+
+	//!Method that writes the last chunks and the index, and closes the archive
+	virtual void close() override;
+
+
+
+	private :
+
+	//!Method that writes the chunks of the current window and starts the next window
+	void writeWindow();
+
+
+	std::unique_ptr<OutputSink> sink;	//!Archive
+	double chunk_duration;	//!Asked duration of a chunk in ms
+	unsigned int long chunk_neurons;	//!Number of neurons covered by a chunk
+	unsigned int long chunk_steps;	//!Number of steps covered by a chunk
+	unsigned int long window_start;	//!First step of the current window
+	unsigned int long offset;	//!Size of the archive written until now
+	unsigned int long steps;	//!Number of steps done, written after the index
+	std::vector<std::vector<Spike> > pending;	//!Spikes of the current window, for each block of neurons
+	std::vector<ChunkEntry> index;	//!Index of the written chunks
+	std::vector<unsigned char> buffer;	//!Encoded chunk
+	std::vector<unsigned int long> step_spikes;	//!Spikes of one step of a chunk
+
+};
+
+
+
+//! Reader of the archives, that maps the file in memory and only decodes the chunks of a query
+class SpikeArchive {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * maps the archive in memory and reads its header and its index (the simulation time is the number of steps done)
+	 *\param filename the name of the archive
+	*/
+	SpikeArchive(const std::string& filename);
+
+
+	//!The mapping of the archive is not shared between copies
+	SpikeArchive(const SpikeArchive&)=delete;
+	SpikeArchive& operator=(const SpikeArchive&)=delete;
+
+
+	//!Destructor
+	~SpikeArchive();
+
+
+	//!Getter for the parameters of the run stored in the header
+	/*!
+	 *\return the parameters of the run
+	*/
+	const RunInfo& getInfo() const;
+
+
+	//!Getter for the index of the archive
+	/*!
+	 *\return the entries of the chunks of the archive
+	*/
+	const std::vector<ChunkEntry>& getIndex() const;
+
+
+	//!Method that reads the spikes of a window
+	/*!
+	 *\param start_step the first step of the window
+	 *\param stop_step the step following the last step of the window
+	 *\param first_neuron the smallest neuron number of the window
+	 *\param last_neuron the largest neuron number of the window
+	 *\return the spikes of the window, ordered by step then by neuron number
+	*/
+	std::vector<Spike> query(unsigned int long start_step, unsigned int long stop_step,
+							 unsigned int long first_neuron, unsigned int long last_neuron);
+
+
+	//!Method that decodes all the spikes of a chunk
+	/*!
+	 * can be called from several threads at the same time
+	 *\param entry the entry of the chunk in the index
+	 *\param spikes the vector where to append the spikes of the chunk, ordered by step then by neuron number
+	*/
+	void readChunk(const ChunkEntry& entry, std::vector<Spike>& spikes) const;
+
+
+	//!Getter for the number of chunks decoded by the last query
+	/*!
+	 *\return the number of chunks decoded by the last query
+	*/
+	size_t getChunksRead() const;
+
+
+
+	private :
+
+	const unsigned char* data;	//!Mapping of the archive
+	size_t size;	//!Size of the archive
+	RunInfo info;	//!Parameters of the run
+	unsigned int long chunk_steps;	//!Number of steps covered by a chunk
+	std::vector<ChunkEntry> index;	//!Index of the chunks
+	size_t chunks_read;	//!Number of chunks decoded by the last query
+
+};
+
+#endif
@@ -0,0 +1,268 @@
+#include "spikeFile.hpp"
+#include "binaryIo.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+const char magic[8]={'B','R','U','N','S','P','K','1'};	//Magic string at the start of the binary spike files
+const char end_magic[8]={'B','R','U','N','E','N','D','1'};	//Magic string at the end of the trailer
+const size_t buffer_size(1<<20);	//Size of the buffers used to write and read the files
+
+}
+
+
+//!Function that appends the block of a step to a buffer
+void appendStepBlock(std::vector<unsigned char>& buffer, unsigned int long step, unsigned int long next_step, const std::vector<unsigned int long>& spikes) {
+
+	appendVarint(buffer, step-next_step);	//Number of steps without spikes since the previous block
+	appendVarint(buffer, spikes.size());
+
+	//The neuron numbers are stored as gaps, which are small when a lot of neurons spike during the same step
+	unsigned int long previous(0);
+	for(size_t i(0); i<spikes.size(); ++i) {
+		appendVarint(buffer, (i==0) ? spikes[i] : spikes[i]-previous-1);
+		previous=spikes[i];
+	}
+}
+
+
+//!Function that reads a varint from a buffer
+bool readVarint(const unsigned char*& position, const unsigned char* end, unsigned int long& value) {
+
+	value=0;
+	for(unsigned int shift(0); position<end and shift<64; shift+=7) {
+		const unsigned char byte(*position++);
+		value|=static_cast<unsigned int long>(byte&0x7f)<<shift;
+		if(!(byte&0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+//!Constructor
+BinarySpikeRecorder::BinarySpikeRecorder(const std::string& filename, SinkBackend backend)
+: sink(makeSink(filename, backend)), next_step(0), steps(0)
+{
+	buffer.reserve(buffer_size+buffer_size/8);
+}
+
+
+//!Destructor
+BinarySpikeRecorder::~BinarySpikeRecorder() {
+	if(sink) {
+		try {
+			close();
+		} catch(const std::exception&) {}	//A destructor called during the unwinding of an error must not throw
+	}
+}
+
+
+//!Method that writes the header of the file
+void BinarySpikeRecorder::open(const RunInfo& info) {
+
+	unsigned char header[SPIKE_FILE_HEADER_SIZE]={};
+	std::memcpy(header, magic, sizeof(magic));
+	putInteger(header+8, SPIKE_FILE_VERSION, 4);
+	putDouble(header+16, info.h);
+	putDouble(header+24, info.g);
+	putDouble(header+32, info.eta);
+	putInteger(header+40, info.simtime, 8);
+	putInteger(header+48, info.nbrNeurons, 8);
+	putInteger(header+56, info.nbrExcitatory, 8);
+
+	sink->write(reinterpret_cast<const char*>(header), sizeof(header));
+	next_step=0;
+	steps=info.simtime;
+}
+
+
+//!Method that encodes the spikes of a step in the buffer
+void BinarySpikeRecorder::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+
+	if(spikes.empty()) {	//The steps without spikes are not stored
+		return;
+	}
+
+	//The gaps between the neuron numbers need the spikes in increasing order
+	if(std::is_sorted(spikes.begin(), spikes.end())) {
+		appendStepBlock(buffer, step, next_step, spikes);
+	} else {
+		sorted=spikes;
+		std::sort(sorted.begin(), sorted.end());
+		appendStepBlock(buffer, step, next_step, sorted);
+	}
+	next_step=step+1;
+
+	if(buffer.size()>=buffer_size) {
+		flush();
+	}
+}
+
+
+//!Method that notes the number of steps done, written in the trailer instead of the simulation time
+void BinarySpikeRecorder::stopEarly(unsigned int long steps_) {
+	steps=steps_;
+}
+
+
+//!Method that writes the end of the buffer and the trailer, and closes the file
+void BinarySpikeRecorder::close() {
+	if(!sink) {
+		return;
+	}
+	appendInteger(buffer, steps, 8);
+	buffer.insert(buffer.end(), end_magic, end_magic+sizeof(end_magic));
+	flush();
+
+	//The sink is released first, so that a sink that fails is not closed again by the destructor
+	std::unique_ptr<OutputSink> closed_sink(std::move(sink));
+	closed_sink->close();
+}
+
+
+//!Method that writes the buffer in the file
+void BinarySpikeRecorder::flush() {
+	sink->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	buffer.clear();
+}
+
+
+
+//!Constructor
+SpikeFileReader::SpikeFileReader(const std::string& filename)
+: input_file(filename, std::ios::binary), remaining(0), position(0), next_step(0)
+{
+	if(!input_file) {
+		throw std::runtime_error("Cannot open "+filename);
+	}
+
+	unsigned char header[SPIKE_FILE_HEADER_SIZE];
+	input_file.read(reinterpret_cast<char*>(header), sizeof(header));
+	if(input_file.gcount()!=sizeof(header) or std::memcmp(header, magic, sizeof(magic))!=0) {
+		throw std::runtime_error(filename+" is not a binary spike file");
+	}
+	const unsigned int version(getInteger(header+8, 4));
+	if(version!=1 and version!=SPIKE_FILE_VERSION) {
+		throw std::runtime_error(filename+" has an unknown spike file version");
+	}
+
+	info.h=getDouble(header+16);
+	info.g=getDouble(header+24);
+	info.eta=getDouble(header+32);
+	info.simtime=getInteger(header+40, 8);
+	info.nbrNeurons=getInteger(header+48, 8);
+	info.nbrExcitatory=getInteger(header+56, 8);
+	info.first_step=0;
+
+	//The trailer gives the number of steps done, and ends the blocks
+	input_file.seekg(0, std::ios::end);
+	remaining=static_cast<unsigned int long>(input_file.tellg())-SPIKE_FILE_HEADER_SIZE;
+	if(version>=2 and remaining>=SPIKE_FILE_TRAILER_SIZE) {
+		unsigned char trailer[SPIKE_FILE_TRAILER_SIZE];
+		input_file.seekg(-static_cast<std::streamoff>(sizeof(trailer)), std::ios::end);
+		input_file.read(reinterpret_cast<char*>(trailer), sizeof(trailer));
+		if(input_file and std::memcmp(trailer+8, end_magic, sizeof(end_magic))==0) {
+			info.simtime=getInteger(trailer, 8);
+			remaining-=sizeof(trailer);
+		}
+	}
+	input_file.clear();
+	input_file.seekg(SPIKE_FILE_HEADER_SIZE);
+}
+
+
+//!Getter for the parameters of the run stored in the header
+const RunInfo& SpikeFileReader::getInfo() const {
+	return info;
+}
+
+
+//!Method that reads the next step with spikes
+bool SpikeFileReader::nextStep(unsigned int long& step, std::vector<unsigned int long>& spikes) {
+
+	spikes.clear();
+
+	unsigned int long gap;
+	if(!nextVarint(gap)) {
+		return false;	//End of the file
+	}
+
+	unsigned int long count;
+	if(!nextVarint(count)) {
+		throw std::runtime_error("Truncated binary spike file");
+	}
+
+	step=next_step+gap;
+	next_step=step+1;
+
+	unsigned int long neuron(0);
+	for(unsigned int long i(0); i<count; ++i) {
+		if(!nextVarint(gap)) {
+			throw std::runtime_error("Truncated binary spike file");
+		}
+		neuron=(i==0) ? gap : neuron+gap+1;
+		spikes.push_back(neuron);
+	}
+
+	return true;
+}
+
+
+//!Method that reads the next varint of the file
+bool SpikeFileReader::nextVarint(unsigned int long& value) {
+
+	//If the buffer may end in the middle of a varint, its end is moved to the front and completed from the file
+	if(buffer.size()-position<10 and remaining>0 and input_file) {
+		buffer.erase(buffer.begin(), buffer.begin()+position);
+		position=0;
+		const size_t kept(buffer.size());
+		const size_t size(std::min<unsigned int long>(buffer_size, remaining));
+		buffer.resize(kept+size);
+		input_file.read(reinterpret_cast<char*>(buffer.data()+kept), size);
+		buffer.resize(kept+input_file.gcount());
+		remaining=(input_file.gcount()==static_cast<std::streamsize>(size)) ? remaining-size : 0;
+	}
+
+	if(position==buffer.size()) {
+		return false;
+	}
+
+	const unsigned char* begin(buffer.data()+position);
+	const unsigned char* current(begin);
+	if(!readVarint(current, buffer.data()+buffer.size(), value)) {
+		throw std::runtime_error("Truncated binary spike file");
+	}
+	position+=current-begin;
+
+	return true;
+}
+
+
+
+//!Function that converts a binary spike file into the text format "time \t neuron number"
+void convertToText(const std::string& binary_filename, const std::string& text_filename) {
+
+	SpikeFileReader reader(binary_filename);
+	TextSpikeRecorder recorder(text_filename);
+
+	recorder.open(reader.getInfo());
+
+	unsigned int long step;
+	std::vector<unsigned int long> spikes;
+	while(reader.nextStep(step, spikes)) {
+		recorder.record(step, spikes);
+	}
+
+	recorder.close();
+}
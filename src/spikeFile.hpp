@@ -0,0 +1,184 @@
+//! Binary spike file
+/*!To write and read the spikes of a simulation in a compact binary format
+ *
+ * The file starts with a header of 64 bytes (little-endian) :
+ * - the magic string "BRUNSPK1" and the format version (uint32) followed by 4 unused bytes
+ * - h, g and eta (double)
+ * - the simulation time in steps, the number of neurons and the number of excitatory neurons (uint64)
+ *
+ * Then each step with at least one spike is stored as a block of varints :
+ * - the number of steps without spikes since the previous block
+ * - the number of spikes of the step
+ * - the number of the first neuron that spiked, then the gaps between two consecutive neuron numbers minus one
+ *
+ * Since the version 2, the file ends with a trailer of 16 bytes : the number of steps done (uint64, smaller than the
+ * simulation time of the header if the run stopped early) and the magic string "BRUNEND1". A file without trailer
+ * (version 1, or a run that did not end) is read until its end with the simulation time of the header.
+ */
+#ifndef SPIKEFILE_H
+#define SPIKEFILE_H
+#include "recorder.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+constexpr unsigned int SPIKE_FILE_VERSION = 2;	//!Version of the binary spike format
+constexpr unsigned int SPIKE_FILE_TRAILER_SIZE = 16;	//!Size of the trailer of a binary spike file in bytes
+constexpr unsigned int SPIKE_FILE_HEADER_SIZE = 64;	//!Size of the header of a binary spike file in bytes
+
+
+//!Function that appends a value to a buffer as a varint (7 bits per byte, the high bit tells if a byte follows)
+/*!
+ *\param buffer the buffer where to write the value
+ *\param value the value to write
+*/
+inline void appendVarint(std::vector<unsigned char>& buffer, unsigned int long value) {
+	while(value>=0x80) {
+		buffer.push_back(static_cast<unsigned char>(value|0x80));
+		value>>=7;
+	}
+	buffer.push_back(static_cast<unsigned char>(value));
+}
+
+
+//!Function that appends the block of a step to a buffer
+/*!
+ *\param buffer the buffer where to write the block
+ *\param step the step of the spikes
+ *\param next_step the step following the previous block (0 for the first block)
+ *\param spikes the numbers of the neurons that spiked during the step, in increasing order
+*/
+void appendStepBlock(std::vector<unsigned char>& buffer, unsigned int long step, unsigned int long next_step, const std::vector<unsigned int long>& spikes);
+
+
+//!Function that reads a varint from a buffer
+/*!
+ *\param position the current position in the buffer, moved after the varint
+ *\param end the end of the buffer
+ *\param value the value read
+ *\return false if the buffer ends before the end of the varint, else true
+*/
+bool readVarint(const unsigned char*& position, const unsigned char* end, unsigned int long& value);
+
+
+
+//! Recorder of the spikes in the binary format
+class BinarySpikeRecorder : public Recorder {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param filename the name of the file where to write the spikes
+	 *\param backend the system interface used to write the file
+	*/
+	BinarySpikeRecorder(const std::string& filename, SinkBackend backend=SinkBackend::Stream);
+
+
+	//!Destructor
+	virtual ~BinarySpikeRecorder();
+
+
+	//!Method that writes the header of the file
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info) override;
+
+
+	//!Method that encodes the spikes of a step in the buffer
+	/*!
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Method that notes the number of steps done, written in the trailer instead of the simulation time
+	/*!
+	 *\param steps the number of steps done
+	*/
+	virtual void stopEarly(unsigned int long steps) override;
+
+
+	//!Method that writes the end of the buffer and the trailer, and closes the file
+	virtual void close() override;
+
+
+
+	private :
+
+	//!Method that writes the buffer in the file
+	void flush();
+
+
+	std::unique_ptr<OutputSink> sink;	//!File where to write the spikes
+	std::vector<unsigned char> buffer;	//!Encoded blocks not written yet
+	std::vector<unsigned int long> sorted;	//!Copy of the spikes of a step when they are not given in order
+	unsigned int long next_step;	//!Step following the last written block
+	unsigned int long steps;	//!Number of steps done, written in the trailer
+
+};
+
+
+
+//! Reader of the binary spike files
+class SpikeFileReader {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * opens the file and reads its header, and its trailer if it has one (the simulation time is then the number of steps done)
+	 *\param filename the name of the binary spike file
+	*/
+	SpikeFileReader(const std::string& filename);
+
+
+	//!Getter for the parameters of the run stored in the header
+	/*!
+	 *\return the parameters of the run
+	*/
+	const RunInfo& getInfo() const;
+
+
+	//!Method that reads the next step with spikes
+	/*!
+	 *\param step the step of the spikes
+	 *\param spikes the numbers of the neurons that spiked during this step
+	 *\return false if the end of the file is reached, else true
+	*/
+	bool nextStep(unsigned int long& step, std::vector<unsigned int long>& spikes);
+
+
+
+	private :
+
+	//!Method that reads the next varint of the file
+	/*!
+	 *\param value the value read
+	 *\return false if the end of the file is reached before the varint, else true
+	*/
+	bool nextVarint(unsigned int long& value);
+
+
+	std::ifstream input_file;	//!Binary spike file
+	unsigned int long remaining;	//!Number of bytes of blocks not read yet from the file
+	RunInfo info;	//!Parameters of the run
+	std::vector<unsigned char> buffer;	//!Bytes read from the file and not decoded yet
+	size_t position;	//!Position of the next byte to decode in buffer
+	unsigned int long next_step;	//!Step following the last read block
+
+};
+
+
+//!Function that converts a binary spike file into the text format "time \t neuron number"
+/*!
+ *\param binary_filename the name of the binary spike file
+ *\param text_filename the name of the text file to create
+*/
+void convertToText(const std::string& binary_filename, const std::string& text_filename);
+
+#endif
@@ -0,0 +1,44 @@
+#include "spikeArchive.hpp"
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+
+int main (int argc, char** argv) {
+
+	if(argc!=6) {
+		std::cerr<<"Usage : "<<argv[0]<<" archive start_ms stop_ms first_neuron last_neuron"<<std::endl;
+		std::cerr<<"Writes the spikes of the neurons first_neuron to last_neuron (numbered from 1) between start_ms and stop_ms"<<std::endl;
+		std::cerr<<"in the format of spikes.txt"<<std::endl;
+		return 1;
+	}
+
+	try {
+		SpikeArchive archive(argv[1]);
+
+		const double h(archive.getInfo().h);
+		const unsigned int long start_step(std::lround(std::stod(argv[2])/h));
+		const unsigned int long stop_step(std::lround(std::stod(argv[3])/h));
+		const unsigned int long first_neuron(std::stoul(argv[4]));
+		const unsigned int long last_neuron(std::stoul(argv[5]));
+		if(first_neuron==0 or last_neuron<first_neuron) {
+			throw std::invalid_argument("The neurons are numbered from 1 and first_neuron must not be larger than last_neuron");
+		}
+
+		const std::vector<Spike> spikes(archive.query(start_step, stop_step, first_neuron-1, last_neuron-1));
+		for(const auto& spike : spikes) {
+			std::cout<<spike.step<<'\t'<<spike.neuron+1<<'\n';
+		}
+
+		std::cerr<<spikes.size()<<" spikes read from "<<archive.getChunksRead()<<" of "<<archive.getIndex().size()<<" chunks"<<std::endl;
+
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	return 0;
+}
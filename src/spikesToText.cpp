@@ -0,0 +1,31 @@
+#include "spikeFile.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+
+
+int main (int argc, char** argv) {
+
+	//Default names of the files written by Neurons
+	std::string binary_filename("spikes.bin");
+	std::string text_filename("spikes.txt");
+
+	if(argc>1) {
+		binary_filename=argv[1];
+	}
+	if(argc>2) {
+		text_filename=argv[2];
+	}
+
+	try {
+		convertToText(binary_filename, text_filename);
+	} catch(const std::exception& error) {
+		std::cerr<<error.what()<<std::endl;
+		return 1;
+	}
+
+	std::cout<<"Conversion : done"<<std::endl;
+
+	return 0;
+}
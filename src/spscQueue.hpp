@@ -0,0 +1,101 @@
+//! SpscQueue class
+/*!Lock-free ring buffer between one producer thread and one consumer thread
+ */
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+#include <atomic>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+
+
+template<typename T>
+class SpscQueue {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param capacity the number of items of the ring buffer (must be a power of 2)
+	*/
+	SpscQueue(size_t capacity) : items(capacity), mask(capacity-1), head(0), tail(0) {
+		assert(capacity>0 and (capacity&(capacity-1))==0);	//Verifies that capacity is a power of 2
+	}
+
+
+	//!Getter for the capacity of the ring buffer
+	/*!
+	 *\return the number of items that the ring buffer can contain
+	*/
+	size_t getCapacity() const {
+		return items.size();
+	}
+
+
+	//!Method used by the producer to know the free space in the ring buffer
+	/*!
+	 *\return the number of items that can be pushed without waiting
+	*/
+	size_t freeSpace() const {
+		return items.size()-(tail.load(std::memory_order_relaxed)-head.load(std::memory_order_acquire));
+	}
+
+
+	//!Method used by the producer to add items at the end of the ring buffer
+	/*!
+	 *\param values the items to add
+	 *\param number the number of items to add
+	 *\return the number of items added (smaller than number if the ring buffer is full)
+	*/
+	size_t push(const T* values, size_t number) {
+
+		const size_t end(tail.load(std::memory_order_relaxed));
+		const size_t free_space(items.size()-(end-head.load(std::memory_order_acquire)));
+		if(number>free_space) {
+			number=free_space;
+		}
+
+		for(size_t i(0); i<number; ++i) {
+			items[(end+i)&mask]=values[i];
+		}
+
+		tail.store(end+number, std::memory_order_release);	//The items are visible to the consumer after this store
+		return number;
+	}
+
+
+	//!Method used by the consumer to remove items from the front of the ring buffer
+	/*!
+	 *\param values where to copy the removed items
+	 *\param number the maximal number of items to remove
+	 *\return the number of items removed (0 if the ring buffer is empty)
+	*/
+	size_t pop(T* values, size_t number) {
+
+		const size_t begin(head.load(std::memory_order_relaxed));
+		const size_t available(tail.load(std::memory_order_acquire)-begin);
+		if(number>available) {
+			number=available;
+		}
+
+		for(size_t i(0); i<number; ++i) {
+			values[i]=items[(begin+i)&mask];
+		}
+
+		head.store(begin+number, std::memory_order_release);	//The space is given back to the producer after this store
+		return number;
+	}
+
+
+
+	private :
+
+	std::vector<T> items;	//!Items of the ring buffer
+	const size_t mask;	//!capacity-1, to compute the position of an index in items
+	alignas(64) std::atomic<size_t> head;	//!Number of items removed since the construction (written by the consumer)
+	alignas(64) std::atomic<size_t> tail;	//!Number of items added since the construction (written by the producer)
+
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "statisticsRecorder.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+const double synchrony_threshold(0.1);	//Synchrony index above which the network is synchronous
+const double cv_threshold(0.5);	//Coefficient of variation above which the firing is irregular
+
+}
+
+
+//!Constructor
+StatisticsRecorder::StatisticsRecorder(double bin_width_, double start_, bool report_)
+: bin_width(bin_width_), start(start_), report(report_), bin_steps(1), start_step(0), bin_end(0),
+  bin_spikes(0), bins(0), bin_mean(0.0), bin_m2(0.0)
+{}
+
+
+//!Method that allocates the accumulators of the neurons
+void StatisticsRecorder::open(const RunInfo& info_) {
+
+	info=info_;
+	bin_steps=std::max(1l, std::lround(bin_width/info.h));
+	start_step=std::max<unsigned int long>(std::lround(start/info.h), info.first_step);	//A continued run has no steps before its first one
+	bin_end=start_step+bin_steps;
+
+	neurons.assign(info.nbrNeurons, NeuronAccumulator {0, 0, 0.0, 0.0, 0, 0, 0});
+	active.clear();
+	bin_spikes=0;
+	bins=0;
+	bin_mean=0.0;
+	bin_m2=0.0;
+}
+
+
+//!Method that adds the spikes of a step to the accumulators
+void StatisticsRecorder::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+
+	if(step<start_step) {
+		return;
+	}
+
+	//The bins ended before this step are added, even without spikes
+	while(step>=bin_end) {
+		endBin();
+	}
+
+	for(auto neuron : spikes) {
+		NeuronAccumulator& accumulator(neurons[neuron]);
+
+		//Welford's update of the mean and of the variance of the interspike intervals
+		if(accumulator.last_step>0) {
+			const double interval((step+1-accumulator.last_step)*info.h);
+			++accumulator.intervals;
+			const double delta(interval-accumulator.mean);
+			accumulator.mean+=delta/accumulator.intervals;
+			accumulator.m2+=delta*(interval-accumulator.mean);
+		}
+		accumulator.last_step=step+1;
+
+		if(accumulator.bin_spikes==0) {
+			active.push_back(neuron);
+		}
+		++accumulator.bin_spikes;
+	}
+	bin_spikes+=spikes.size();
+}
+
+
+//!Method that makes the last bin end at the last step done, so that no empty bin is added
+void StatisticsRecorder::stopEarly(unsigned int long steps) {
+	info.simtime=steps;
+}
+
+
+//!Method that ends the bins until the end of the run and displays the statistics
+void StatisticsRecorder::close() {
+
+	//Only the complete bins are taken into account
+	while(bin_end<=info.simtime) {
+		endBin();
+	}
+
+	if(report) {
+		const NetworkStatistics statistics(getStatistics());
+		std::cout<<"Statistics : rate "<<statistics.rate<<" Hz, CV of the interspike intervals "<<statistics.cv
+				 <<" ("<<statistics.regular_neurons<<" neurons), Fano factor "<<statistics.fano_factor
+				 <<", synchrony "<<statistics.synchrony<<" ("<<statistics.bins<<" bins), regime "<<statistics.regime<<std::endl;
+	}
+}
+
+
+//!Method that computes the statistics of the spikes recorded until now
+NetworkStatistics StatisticsRecorder::getStatistics() const {
+
+	NetworkStatistics statistics {0.0, 0.0, 0, 0.0, 0.0, bins, ""};
+
+	double neuron_variances(0.0);	//Sum of the variances of the number of spikes of each neuron per bin
+	for(const auto& accumulator : neurons) {
+		if(accumulator.intervals>=2 and accumulator.mean>0.0) {
+			statistics.cv+=std::sqrt(accumulator.m2/accumulator.intervals)/accumulator.mean;
+			++statistics.regular_neurons;
+		}
+		if(bins>0) {
+			const double mean(double(accumulator.sum_spikes)/bins);
+			neuron_variances+=double(accumulator.sum_squares)/bins-mean*mean;
+		}
+	}
+	if(statistics.regular_neurons>0) {
+		statistics.cv/=statistics.regular_neurons;
+	}
+
+	if(bins>0 and !neurons.empty()) {
+		const double variance(bin_m2/bins);
+		statistics.rate=bin_mean/(neurons.size()*bin_steps*info.h/1000.0);
+		statistics.fano_factor=(bin_mean>0.0) ? variance/bin_mean : 0.0;
+
+		//chi^2 = Var(network spikes / N) / (sum of the variances of the neurons / N)
+		statistics.synchrony=(neuron_variances>0.0) ? std::sqrt(std::min(1.0, variance/(neurons.size()*neuron_variances))) : 0.0;
+	}
+
+	statistics.regime=std::string(statistics.synchrony>synchrony_threshold ? "S" : "A")+(statistics.cv>cv_threshold ? "I" : "R");
+
+	return statistics;
+}
+
+
+//!Method that adds the counts of the current bin to the accumulators and starts the next bin
+void StatisticsRecorder::endBin() {
+
+	//Only the neurons that spiked have a count different from 0
+	for(auto neuron : active) {
+		NeuronAccumulator& accumulator(neurons[neuron]);
+		accumulator.sum_spikes+=accumulator.bin_spikes;
+		accumulator.sum_squares+=std::uint64_t(accumulator.bin_spikes)*accumulator.bin_spikes;
+		accumulator.bin_spikes=0;
+	}
+	active.clear();
+
+	++bins;
+	const double delta(bin_spikes-bin_mean);
+	bin_mean+=delta/bins;
+	bin_m2+=delta*(bin_spikes-bin_mean);
+
+	bin_spikes=0;
+	bin_end+=bin_steps;
+}
@@ -0,0 +1,117 @@
+//! StatisticsRecorder class
+/*!To compute during the simulation the statistics that distinguish the regimes of the network (Fig.8),
+ * without writing the spikes
+ *
+ * - the coefficient of variation of the interspike intervals of each neuron (irregularity)
+ * - the Fano factor of the number of spikes of the whole network per bin
+ * - the synchrony index chi : the variance of the mean activity per bin divided by the mean variance of the activity
+ *   of a neuron per bin, square rooted (close to 1/sqrt(N) for an asynchronous network, to 1 for a synchronous one)
+ */
+#ifndef STATISTICSRECORDER_H
+#define STATISTICSRECORDER_H
+#include "recorder.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+//!Statistics of a run
+struct NetworkStatistics {
+
+	double rate;	//!Mean rate of a neuron in Hz
+	double cv;	//!Mean coefficient of variation of the interspike intervals
+	unsigned int long regular_neurons;	//!Number of neurons with at least 2 interspike intervals (those used for cv)
+	double fano_factor;	//!Fano factor of the number of spikes of the network per bin
+	double synchrony;	//!Synchrony index chi
+	unsigned int long bins;	//!Number of complete bins
+	std::string regime;	//!"SR", "SI", "AR" or "AI" : synchronous if synchrony > 0.1, irregular if cv > 0.5
+
+};
+
+
+
+class StatisticsRecorder : public Recorder {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param bin_width_ the width of the bins of the Fano factor and of the synchrony index in ms
+	 *\param start_ the time in ms from which the spikes are taken into account, to skip the transient
+	 *\param report_ true if the statistics are displayed at the end of the run
+	*/
+	StatisticsRecorder(double bin_width_=1.0, double start_=0.0, bool report_=true);
+
+
+	//!Method that allocates the accumulators of the neurons
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info) override;
+
+
+	//!Method that adds the spikes of a step to the accumulators
+	/*!
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Method that makes the last bin end at the last step done, so that no empty bin is added
+	/*!
+	 *\param steps the number of steps done
+	*/
+	virtual void stopEarly(unsigned int long steps) override;
+
+
+	//!Method that ends the bins until the end of the run and displays the statistics
+	virtual void close() override;
+
+
+	//!Method that computes the statistics of the spikes recorded until now
+	/*!
+	 *\return the statistics over the complete bins and the recorded interspike intervals
+	*/
+	NetworkStatistics getStatistics() const;
+
+
+
+	private :
+
+	//!Accumulators of a neuron
+	struct NeuronAccumulator {
+
+		unsigned int long last_step;	//!Step of the last spike plus one (0 before the first spike)
+		unsigned int long intervals;	//!Number of interspike intervals
+		double mean;	//!Mean of the interspike intervals in ms
+		double m2;	//!Sum of the squared differences to the mean (Welford)
+		std::uint32_t bin_spikes;	//!Number of spikes in the current bin
+		std::uint32_t sum_spikes;	//!Number of spikes in the complete bins
+		std::uint64_t sum_squares;	//!Sum over the complete bins of the squared number of spikes
+
+	};
+
+
+	//!Method that adds the counts of the current bin to the accumulators and starts the next bin
+	void endBin();
+
+
+	double bin_width;	//!Width of the bins in ms
+	double start;	//!Time in ms from which the spikes are taken into account
+	bool report;	//!True if the statistics are displayed at the end of the run
+	RunInfo info;	//!Parameters of the run
+	unsigned int long bin_steps;	//!Number of steps per bin
+	unsigned int long start_step;	//!First step taken into account
+	unsigned int long bin_end;	//!Step following the current bin
+	std::vector<NeuronAccumulator> neurons;	//!Accumulators of each neuron
+	std::vector<unsigned int long> active;	//!Neurons that spiked during the current bin
+	unsigned int long bin_spikes;	//!Number of spikes of the network in the current bin
+	unsigned int long bins;	//!Number of complete bins
+	double bin_mean;	//!Mean number of spikes of the network per bin
+	double bin_m2;	//!Sum of the squared differences to bin_mean (Welford)
+
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "stopMonitor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+//Function that gives the relative change between two values (0 if both are 0)
+double relativeChange(double value, double previous) {
+	const double scale(std::max(std::fabs(value), std::fabs(previous)));
+	return (scale>0.0) ? std::fabs(value-previous)/scale : 0.0;
+}
+
+}
+
+
+//!Function that gives the name of a stop reason
+std::string stopReasonName(StopReason reason) {
+	switch(reason) {
+		case StopReason::Quiescence :
+			return "quiescence";
+		case StopReason::Saturation :
+			return "saturation";
+		case StopReason::Convergence :
+			return "convergence";
+		default :
+			return "none";
+	}
+}
+
+
+//!Function that gives the default stop conditions
+StopConditions defaultStopConditions() {
+	return StopConditions {10.0, 0.0, 0.1, 50.0, 0.5, 50.0, 0.01, 10};
+}
+
+
+//!Constructor
+StopMonitor::StopMonitor(const StopConditions& conditions_)
+: conditions(conditions_), window_steps(1), min_step(0), quiescence_windows(1), saturation_windows(1), window_end(0),
+  window_spikes(0), window_rate(0.0), quiescent(0), saturated(0), stable(0), steps(0), step_mean(0.0), step_m2(0.0),
+  previous_mean(0.0), previous_fluctuation(0.0), reason(StopReason::None), stop_step(0)
+{
+	if(!(conditions.window>0.0)) {
+		throw std::invalid_argument("The width of the windows of the stop conditions must be strictly positive");
+	}
+}
+
+
+//!Method that computes the number of steps of the windows and of the conditions
+void StopMonitor::open(const RunInfo& info_) {
+
+	info=info_;
+	window_steps=std::max(1l, std::lround(conditions.window/info.h));
+	min_step=std::lround(std::max(0.0, conditions.min_time)/info.h);
+	min_step=std::max(min_step, info.first_step);	//The windows of a continued run start at its first step, not at 0
+	const double window_time(window_steps*info.h);
+	quiescence_windows=std::max(1.0, std::ceil(conditions.quiescence_time/window_time-1e-9));
+	saturation_windows=std::max(1.0, std::ceil(conditions.saturation_time/window_time-1e-9));
+
+	window_end=min_step+window_steps;
+	window_spikes=0;
+	window_rate=0.0;
+	quiescent=0;
+	saturated=0;
+	stable=0;
+	steps=0;
+	step_mean=0.0;
+	step_m2=0.0;
+	previous_mean=0.0;
+	previous_fluctuation=0.0;
+	reason=StopReason::None;
+	stop_step=0;
+}
+
+
+//!Method that counts the spikes of a step and evaluates the conditions at the end of each window
+void StopMonitor::record(unsigned int long step, const std::vector<unsigned int long>& spikes) {
+
+	if(step<min_step or reason!=StopReason::None) {
+		return;
+	}
+
+	while(step>=window_end and reason==StopReason::None) {
+		endWindow();
+	}
+	if(reason!=StopReason::None) {
+		return;
+	}
+
+	window_spikes+=spikes.size();
+
+	//Welford's update of the mean and of the variance of the number of spikes per step
+	++steps;
+	const double delta(spikes.size()-step_mean);
+	step_mean+=delta/steps;
+	step_m2+=delta*(spikes.size()-step_mean);
+
+	//The window is evaluated with its last step, so that the simulation can stop at once
+	if(step+1==window_end) {
+		endWindow();
+	}
+}
+
+
+//!Getter for the reason why the simulation should stop
+StopReason StopMonitor::getReason() const {
+	return reason;
+}
+
+
+//!Getter for the step at which a condition was met
+unsigned int long StopMonitor::getStopStep() const {
+	return stop_step;
+}
+
+
+//!Getter for the rate of the last complete window
+double StopMonitor::getWindowRate() const {
+	return window_rate;
+}
+
+
+//!Method that evaluates the conditions at the end of a window and starts the next one
+void StopMonitor::endWindow() {
+
+	window_rate=(info.nbrNeurons>0) ? window_spikes/(info.nbrNeurons*window_steps*info.h/1000.0) : 0.0;
+
+	const bool is_quiescent(conditions.quiescence_rate>0.0 and window_rate<conditions.quiescence_rate);
+	quiescent=is_quiescent ? quiescent+1 : 0;
+
+	//The rate of a neuron that fires as soon as it leaves its refractory period is 1/Tref
+	const bool is_saturated(conditions.saturation_fraction>0.0 and window_rate>=conditions.saturation_fraction*1000.0/Tref);
+	saturated=is_saturated ? saturated+1 : 0;
+
+	//The statistics since the start of the monitoring are compared to those at the end of the previous window
+	if(conditions.tolerance>0.0 and step_mean>0.0) {
+		const double fluctuation(std::sqrt(step_m2/steps)/step_mean);
+		const bool converged(previous_mean>0.0 and relativeChange(step_mean, previous_mean)<=conditions.tolerance
+							 and relativeChange(fluctuation, previous_fluctuation)<=conditions.tolerance);
+		stable=converged ? stable+1 : 0;
+		previous_mean=step_mean;
+		previous_fluctuation=fluctuation;
+	} else {
+		stable=0;
+	}
+
+	if(quiescent>=quiescence_windows) {
+		reason=StopReason::Quiescence;
+	} else if(saturated>=saturation_windows) {
+		reason=StopReason::Saturation;
+	} else if(conditions.convergence_windows>0 and stable>=conditions.convergence_windows) {
+		reason=StopReason::Convergence;
+	}
+	if(reason!=StopReason::None) {
+		stop_step=window_end;
+	}
+
+	window_end+=window_steps;
+	window_spikes=0;
+}
@@ -0,0 +1,137 @@
+//! StopMonitor class
+/*!To stop a simulation before its simulation time when the rest of the run would not teach anything more
+ *
+ * The population rate is measured over windows of a few ms, from the spikes of each step :
+ * - quiescence : the rate stays below a small value (the network died out)
+ * - saturation : the rate stays close to the refractory limit 1/Tref (every neuron fires as soon as it can)
+ * - convergence : the mean rate and the relative fluctuations of the number of spikes per step, computed since
+ *   the start of the monitoring, change by less than a tolerance from one window to the next during several windows
+ */
+#ifndef STOPMONITOR_H
+#define STOPMONITOR_H
+#include "recorder.hpp"
+#include <string>
+#include <vector>
+
+
+
+//!Reason why a simulation stopped
+enum class StopReason {
+	None,	//!The simulation ran until its simulation time
+	Quiescence,	//!The network stopped firing
+	Saturation,	//!The network fired at the refractory limit
+	Convergence	//!The statistics of the network converged
+};
+
+
+//!Function that gives the name of a stop reason
+/*!
+ *\param reason the reason
+ *\return "none", "quiescence", "saturation" or "convergence"
+*/
+std::string stopReasonName(StopReason reason);
+
+
+//!Parameters of the stop conditions
+struct StopConditions {
+
+	double window;	//!Width of the windows over which the rate is measured in ms
+	double min_time;	//!Time in ms before which the conditions are not evaluated (for instance the transient)
+	double quiescence_rate;	//!Rate in Hz below which the network is quiescent (0 to disable the condition)
+	double quiescence_time;	//!Time in ms during which the network must stay quiescent
+	double saturation_fraction;	//!Fraction of 1/Tref above which the network is saturated (0 to disable the condition)
+	double saturation_time;	//!Time in ms during which the network must stay saturated
+	double tolerance;	//!Relative change of the statistics below which they converged (0 to disable the condition)
+	unsigned int convergence_windows;	//!Number of consecutive windows in which the statistics must stay within the tolerance
+
+};
+
+
+//!Function that gives the default stop conditions
+/*!
+ *\return windows of 10 ms, quiescence below 0.1 Hz and saturation above 0.5/Tref during 50 ms,
+ * convergence within 1% during 10 windows
+*/
+StopConditions defaultStopConditions();
+
+
+
+class StopMonitor : public Recorder {
+
+	public :
+
+	//!Constructor
+	/*!
+	 * throws std::invalid_argument if the width of the windows is not strictly positive
+	 *\param conditions_ the stop conditions
+	*/
+	StopMonitor(const StopConditions& conditions_=defaultStopConditions());
+
+
+	//!Method that computes the number of steps of the windows and of the conditions
+	/*!
+	 *\param info the parameters of the run
+	*/
+	virtual void open(const RunInfo& info) override;
+
+
+	//!Method that counts the spikes of a step and evaluates the conditions at the end of each window
+	/*!
+	 * the monitor must receive every step of the simulation, with or without spikes
+	 *\param step the step of the simulation during which the spikes occured
+	 *\param spikes the numbers of the neurons that spiked during this step
+	*/
+	virtual void record(unsigned int long step, const std::vector<unsigned int long>& spikes) override;
+
+
+	//!Getter for the reason why the simulation should stop
+	/*!
+	 *\return StopReason::None while no condition is met, then the first condition met
+	*/
+	StopReason getReason() const;
+
+
+	//!Getter for the step at which a condition was met
+	/*!
+	 *\return the step following the window in which the condition was met (0 while no condition is met)
+	*/
+	unsigned int long getStopStep() const;
+
+
+	//!Getter for the rate of the last complete window
+	/*!
+	 *\return the mean rate of a neuron in Hz
+	*/
+	double getWindowRate() const;
+
+
+
+	private :
+
+	//!Method that evaluates the conditions at the end of a window and starts the next one
+	void endWindow();
+
+
+	StopConditions conditions;	//!Stop conditions
+	RunInfo info;	//!Parameters of the run
+	unsigned int long window_steps;	//!Number of steps per window
+	unsigned int long min_step;	//!First step from which the conditions are evaluated
+	unsigned int long quiescence_windows;	//!Number of windows during which the network must stay quiescent
+	unsigned int long saturation_windows;	//!Number of windows during which the network must stay saturated
+	unsigned int long window_end;	//!Step following the current window
+	unsigned int long window_spikes;	//!Number of spikes in the current window
+	double window_rate;	//!Rate of the last complete window in Hz
+	unsigned int long quiescent;	//!Number of consecutive quiescent windows
+	unsigned int long saturated;	//!Number of consecutive saturated windows
+	unsigned int long stable;	//!Number of consecutive windows with converged statistics
+	unsigned int long steps;	//!Number of monitored steps
+	double step_mean;	//!Mean number of spikes per step since min_step
+	double step_m2;	//!Sum of the squared differences to step_mean (Welford)
+	double previous_mean;	//!Mean number of spikes per step at the end of the previous window
+	double previous_fluctuation;	//!Relative fluctuation of the number of spikes per step at the end of the previous window
+	StopReason reason;	//!First condition met
+	unsigned int long stop_step;	//!Step following the window in which the condition was met
+
+};
+
+#endif
@@ -0,0 +1,250 @@
+#include "sweep.hpp"
+#include "ensemble.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <sys/mman.h>
+
+
+namespace {
+
+const std::string point_prefix("point_");	//Prefix of the names of the trials of the points
+
+
+//Statistics of a point written by its process (no pointer, so that it can be shared between processes)
+struct SharedStatistics {
+
+	double rate;	//Mean rate of a neuron in Hz
+	double cv;	//Mean coefficient of variation of the interspike intervals
+	unsigned int long regular_neurons;	//Number of neurons used for cv
+	double fano_factor;	//Fano factor of the number of spikes of the network per bin
+	double synchrony;	//Synchrony index chi
+	unsigned int long bins;	//Number of complete bins
+	char regime[4];	//Regime of the network
+	double stop_time;	//Time in ms at which the point stopped
+	StopReason stop_reason;	//Reason why the point stopped before its simulation time
+
+};
+
+
+//Memory shared by the processes of the points, unmapped when it is destroyed
+class SharedMemory {
+
+	public :
+
+	//Constructor
+	explicit SharedMemory(size_t count)
+	: size(count*sizeof(SharedStatistics)), data(mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0))
+	{
+		if(data==MAP_FAILED) {
+			throw std::system_error(errno, std::generic_category(), "Cannot allocate the memory shared by the points");
+		}
+	}
+
+	SharedMemory(const SharedMemory&)=delete;
+	SharedMemory& operator=(const SharedMemory&)=delete;
+
+	//Destructor
+	~SharedMemory() {
+		munmap(data, size);
+	}
+
+	//Getter for the statistics of a point
+	SharedStatistics& operator[](size_t index) {
+		return static_cast<SharedStatistics*>(data)[index];
+	}
+
+
+	private :
+
+	size_t size;	//Size of the memory in bytes
+	void* data;	//Start of the memory
+
+};
+
+
+//Function that gives the stationary rate of the mean field to compare with the simulation of a point
+MeanFieldSolution predict(const SweepPoint& point, const NetworkSize& size) {
+	const std::vector<MeanFieldSolution> solutions(MeanField(point.g, point.eta, size.connections_excitatory,
+																size.connections_inhibitory).solve());
+	for(const auto& solution : solutions) {
+		if(solution.stability==MeanFieldStability::Stable) {
+			return solution;
+		}
+	}
+	return solutions.front();
+}
+
+}
+
+
+//!Constructor
+Sweep::Sweep(unsigned int seed_, unsigned int long nbr_excitatory_, unsigned int long nbr_inhibitory_, unsigned int processes_,
+			 double transient_, double bin_width_)
+: seed(seed_),
+  size(NetworkSize {nbr_excitatory_, nbr_inhibitory_, static_cast<unsigned int long>(CE), static_cast<unsigned int long>(CI)}),
+  processes(processes_), transient(transient_),
+  bin_width(bin_width_), early_stop(false), stop_conditions(defaultStopConditions())
+{
+	if(!(transient>=0.0) or !(bin_width>0.0)) {
+		throw std::invalid_argument("The transient must be positive and the width of the bins strictly positive");
+	}
+}
+
+
+//!Method that adds a point to the sweep
+void Sweep::addPoint(const SweepPoint& point) {
+
+	if(!(point.g>0.0) or !(point.eta>0.0) or !(point.time>0.0)) {
+		throw std::invalid_argument("The points of a sweep need g, eta and a simulation time strictly positive");
+	}
+	points.push_back(point);
+}
+
+
+//!Setter for the size of the network
+void Sweep::setNetworkSize(const NetworkSize& size_) {
+	checkNetworkSize(size_);
+	size=size_;
+}
+
+
+//!Getter for the size of the network
+const NetworkSize& Sweep::getNetworkSize() const {
+	return size;
+}
+
+
+//!Method that adds a grid of points to the sweep
+void Sweep::addGrid(double g_min, double g_max, unsigned int g_points, double eta_min, double eta_max, unsigned int eta_points,
+					double time, unsigned int noise_seed) {
+
+	if(g_points==0 or eta_points==0) {
+		throw std::invalid_argument("A grid needs at least one value of g and one value of eta");
+	}
+
+	for(unsigned int j(0); j<eta_points; ++j) {
+		const double eta(eta_points>1 ? eta_min+(eta_max-eta_min)*j/(eta_points-1) : eta_min);
+		for(unsigned int i(0); i<g_points; ++i) {
+			const double g(g_points>1 ? g_min+(g_max-g_min)*i/(g_points-1) : g_min);
+			addPoint(SweepPoint {g, eta, time, noise_seed});
+		}
+	}
+}
+
+
+//!Method that makes the points stop before their simulation time when a stop condition is met
+void Sweep::setStopConditions(const StopConditions& conditions) {
+	StopMonitor check(conditions);	//Throws if the conditions are not valid, before the processes are created
+	stop_conditions=conditions;
+	early_stop=true;
+}
+
+
+//!Getter for the points of the sweep
+const std::vector<SweepPoint>& Sweep::getPoints() const {
+	return points;
+}
+
+
+//!Method that computes the statistics of all the points
+std::vector<SweepResult> Sweep::run() {
+
+	std::vector<SweepResult> results;
+	if(points.empty()) {
+		return results;
+	}
+
+	SharedMemory shared(points.size());
+	Ensemble ensemble(points.front().time, seed, size.nbr_excitatory, size.nbr_inhibitory, processes);
+	ensemble.setNetworkSize(size);
+	for(size_t i(0); i<points.size(); ++i) {
+		ensemble.addTrial(Trial {points[i].g, points[i].eta, points[i].noise_seed, point_prefix+std::to_string(i), points[i].time});
+	}
+
+	const std::vector<int> statuses(ensemble.run([this, &shared](const Trial& trial, Simulation& simulation, Network& network) {
+
+		StatisticsRecorder statistics_recorder(bin_width, transient, false);
+		simulation.addRecorder(&statistics_recorder);
+		if(early_stop) {
+			simulation.setStopConditions(stop_conditions);
+		}
+		simulation.run(network);
+
+		//The statistics are written in the slot of the point, read by the parent process
+		const NetworkStatistics statistics(statistics_recorder.getStatistics());
+		SharedStatistics& slot(shared[std::stoul(trial.name.substr(point_prefix.size()))]);
+		slot=SharedStatistics {statistics.rate, statistics.cv, statistics.regular_neurons, statistics.fano_factor,
+							   statistics.synchrony, statistics.bins, {0, 0, 0, 0}, simulation.getClock()*h,
+							   simulation.getStopReason()};
+		std::strncpy(slot.regime, statistics.regime.c_str(), sizeof(slot.regime)-1);
+	}));
+
+	for(size_t i(0); i<points.size(); ++i) {
+		const SharedStatistics& slot(shared[i]);
+		results.push_back(SweepResult {points[i], statuses[i], NetworkStatistics {slot.rate, slot.cv, slot.regular_neurons,
+																				  slot.fano_factor, slot.synchrony, slot.bins,
+																				  std::string(slot.regime)},
+											slot.stop_time, slot.stop_reason});
+	}
+
+	return results;
+}
+
+
+//!Method that writes the summary table of a sweep
+void Sweep::writeTable(const std::string& filename, const std::vector<SweepResult>& results, const NetworkSize& size) {
+
+	std::ofstream table(filename);
+	if(table.fail()) {
+		throw std::runtime_error("Cannot create the file "+filename);
+	}
+
+	table<<"g,eta,time,noise_seed,rate,cv,fano_factor,synchrony,regime,stop_time,stop_reason,predicted_rate,predicted_stability\n";
+	for(const auto& result : results) {
+		const MeanFieldSolution prediction(predict(result.point, size));
+		char line[320];
+		std::snprintf(line, sizeof(line), "%.4f,%.4f,%.1f,%u,%.4f,%.4f,%.4f,%.4f,%s,%.1f,%s,%.4f,%s\n", result.point.g, result.point.eta,
+					  result.point.time, result.point.noise_seed, result.statistics.rate, result.statistics.cv,
+					  result.statistics.fano_factor, result.statistics.synchrony,
+					  result.status==0 ? result.statistics.regime.c_str() : "failed", result.stop_time,
+					  stopReasonName(result.stop_reason).c_str(), prediction.rate, stabilityName(prediction.stability).c_str());
+		table<<line;
+	}
+
+	table.close();
+	if(table.fail()) {
+		throw std::runtime_error("Cannot write the file "+filename);
+	}
+}
+
+
+//!Method that writes the rates predicted by the mean field for the points, without simulating them
+void Sweep::writePredictions(const std::string& filename, const std::vector<SweepPoint>& points, const NetworkSize& size) {
+
+	std::ofstream table(filename);
+	if(table.fail()) {
+		throw std::runtime_error("Cannot create the file "+filename);
+	}
+
+	table<<"g,eta,rate,mu,sigma,slope,stability\n";
+	for(const auto& point : points) {
+		for(const auto& solution : MeanField(point.g, point.eta, size.connections_excitatory, size.connections_inhibitory).solve()) {
+			char line[256];
+			std::snprintf(line, sizeof(line), "%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%s\n", point.g, point.eta, solution.rate, solution.mu,
+						  solution.sigma, solution.slope, stabilityName(solution.stability).c_str());
+			table<<line;
+		}
+	}
+
+	table.close();
+	if(table.fail()) {
+		throw std::runtime_error("Cannot write the file "+filename);
+	}
+}
@@ -0,0 +1,160 @@
+//! Sweep class
+/*!To compute the phase diagram of the network (Fig.2) : the statistics of the network for many values of g and eta
+ *
+ * The points are the trials of an Ensemble : the connections are created once and shared by the processes,
+ * and the points are given to the processes as they become free. Each process computes the statistics of its point
+ * with a StatisticsRecorder and writes them in a shared memory, from which the summary table is made.
+ */
+#ifndef SWEEP_H
+#define SWEEP_H
+#include "constants.hpp"
+#include "network.hpp"
+#include "statisticsRecorder.hpp"
+#include "stopMonitor.hpp"
+#include "meanField.hpp"
+#include <string>
+#include <vector>
+
+
+
+//!Parameters of a point of a sweep
+struct SweepPoint {
+
+	double g;	//!Value of g=JI/JE
+	double eta;	//!Value of eta=Nu_ext/Nu_thr
+	double time;	//!Simulation time in ms
+	unsigned int noise_seed;	//!Seed of the background noise
+
+};
+
+
+//!Result of a point of a sweep
+struct SweepResult {
+
+	SweepPoint point;	//!Parameters of the point
+	int status;	//!Exit status of the process of the point (0 if it succeeded)
+	NetworkStatistics statistics;	//!Statistics of the network (meaningful only if status is 0)
+	double stop_time;	//!Time in ms at which the point stopped
+	StopReason stop_reason;	//!Reason why the point stopped before its simulation time (StopReason::None if it did not)
+
+};
+
+
+
+class Sweep {
+
+	public :
+
+	//!Constructor
+	/*!
+	 *\param seed_ the seed of the connections of the network, shared by all the points (0 to draw one)
+	 *\param nbr_excitatory_ the number of excitatory neurons of the network
+	 *\param nbr_inhibitory_ the number of inhibitory neurons of the network
+	 *\param processes_ the number of points computed at the same time (0 for the number of cores)
+	 *\param transient_ the time in ms skipped at the beginning of each point before computing the statistics
+	 *\param bin_width_ the width of the bins of the Fano factor and of the synchrony index in ms
+	*/
+	Sweep(unsigned int seed_=0, unsigned int long nbr_excitatory_=NE, unsigned int long nbr_inhibitory_=NI,
+		  unsigned int processes_=0, double transient_=0.0, double bin_width_=1.0);
+
+
+	//!Method that adds a point to the sweep
+	/*!
+	 *\param point the parameters of the point (g, eta and time strictly positive)
+	*/
+	void addPoint(const SweepPoint& point);
+
+
+	//!Setter for the size of the network
+	/*!
+	 * replaces the numbers of neurons given to the constructor, and the numbers of connections CE and CI
+	 * throws std::invalid_argument if the size is not valid (see checkNetworkSize)
+	 *\param size_ the numbers of neurons and of connections of the network
+	*/
+	void setNetworkSize(const NetworkSize& size_);
+
+
+	//!Getter for the size of the network
+	/*!
+	 *\return the numbers of neurons and of connections of the network
+	*/
+	const NetworkSize& getNetworkSize() const;
+
+
+	//!Method that adds a grid of points to the sweep
+	/*!
+	 * the points are added eta by eta, g varying first
+	 *\param g_min the smallest value of g
+	 *\param g_max the largest value of g
+	 *\param g_points the number of values of g (g_min only if 1)
+	 *\param eta_min the smallest value of eta
+	 *\param eta_max the largest value of eta
+	 *\param eta_points the number of values of eta (eta_min only if 1)
+	 *\param time the simulation time of each point in ms
+	 *\param noise_seed the seed of the background noise of each point
+	*/
+	void addGrid(double g_min, double g_max, unsigned int g_points, double eta_min, double eta_max, unsigned int eta_points,
+				 double time, unsigned int noise_seed);
+
+
+	//!Method that makes the points stop before their simulation time when a stop condition is met
+	/*!
+	 * the statistics of a point that stopped are computed over the steps done
+	 *\param conditions the stop conditions (see StopMonitor)
+	*/
+	void setStopConditions(const StopConditions& conditions);
+
+
+	//!Getter for the points of the sweep
+	/*!
+	 *\return the points in the order in which they were added
+	*/
+	const std::vector<SweepPoint>& getPoints() const;
+
+
+	//!Method that computes the statistics of all the points
+	/*!
+	 *\return the result of each point, in the order of the points
+	*/
+	std::vector<SweepResult> run();
+
+
+	//!Method that writes the summary table of a sweep
+	/*!
+	 * one line "g,eta,time,noise_seed,rate,cv,fano_factor,synchrony,regime,stop_time,stop_reason,predicted_rate,predicted_stability"
+	 * per point, the failed points having the regime "failed", the predicted rate being the lowest stable rate of the mean field
+	 * (the lowest rate if none is stable)
+	 *\param filename the name of the csv file
+	 *\param results the results of the sweep
+	 *\param size the size of the network, whose numbers of connections are those of the mean field
+	*/
+	static void writeTable(const std::string& filename, const std::vector<SweepResult>& results,
+						   const NetworkSize& size=defaultNetworkSize());
+
+
+	//!Method that writes the rates predicted by the mean field for the points, without simulating them
+	/*!
+	 * one line "g,eta,rate,mu,sigma,slope,stability" per stationary rate of each point (see MeanField)
+	 *\param filename the name of the csv file
+	 *\param points the points
+	 *\param size the size of the network, whose numbers of connections are those of the mean field
+	*/
+	static void writePredictions(const std::string& filename, const std::vector<SweepPoint>& points,
+								 const NetworkSize& size=defaultNetworkSize());
+
+
+
+	private :
+
+	unsigned int seed;	//!Seed of the connections
+	NetworkSize size;	//!Numbers of neurons and of connections of the network
+	unsigned int processes;	//!Number of points computed at the same time
+	double transient;	//!Time skipped at the beginning of each point in ms
+	double bin_width;	//!Width of the bins of the statistics in ms
+	bool early_stop;	//!True if the points stop when a stop condition is met
+	StopConditions stop_conditions;	//!Stop conditions of the points
+	std::vector<SweepPoint> points;	//!Points of the sweep
+
+};
+
+#endif